@@ -0,0 +1,96 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Compares ways to map incoming action strings to action codes:
+   comparing against every action name in turn (as done with the former
+   const std::string constants), a std::map and the perfect hash tables
+   generated by ENUM_STR in game_msg.hpp and server_request.hpp.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <cyvws/game_msg.hpp>
+#include <cyvws/server_request.hpp>
+
+using namespace std;
+using namespace cyvws;
+
+template <class Func>
+void run(const string& name, const vector<string>& input, Func&& func)
+{
+	constexpr unsigned rounds = 200000;
+
+	unsigned sum = 0;
+	auto begin = chrono::steady_clock::now();
+
+	for (unsigned i = 0; i < rounds; i++)
+		for (const auto& str : input)
+			sum += func(str);
+
+	auto end = chrono::steady_clock::now();
+	auto ns = chrono::duration<double, nano>(end - begin).count() / (rounds * input.size());
+
+	cout << name << ": " << ns << " ns per lookup (checksum " << sum << ")\n";
+}
+
+int main()
+{
+	vector<string> input;
+	for (auto&& it : GameMsgActionCodeStrPairs)
+		input.emplace_back(it.second);
+	for (auto&& it : ServerRequestActionCodeStrPairs)
+		input.emplace_back(it.second);
+
+	input.emplace_back("unknownAction");
+
+	const vector<string> gameMsgActionStrs(input.begin(), input.begin() + GameMsgActionCodeStrTable.size());
+	const vector<string> serverRequestActionStrs(input.begin() + GameMsgActionCodeStrTable.size(), input.end() - 1);
+
+	run("linear comparison", input, [&](const string& str) {
+		for (unsigned i = 0; i < gameMsgActionStrs.size(); i++)
+			if (str == gameMsgActionStrs[i])
+				return i + 1;
+
+		for (unsigned i = 0; i < serverRequestActionStrs.size(); i++)
+			if (str == serverRequestActionStrs[i])
+				return i + 1;
+
+		return 0u;
+	});
+
+	map<string, unsigned> actionMap;
+	for (auto&& it : GameMsgActionCodeStrPairs)
+		actionMap.emplace(it.second, static_cast<unsigned>(it.first) + 1);
+	for (auto&& it : ServerRequestActionCodeStrPairs)
+		actionMap.emplace(it.second, static_cast<unsigned>(it.first) + 1);
+
+	run("std::map", input, [&](const string& str) {
+		auto it = actionMap.find(str);
+		return it == actionMap.end() ? 0u : it->second;
+	});
+
+	run("perfect hash", input, [](const string& str) {
+		if (auto code = findGameMsgAction(str))
+			return static_cast<unsigned>(*code) + 1;
+		if (auto code = findServerRequestAction(str))
+			return static_cast<unsigned>(*code) + 1;
+
+		return 0u;
+	});
+}
@@ -0,0 +1,130 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Counts the heap allocations of relaying a move: parsing the incoming
+   gameMsg, writing it for the opponent and acknowledging it to the sender.
+   Once through Json::Value, once with the in-situ parser, GameMsgWriter
+   and the arena builders, which should need no allocations at all after
+   the first few rounds.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <json/reader.h>
+#include <json/writer.h>
+#include <cyvws/arena_msg.hpp>
+#include <cyvws/common.hpp>
+#include <cyvws/game_msg_parser.hpp>
+#include <cyvws/game_msg_writer.hpp>
+#include <cyvws/json_game_msg.hpp>
+#include <cyvws/msg.hpp>
+
+using namespace cyvasse;
+
+using namespace std;
+using namespace cyvasse;
+using namespace cyvws;
+
+static atomic<size_t> allocCount {0};
+
+void* operator new(size_t size)
+{
+	allocCount.fetch_add(1, memory_order_relaxed);
+
+	if (void* ptr = malloc(size ? size : 1))
+		return ptr;
+
+	throw bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{ free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept
+{ free(ptr); }
+
+static const string incomingMsg =
+	R"({"msgData":{"action":"move","param":{"newPos":"A11","oldPos":"B10","pieceType":"king"}},"msgID":6,"msgType":"gameMsg"})";
+
+template <class Func>
+void run(const string& name, Func&& func)
+{
+	constexpr unsigned warmupRounds = 100;
+	constexpr unsigned rounds = 100000;
+
+	size_t bytes = 0;
+	for (unsigned i = 0; i < warmupRounds; i++)
+		bytes += func();
+
+	auto allocsBefore = allocCount.load();
+	auto begin = chrono::steady_clock::now();
+
+	for (unsigned i = 0; i < rounds; i++)
+		bytes += func();
+
+	auto end = chrono::steady_clock::now();
+	auto allocs = allocCount.load() - allocsBefore;
+
+	cout << name << ": " << double(allocs) / rounds << " allocations, "
+	     << chrono::duration<double, nano>(end - begin).count() / rounds << " ns per relay"
+	     << " (checksum " << bytes << ")\n";
+}
+
+int main()
+{
+	Json::CharReaderBuilder readerBuilder;
+	Json::StreamWriterBuilder writerBuilder;
+	writerBuilder["indentation"] = "";
+
+	run("Json::Value", [&] {
+		Json::Value msg;
+		string errs;
+		istringstream stream(incomingMsg);
+		Json::parseFromStream(readerBuilder, stream, &msg, &errs);
+
+		auto movement = json::movement(msg[MSG_DATA][PARAM]);
+		auto relayed = Json::writeString(writerBuilder,
+			json::gameMsgMove(movement.pieceType, movement.oldPos, movement.newPos));
+		auto ack = Json::writeString(writerBuilder, json::gameMsgAck(msg[MSG_ID].asUInt()));
+
+		return relayed.size() + ack.size();
+	});
+
+	GameMsgWriter writer;
+	MsgArena arena;
+
+	run("in-situ parser, GameMsgWriter, MsgArena", [&] {
+		GameMsgView view;
+		PieceMovement movement {PieceType::KING, HexCoordinate<6>(5, 5), HexCoordinate<6>(5, 5)};
+
+		if (parser::parseGameMsg(incomingMsg, view) != GameMsgParseError::NONE
+			|| parser::parseMovement(view.param, movement) != GameMsgParseError::NONE)
+			abort();
+
+		auto& relayed = writer.move(movement.pieceType, movement.oldPos, movement.newPos);
+		auto ack = arena::gameMsgAck(arena, static_cast<unsigned>(*view.msgID));
+		auto size = relayed.size() + ack.size();
+
+		// after the frames were sent
+		arena.reset();
+		return size;
+	});
+}
@@ -0,0 +1,187 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Compression ratio and time per message of MsgDeflater, for every file in
+   ws-msg-examples (the directory is given as the only argument). The whole
+   corpus is compressed in file order over one connection, so with context
+   takeover each message sees the previous ones like on a real connection. Ratios
+   are compressed / original size, the time includes decompressing.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <json/reader.h>
+#include <json/writer.h>
+#include <cyvws/msg_compression.hpp>
+
+using namespace std;
+using namespace cyvws;
+
+struct Sample
+{
+	string name;
+	string msg;
+};
+
+static void readSamples(const string& dir, const string& prefix, vector<Sample>& samples)
+{
+	DIR* dirp = opendir(dir.c_str());
+	if (!dirp)
+	{
+		cerr << "Can't open " << dir << endl;
+		exit(1);
+	}
+
+	vector<string> entries;
+	while (dirent* entry = readdir(dirp))
+	{
+		string name = entry->d_name;
+		if (name[0] != '.')
+			entries.push_back(name);
+	}
+
+	closedir(dirp);
+	sort(entries.begin(), entries.end());
+
+	Json::CharReaderBuilder readerBuilder;
+	Json::StreamWriterBuilder writerBuilder;
+	writerBuilder["indentation"] = "";
+
+	for (auto& name : entries)
+	{
+		if (name.size() > 5 && name.compare(name.size() - 5, 5, ".json") == 0)
+		{
+			ifstream file(dir + "/" + name);
+			Json::Value msg;
+			string errs;
+
+			if (!Json::parseFromStream(readerBuilder, file, &msg, &errs))
+			{
+				cerr << dir << "/" << name << ": " << errs << endl;
+				exit(1);
+			}
+
+			samples.push_back({prefix + name.substr(0, name.size() - 5), Json::writeString(writerBuilder, msg)});
+		}
+		else
+			readSamples(dir + "/" + name, prefix + name + "/", samples);
+	}
+}
+
+struct Result
+{
+	size_t original = 0;
+	size_t compressed = 0;
+	double micros = 0;
+};
+
+static map<string, Result> run(const vector<Sample>& samples, const string& dictionary, bool contextTakeover)
+{
+	constexpr unsigned rounds = 2000;
+
+	map<string, Result> results;
+
+	for (unsigned i = 0; i < rounds; i++)
+	{
+		// a new connection per round, the messages of the previous round
+		// would otherwise still be in the window
+		MsgDeflater deflater(dictionary, contextTakeover);
+		MsgInflater inflater(dictionary, contextTakeover);
+
+		for (auto& sample : samples)
+		{
+			auto begin = chrono::steady_clock::now();
+
+			auto compressed = deflater.compress(sample.msg);
+			auto compressedSize = compressed.size();
+			auto decompressed = inflater.decompress(compressed);
+
+			auto end = chrono::steady_clock::now();
+
+			if (!decompressed || *decompressed != sample.msg)
+			{
+				cerr << sample.name << ": round trip failed" << endl;
+				exit(1);
+			}
+
+			auto& result = results[sample.name];
+			result.original   += sample.msg.size();
+			result.compressed += compressedSize;
+			result.micros     += chrono::duration<double, micro>(end - begin).count();
+		}
+	}
+
+	for (auto& it : results)
+		it.second.micros /= rounds;
+
+	return results;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc != 2)
+	{
+		cerr << "Usage: " << argv[0] << " <ws-msg-examples directory>" << endl;
+		return 1;
+	}
+
+	vector<Sample> samples;
+	readSamples(argv[1], "", samples);
+
+	auto plain   = run(samples, "", true);
+	auto dict    = run(samples, defaultDictionary(), false);
+	auto dictCtx = run(samples, defaultDictionary(), true);
+
+	printf("dictionary: %zu bytes, id %08x\n\n", defaultDictionary().size(),
+		static_cast<unsigned>(getDictionaryID(defaultDictionary())));
+	printf("%-36s %6s   %-18s %-16s %-16s\n", "", "size", "deflate + context", "dict", "dict + context");
+
+	auto print = [](const Result& r) {
+		printf("%5.2f %6.2f µs   ", double(r.compressed) / r.original, r.micros);
+	};
+
+	Result plainTotal, dictTotal, dictCtxTotal;
+	for (auto& sample : samples)
+	{
+		printf("%-36s %6zu   ", sample.name.c_str(), sample.msg.size());
+		print(plain[sample.name]);
+		print(dict[sample.name]);
+		print(dictCtx[sample.name]);
+		printf("\n");
+
+		for (auto& it : {make_pair(&plainTotal, &plain), make_pair(&dictTotal, &dict), make_pair(&dictCtxTotal, &dictCtx)})
+		{
+			auto& r = (*it.second)[sample.name];
+			it.first->original   += r.original;
+			it.first->compressed += r.compressed;
+			it.first->micros     += r.micros / samples.size();
+		}
+	}
+
+	printf("\n%-36s %6s   ", "all (ratio, mean time)", "");
+	print(plainTotal);
+	print(dictTotal);
+	print(dictCtxTotal);
+	printf("\n");
+}
@@ -0,0 +1,406 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "protocol_replay.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <json/reader.h>
+#include <json/writer.h>
+#include <cyvws/chat_msg.hpp>
+#include <cyvws/common.hpp>
+#include <cyvws/game_msg.hpp>
+#include <cyvws/init_comm.hpp>
+#include <cyvws/json_game_msg.hpp>
+#include <cyvws/json_notification.hpp>
+#include <cyvws/json_server_reply.hpp>
+#include <cyvws/msg.hpp>
+#include <cyvws/msg_validator.hpp>
+#include <cyvws/notification.hpp>
+#include <cyvws/server_reply.hpp>
+#include <cyvws/server_request.hpp>
+
+using namespace std;
+using namespace cyvasse;
+using namespace cyvws;
+
+// not (yet) in the cyvws headers
+static constexpr char
+	EXTRA_RULES[]   = "extraRules",
+	SESSION_TOKEN[] = "sessionToken",
+	USER_INFO[]     = "userInfo",
+	USER_NAME[]     = "userName";
+
+static void loadCorpus(const string& path, const string& name, vector<CorpusFile>& files)
+{
+	struct stat st;
+	if (stat(path.c_str(), &st) != 0)
+	{
+		cerr << "Can't read " << path << endl;
+		exit(1);
+	}
+
+	if (!S_ISDIR(st.st_mode))
+	{
+		ifstream file(path, ios::binary);
+		files.push_back({name, string(istreambuf_iterator<char>(file), istreambuf_iterator<char>())});
+		return;
+	}
+
+	DIR* dirp = opendir(path.c_str());
+	if (!dirp)
+	{
+		cerr << "Can't open " << path << endl;
+		exit(1);
+	}
+
+	while (dirent* entry = readdir(dirp))
+	{
+		string entryName = entry->d_name;
+		if (entryName[0] != '.')
+			loadCorpus(path + "/" + entryName, name.empty() ? entryName : name + "/" + entryName, files);
+	}
+
+	closedir(dirp);
+}
+
+vector<CorpusFile> loadCorpus(const string& path)
+{
+	vector<CorpusFile> files;
+	loadCorpus(path, "", files);
+
+	// a single file
+	if (files.size() == 1 && files[0].name.empty())
+		files[0].name = path;
+
+	sort(files.begin(), files.end(), [](const CorpusFile& a, const CorpusFile& b) {
+		return a.name < b.name;
+	});
+
+	return files;
+}
+
+// returns the notificationData of the re-encoded notification
+static Json::Value replayNotification(const Json::Value& data, string& type)
+{
+	type = data[TYPE].asString();
+
+	if (type == NotificationType::BATCH)
+	{
+		vector<Json::Value> notifications;
+		string innerType;
+
+		for (auto&& notification : data[NOTIFICATIONS])
+			notifications.push_back(replayNotification(notification, innerType));
+
+		return json::notificationBatch(notifications)[NOTIFICATION_DATA];
+	}
+
+	if (type == NotificationType::COMM_ERROR)
+		return json::commErr(data[ERR_MSG].asString())[NOTIFICATION_DATA];
+
+	if (type == NotificationType::LIST_UPDATE)
+	{
+		auto listName = data[LIST_NAME].asString();
+		auto content  = json::gamesListContent(data[LIST_CONTENT]);
+
+		return (data.isMember(LIST_VERSION)
+			? json::listUpdate(listName, content, data[LIST_VERSION].asUInt())
+			: json::listUpdate(listName, content))[NOTIFICATION_DATA];
+	}
+
+	if (type == NotificationType::LIST_DELTA)
+	{
+		vector<string> removed;
+		for (auto&& matchID : data[REMOVED])
+			removed.push_back(matchID.asString());
+
+		return json::listDelta(data[LIST_NAME].asString(), data[BASE_VERSION].asUInt(),
+			data[LIST_VERSION].asUInt(), json::gamesListContent(data[ADDED]),
+			json::gamesListContent(data[MODIFIED]), removed)[NOTIFICATION_DATA];
+	}
+
+	if (type == NotificationType::USER_JOINED)
+		return json::userJoined(data[USERNAME].asString(), data[REGISTERED].asBool(),
+			data[ROLE].asString())[NOTIFICATION_DATA];
+
+	if (type == NotificationType::USER_LEFT)
+		return json::userLeft(data[USERNAME].asString())[NOTIFICATION_DATA];
+
+	if (type == NotificationType::USERNAME_UPDATE)
+		return json::usernameUpdate(data[OLD_USERNAME].asString(),
+			data[NEW_USERNAME].asString())[NOTIFICATION_DATA];
+
+	throw invalid_argument("unknown notification type");
+}
+
+ProtocolReplayer::ProtocolReplayer()
+{
+	Json::CharReaderBuilder readerBuilder;
+	m_reader.reset(readerBuilder.newCharReader());
+
+	Json::StreamWriterBuilder writerBuilder;
+	writerBuilder["indentation"] = "";
+	m_writer.reset(writerBuilder.newStreamWriter());
+}
+
+ProtocolReplayer::~ProtocolReplayer() = default;
+
+void ProtocolReplayer::setKind(const string& msgType, const string& variant)
+{
+	m_kind.assign(msgType);
+
+	if (!variant.empty())
+		m_kind.append("/").append(variant);
+}
+
+Json::Value ProtocolReplayer::replayInbound(const string& msgType, const Json::Value& msg)
+{
+	Json::Value out;
+
+	if (msgType == MsgType::CHAT_MSG)
+	{
+		const auto& data = msg[MSG_DATA];
+		setKind(msgType);
+
+		out[MSG_TYPE] = MsgType::CHAT_MSG;
+		out[MSG_DATA][CONTENT] = data[CONTENT].asString();
+
+		// only set in messages from the server
+		if (data[USER].isString())
+			out[MSG_DATA][USER] = data[USER].asString();
+	}
+	else if (msgType == MsgType::GAME_MSG)
+	{
+		const auto& param = msg[MSG_DATA][PARAM];
+		auto action = msg[MSG_DATA][ACTION].asString();
+		setKind(msgType, action);
+
+		switch (StrToGameMsgActionCode(action))
+		{
+			case GameMsgActionCode::END_TURN:
+			case GameMsgActionCode::RESIGN:
+				out = json::gameMsg(action, Json::Value());
+				break;
+			case GameMsgActionCode::MOVE:
+			{
+				auto movement = json::movement(param);
+				out = json::gameMsgMove(movement.pieceType, movement.oldPos, movement.newPos);
+				break;
+			}
+			case GameMsgActionCode::MOVE_CAPTURE:
+			{
+				auto capture = json::moveCapture(param);
+				out = json::gameMsgMoveCapture(capture.atkPT, capture.oldPos, capture.newPos,
+					capture.defPT, capture.defPiecePos);
+				break;
+			}
+			case GameMsgActionCode::PROMOTE:
+			{
+				auto promotion = json::promotion(param);
+				out = json::gameMsgPromote(promotion.origType, promotion.newType);
+				break;
+			}
+			case GameMsgActionCode::SET_IS_READY:
+				out = json::gameMsgSetIsReady();
+				break;
+			case GameMsgActionCode::SET_OPENING_ARRAY:
+				out = json::gameMsgSetOpeningArray(json::pieceMap(param));
+				break;
+		}
+	}
+	else // serverRequest
+	{
+		const auto& param = msg[REQUEST_DATA][PARAM];
+		auto action = msg[REQUEST_DATA][ACTION].asString();
+		setKind(msgType, action);
+
+		Json::Value outParam;
+
+		switch (StrToServerRequestActionCode(action))
+		{
+			case ServerRequestActionCode::CREATE_GAME:
+			{
+				outParam[RULE_SET] = param[RULE_SET].asString();
+				outParam[COLOR]    = string(PlayersColorToStr(StrToPlayersColor(param[COLOR].asString())));
+				outParam[RANDOM]   = param[RANDOM].asBool();
+				outParam[PUBLIC]   = param[PUBLIC].asBool();
+
+				auto& extraRules = outParam[EXTRA_RULES] = Json::Value(Json::arrayValue);
+				for (auto&& rule : param[EXTRA_RULES])
+					extraRules.append(rule.asString());
+
+				const auto& userInfo = param[USER_INFO];
+				if (userInfo.isObject())
+				{
+					outParam[USER_INFO][USER_NAME]     = userInfo[USER_NAME].asString();
+					outParam[USER_INFO][SESSION_TOKEN] = userInfo[SESSION_TOKEN].asString();
+				}
+				break;
+			}
+			case ServerRequestActionCode::INIT_COMM:
+				outParam[PROTOCOL_VERSION] = param[PROTOCOL_VERSION].asString();
+				break;
+			case ServerRequestActionCode::JOIN_GAME:
+				outParam[MATCH_ID] = param[MATCH_ID].asString();
+				break;
+			case ServerRequestActionCode::SET_USERNAME:
+				outParam = param.asString();
+				break;
+			case ServerRequestActionCode::SUBSCR_GAME_LIST_UPDATES:
+			case ServerRequestActionCode::UNSUBSCR_GAME_LIST_UPDATES:
+			{
+				outParam[RULE_SET] = param[RULE_SET].asString();
+
+				auto& lists = outParam[LISTS] = Json::Value(Json::arrayValue);
+				for (auto&& list : param[LISTS])
+					lists.append(list.asString());
+				break;
+			}
+		}
+
+		out[MSG_TYPE] = MsgType::SERVER_REQUEST;
+		out[REQUEST_DATA][ACTION] = action;
+		out[REQUEST_DATA][PARAM]  = outParam;
+	}
+
+	out[MSG_ID] = msg[MSG_ID].asUInt();
+	return out;
+}
+
+Json::Value ProtocolReplayer::replayOutbound(const string& msgType, const Json::Value& msg)
+{
+	Json::Value out;
+
+	if (msgType == MsgType::CHAT_MSG_ACK)
+	{
+		setKind(msgType);
+
+		out[MSG_TYPE] = MsgType::CHAT_MSG_ACK;
+		out[MSG_ID]   = msg[MSG_ID].asUInt();
+	}
+	else if (msgType == MsgType::GAME_MSG_ACK)
+	{
+		setKind(msgType);
+		out = json::gameMsgAck(msg[MSG_ID].asUInt());
+	}
+	else if (msgType == MsgType::GAME_MSG_ERR)
+	{
+		setKind(msgType);
+		out = json::gameMsgErr(msg[MSG_ID].asUInt(), msg[MSG_ERROR].asString());
+	}
+	else if (msgType == MsgType::NOTIFICATION)
+	{
+		string type;
+		out = json::notification(replayNotification(msg[NOTIFICATION_DATA], type));
+		setKind(msgType, type);
+	}
+	else if (msgType == MsgType::SERVER_REPLY)
+	{
+		const auto& replyData = msg[REPLY_DATA];
+		auto msgID = msg[MSG_ID].asUInt();
+
+		if (!replyData[SUCCESS].asBool())
+		{
+			setKind(msgType, MSG_ERROR);
+			out = json::requestErr(msgID, replyData[ERR_MSG].asString(), replyData[ERR_DETAILS].asString());
+		}
+		else if (replyData.isMember(GAME_STATUS))
+		{
+			setKind(msgType, ServerRequestAction::JOIN_GAME);
+
+			// only the game status has typed decoders, the rest is copied
+			const auto& gameStatus = replyData[GAME_STATUS];
+			auto outReplyData = replyData;
+
+			auto& outGameStatus = outReplyData[GAME_STATUS] = Json::Value(Json::objectValue);
+			outGameStatus[SETUP] = gameStatus[SETUP].asBool();
+
+			if (gameStatus.isMember(PIECE_POSITIONS))
+			{
+				const auto& positions = gameStatus[PIECE_POSITIONS];
+				auto& outPositions = outGameStatus[PIECE_POSITIONS] = Json::Value(Json::objectValue);
+
+				for (auto&& color : positions.getMemberNames())
+					outPositions[string(PlayersColorToStr(StrToPlayersColor(color)))] =
+						json::pieceMap(json::pieceMap(positions[color]));
+			}
+
+			out = json::serverReply(msgID, outReplyData);
+		}
+		else if (replyData.isMember(MATCH_ID))
+		{
+			setKind(msgType, ServerRequestAction::CREATE_GAME);
+			out = json::createGameSuccess(msgID, replyData[MATCH_ID].asString(), replyData[PLAYER_ID].asString());
+		}
+		else
+		{
+			setKind(msgType, SUCCESS);
+			out = json::requestSuccess(msgID);
+		}
+	}
+
+	return out;
+}
+
+bool ProtocolReplayer::replay(string_view msg)
+{
+	Json::Value val;
+	if (!m_reader->parse(msg.data(), msg.data() + msg.size(), &val, nullptr) || !val.isObject())
+		return false;
+
+	const auto& constVal = val;
+	const auto& msgTypeVal = constVal[MSG_TYPE];
+	if (!msgTypeVal.isString())
+		return false;
+
+	auto msgType = msgTypeVal.asString();
+	Json::Value out;
+
+	if (msgType == MsgType::CHAT_MSG || msgType == MsgType::GAME_MSG || msgType == MsgType::SERVER_REQUEST)
+	{
+		if (!MsgValidator::inbound().validate(constVal))
+			return false;
+
+		out = replayInbound(msgType, constVal);
+	}
+	else
+	{
+		try
+		{
+			out = replayOutbound(msgType, constVal);
+		}
+		catch (exception&)
+		{
+			return false;
+		}
+	}
+
+	if (out.isNull())
+		return false;
+
+	m_stream.str(string());
+	m_writer->write(out, &m_stream);
+	m_output = m_stream.str();
+
+	return true;
+}
@@ -0,0 +1,88 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _PROTOCOL_REPLAY_HPP_
+#define _PROTOCOL_REPLAY_HPP_
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <string_view.hpp>
+
+/* Shared by benchmarks/protocol_throughput and fuzz/protocol_fuzzer, so
+   both exercise exactly the same code with the same corpus
+   (ws-msg-examples).
+ */
+
+namespace Json
+{
+	class CharReader;
+	class StreamWriter;
+	class Value;
+}
+
+struct CorpusFile
+{
+	std::string name; // relative to the loaded directory
+	std::string data;
+};
+
+/// All files below path (or path itself if it is a file), sorted by name;
+/// exits with an error message if path can't be read
+std::vector<CorpusFile> loadCorpus(const std::string& path);
+
+/** Replays one message through parse -> typed decode -> re-encode
+
+	The message is parsed with jsoncpp, decoded into the typed structures
+	of libcyvws (PieceMovement, PieceMap, GamesListMap, ...) and encoded
+	again with the json:: builders. Client messages are checked with
+	MsgValidator::inbound() first, which promises that the decoders don't
+	throw for them, so exceptions are only caught for the other messages.
+	Replaying the output again gives the same output.
+ */
+class ProtocolReplayer
+{
+	private:
+		std::unique_ptr<Json::CharReader> m_reader;
+		std::unique_ptr<Json::StreamWriter> m_writer;
+		std::ostringstream m_stream;
+
+		std::string m_kind;
+		std::string m_output;
+
+		Json::Value replayInbound(const std::string& msgType, const Json::Value& msg);
+		Json::Value replayOutbound(const std::string& msgType, const Json::Value& msg);
+
+		void setKind(const std::string& msgType, const std::string& variant = {});
+
+	public:
+		ProtocolReplayer();
+		~ProtocolReplayer();
+
+		/// false if msg isn't valid JSON or no valid message
+		bool replay(string_view msg);
+
+		/// "gameMsg/move", "notification/userLeft", ... of the last replayed message
+		const std::string& getKind() const
+		{ return m_kind; }
+
+		/// The re-encoded message (compact JSON)
+		const std::string& getOutput() const
+		{ return m_output; }
+};
+
+#endif // _PROTOCOL_REPLAY_HPP_
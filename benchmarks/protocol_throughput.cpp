@@ -0,0 +1,167 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Replays every file of ws-msg-examples through ProtocolReplayer (parse ->
+   typed decode -> re-encode) on several threads, each file many times in a
+   row. Reports ns and heap allocations per message for every message kind
+   and the overall throughput of all threads together.
+
+   Usage: protocol_throughput <ws-msg-examples directory> [threads] [rounds]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "protocol_replay.hpp"
+
+using namespace std;
+
+static thread_local size_t allocCount = 0;
+
+void* operator new(size_t size)
+{
+	allocCount++;
+
+	if (void* ptr = malloc(size ? size : 1))
+		return ptr;
+
+	throw bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{ free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept
+{ free(ptr); }
+
+struct Stats
+{
+	size_t msgs = 0;
+	size_t allocs = 0;
+	double ns = 0;
+};
+
+static void runThread(const vector<CorpusFile>& corpus, unsigned rounds, vector<Stats>& stats)
+{
+	ProtocolReplayer replayer;
+	stats.resize(corpus.size());
+
+	for (size_t i = 0; i < corpus.size(); i++)
+	{
+		const auto& data = corpus[i].data;
+
+		// warm up the buffers
+		replayer.replay(data);
+
+		auto allocsBefore = allocCount;
+		auto begin = chrono::steady_clock::now();
+
+		for (unsigned round = 0; round < rounds; round++)
+		{
+			if (!replayer.replay(data))
+				abort();
+		}
+
+		auto end = chrono::steady_clock::now();
+
+		stats[i].msgs   = rounds;
+		stats[i].allocs = allocCount - allocsBefore;
+		stats[i].ns     = chrono::duration<double, nano>(end - begin).count();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2 || argc > 4)
+	{
+		cerr << "Usage: " << argv[0] << " <ws-msg-examples directory> [threads] [rounds]" << endl;
+		return 1;
+	}
+
+	auto corpus = loadCorpus(argv[1]);
+	unsigned threadCount = argc > 2 ? stoul(argv[2]) : max(thread::hardware_concurrency(), 1u);
+	unsigned rounds = argc > 3 ? stoul(argv[3]) : 20000;
+
+	// the kind of every file, and make sure they are all valid
+	vector<string> kinds;
+	{
+		ProtocolReplayer replayer;
+		for (auto&& file : corpus)
+		{
+			if (!replayer.replay(file.data))
+			{
+				cerr << file.name << ": not a valid message" << endl;
+				return 1;
+			}
+
+			kinds.push_back(replayer.getKind());
+		}
+	}
+
+	vector<vector<Stats>> threadStats(threadCount);
+	vector<thread> threads;
+
+	auto begin = chrono::steady_clock::now();
+
+	for (auto& stats : threadStats)
+		threads.emplace_back(runThread, cref(corpus), rounds, ref(stats));
+	for (auto& thread : threads)
+		thread.join();
+
+	auto end = chrono::steady_clock::now();
+
+	map<string, Stats> kindStats;
+	Stats total;
+
+	for (auto& stats : threadStats)
+	{
+		for (size_t i = 0; i < corpus.size(); i++)
+		{
+			auto& kind = kindStats[kinds[i]];
+			kind.msgs   += stats[i].msgs;
+			kind.allocs += stats[i].allocs;
+			kind.ns     += stats[i].ns;
+
+			total.msgs   += stats[i].msgs;
+			total.allocs += stats[i].allocs;
+			total.ns     += stats[i].ns;
+		}
+	}
+
+	printf("%-40s %14s %10s %12s\n", "", "msgs/s/thread", "ns/msg", "allocs/msg");
+
+	auto print = [](const string& name, const Stats& stats) {
+		printf("%-40s %14.0f %10.0f %12.1f\n", name.c_str(), stats.msgs / stats.ns * 1e9,
+			stats.ns / stats.msgs, double(stats.allocs) / stats.msgs);
+	};
+
+	for (auto& it : kindStats)
+		print(it.first, it.second);
+
+	printf("\n");
+	print("all", total);
+
+	auto seconds = chrono::duration<double>(end - begin).count();
+	printf("\n%zu messages on %u threads in %.2f s: %.0f msgs/s\n",
+		total.msgs, threadCount, seconds, total.msgs / seconds);
+}
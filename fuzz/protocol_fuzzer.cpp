@@ -0,0 +1,96 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* libFuzzer entry point for the protocol layer, using the same replay code
+   as benchmarks/protocol_throughput. Every input is
+
+    - replayed through ProtocolReplayer; if it is accepted, replaying the
+      output again has to give the same kind and output
+    - decoded as a binary message (binary_msg.hpp)
+
+   To fuzz, build everything with clang and libFuzzer:
+
+     ./configure CXX=clang++ CXXFLAGS="-g -O1 -fsanitize=fuzzer-no-link,address"
+     make fuzz FUZZ_CPPFLAGS=-DCYVWS_LIBFUZZER FUZZ_LDFLAGS=-fsanitize=fuzzer,address
+     mkdir -p fuzz-corpus
+     fuzz/protocol_fuzzer fuzz-corpus ws-msg-examples
+
+   Without CYVWS_LIBFUZZER, a main() is compiled in that runs the entry
+   point on the files and directories given as arguments, to reproduce
+   crashes and to check the corpus with any compiler.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <cyvws/binary_msg.hpp>
+#include "protocol_replay.hpp"
+
+using namespace std;
+using namespace cyvws;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	static ProtocolReplayer replayer;
+
+	string_view input(reinterpret_cast<const char*>(data), size);
+
+	if (replayer.replay(input))
+	{
+		auto kind = replayer.getKind();
+		auto output = replayer.getOutput();
+
+		if (!replayer.replay(output) || replayer.getKind() != kind || replayer.getOutput() != output)
+		{
+			cerr << "Re-encoded " << kind << " message doesn't round-trip:\n"
+			     << output << "\n" << replayer.getOutput() << endl;
+			abort();
+		}
+	}
+
+	BinaryMsg msg;
+	binary::decode(input, msg);
+
+	return 0;
+}
+
+#ifndef CYVWS_LIBFUZZER
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		cerr << "Usage: " << argv[0] << " <file or directory>..." << endl;
+		return 1;
+	}
+
+	size_t count = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		for (auto&& file : loadCorpus(argv[i]))
+		{
+			LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(file.data.data()), file.data.size());
+			count++;
+		}
+	}
+
+	cout << "Ran " << count << " inputs" << endl;
+}
+
+#endif // CYVWS_LIBFUZZER
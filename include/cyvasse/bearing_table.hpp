@@ -36,8 +36,11 @@ namespace cyvasse
 {
 	class BearingTable
 	{
+		public:
+			typedef std::vector<std::reference_wrapper<const Piece>> PieceVec;
+
 		private:
-			typedef std::map<std::reference_wrapper<const Piece>, std::vector<std::reference_wrapper<const Piece>>, addr_less<const Piece>>
+			typedef std::map<std::reference_wrapper<const Piece>, PieceVec, addr_less<const Piece>>
 				BearingMap;
 
 			CoordPieceMap& m_pieceMap;
@@ -56,6 +59,13 @@ namespace cyvasse
 			BearingTable(const BearingTable&) = delete;
 			BearingTable& operator=(const BearingTable&) = delete;
 
+			/** Get the tier atkPiece attacks with when flanked by reachingPieces
+
+				reachingPieces are all pieces of the attacker's color that can
+				reach the defending piece (including atkPiece itself).
+			*/
+			static auto getAttackTier(const Piece& atkPiece, const PieceVec& reachingPieces) -> uint8_t;
+
 			bool canTake(const Piece& attackingPiece, const Piece& defendingPiece) const;
 
 			void init();
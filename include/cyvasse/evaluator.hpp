@@ -0,0 +1,108 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVASSE_EVALUATOR_HPP_
+#define _CYVASSE_EVALUATOR_HPP_
+
+#include <array>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+#include <optional.hpp>
+
+#include "hexagon.hpp"
+#include "piece_type.hpp"
+#include "players_color.hpp"
+#include "terrain_type.hpp"
+
+namespace cyvasse
+{
+	class Match;
+
+	/** The weights of the terms of the position evaluation
+
+		Piece-square tables are given from the point of view of the white
+		player and indexed by Hexagon<6>::getIndex(); they are mirrored
+		through the center of the board for the black player.
+	*/
+	struct EvalWeights
+	{
+		typedef std::array<int, Hexagon<6>::tileCount> PieceSquareTable;
+
+		std::array<int, pieceTypeCount> material;
+		std::array<PieceSquareTable, pieceTypeCount> pieceSquare;
+
+		int homeTerrain;    // piece stands on its home terrain
+		int fortress;       // own fortress isn't ruined
+		int kingInFortress; // king stands in its fortress
+		int kingDistance;   // per tile between the king and its fortress
+
+		static EvalWeights defaults();
+
+		/** Read weights in the format written by write()
+
+			Each line has the form `<term> [piece type] = <values>`,
+			everything after a '#' is ignored. Terms that are not
+			mentioned keep their default value.
+		*/
+		static EvalWeights read(std::istream&);
+		static EvalWeights readFile(const std::string& path);
+
+		void write(std::ostream&) const;
+	};
+
+	/** Incrementally updated position evaluation
+
+		init() evaluates the position once, afterwards the score is only
+		updated through pieceAdded(), pieceRemoved(), pieceMoved() and
+		fortressRuined(). To undo a change, call the inverse function
+		with the same arguments (e.g. pieceMoved() with swapped coords).
+		A Match subclass would usually forward its addToBoard(),
+		removeFromBoard() and pieceMoved() hooks to these functions.
+	*/
+	class Evaluator
+	{
+		private:
+			std::shared_ptr<const EvalWeights> m_weights;
+
+			// score from the point of view of the white player
+			int m_score = 0;
+
+			std::array<optional<TerrainType>, Hexagon<6>::tileCount> m_terrain;
+			std::array<optional<HexCoordinate<6>>, 2> m_fortressCoords;
+
+			int getPieceScore(PieceType, PlayersColor, HexCoordinate<6>) const;
+
+		public:
+			explicit Evaluator(std::shared_ptr<const EvalWeights> weights)
+				: m_weights(std::move(weights))
+			{ }
+
+			/// Evaluate the position from scratch; terrain and fortresses must be set up
+			void init(Match&);
+
+			int getScore(PlayersColor color) const
+			{ return (color == PlayersColor::WHITE) ? m_score : -m_score; }
+
+			void pieceAdded(PieceType, PlayersColor, HexCoordinate<6>);
+			void pieceRemoved(PieceType, PlayersColor, HexCoordinate<6>);
+			void pieceMoved(PieceType, PlayersColor, HexCoordinate<6> from, HexCoordinate<6> to);
+			void fortressRuined(PlayersColor, bool ruined = true);
+	};
+}
+
+#endif // _CYVASSE_EVALUATOR_HPP_
@@ -0,0 +1,57 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVASSE_EXCHANGE_HPP_
+#define _CYVASSE_EXCHANGE_HPP_
+
+#include <cstdint>
+
+#include "hexcoordinate.hpp"
+#include "piece_type.hpp"
+
+namespace cyvasse
+{
+	class Match;
+	class Piece;
+
+	/** Get the material value of a piece type in exchanges
+
+		This is the base tier, except for the king which is
+		ranked above the dragon because taking it can decide the game.
+	*/
+	int getExchangeValue(PieceType);
+
+	/** Simulate the sequence of captures and recaptures on a tile
+
+		Both sides alternately capture the piece on target with their least
+		valuable piece that is allowed to take it (including the flanking
+		support of the other pieces of that side that can reach the tile),
+		and may stop as soon as continuing would lose material.
+
+		Returns the material balance (see getExchangeValue()) from the point
+		of view of the opponent of the piece on target, or 0 if the tile is
+		empty or there is no possible capture. Like any static exchange
+		evaluation this doesn't account for pieces that are uncovered by
+		the exchange, and light / heavy horses and dragons are only
+		considered for capturing pieces of the opposite color.
+	*/
+	int staticExchangeEval(Match&, HexCoordinate<6> target);
+
+	/// Check whether the opponent wins material by starting an exchange on piece
+	bool isHanging(Match&, const Piece& piece);
+}
+
+#endif // _CYVASSE_EXCHANGE_HPP_
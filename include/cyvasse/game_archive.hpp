@@ -0,0 +1,115 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVASSE_GAME_ARCHIVE_HPP_
+#define _CYVASSE_GAME_ARCHIVE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <string_view.hpp>
+
+/* File of concatenated GameRecords with an offset index
+
+     magic     "CYVA"
+     version   1 byte (gameArchiveVersion)
+     records   back to back
+     index     per record its offset in the file
+     footer    offset of the index, record count, "CYVA"
+
+   All numbers in the index and footer are 8 byte little endian. The
+   index is written last, so records can be streamed into the file as
+   games end.
+
+   Only part of libcyvasse where sys/mman.h exists (HAVE_MMAP in
+   configure.ac).
+ */
+
+namespace cyvasse
+{
+	constexpr uint8_t gameArchiveVersion = 1;
+
+	class GameArchiveWriter
+	{
+		private:
+			std::ofstream m_file;
+			std::vector<uint64_t> m_offsets;
+			uint64_t m_pos = 0;
+			bool m_finished = false;
+
+		public:
+			/// Create (or truncate) the file at path; throws std::runtime_error on failure
+			explicit GameArchiveWriter(const std::string& path);
+
+			/// Calls finish() if that didn't happen yet, ignoring errors
+			~GameArchiveWriter();
+
+			// non-copyable
+			GameArchiveWriter(const GameArchiveWriter&) = delete;
+			GameArchiveWriter& operator=(const GameArchiveWriter&) = delete;
+
+			void add(string_view record);
+
+			/// Write the index and the footer and close the file
+			void finish();
+
+			std::size_t size() const
+			{ return m_offsets.size(); }
+	};
+
+	/** Read-only view of a game archive, mapped into memory with mmap
+
+		The index is validated when the archive is opened, the records
+		themselves are not (see GameRecordReader). Any number of threads
+		may read from the archive at the same time.
+	*/
+	class GameArchive
+	{
+		private:
+			const char* m_data = nullptr;
+			std::size_t m_byteSize = 0;
+
+			const char* m_index = nullptr;
+			uint64_t m_indexOffset = 0;
+			std::size_t m_size = 0;
+
+			uint64_t getOffset(std::size_t i) const;
+
+		public:
+			/// Map the file at path; throws std::runtime_error on failure or an invalid index
+			explicit GameArchive(const std::string& path);
+			~GameArchive();
+
+			// non-copyable
+			GameArchive(const GameArchive&) = delete;
+			GameArchive& operator=(const GameArchive&) = delete;
+
+			/// The number of records
+			std::size_t size() const
+			{ return m_size; }
+
+			std::size_t getByteSize() const
+			{ return m_byteSize; }
+
+			/// Record i, pointing into the mapped file
+			string_view getRecord(std::size_t i) const;
+	};
+}
+
+#endif // _CYVASSE_GAME_ARCHIVE_HPP_
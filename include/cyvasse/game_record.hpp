@@ -0,0 +1,210 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVASSE_GAME_RECORD_HPP_
+#define _CYVASSE_GAME_RECORD_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+#include <optional.hpp>
+#include <string_view.hpp>
+
+#include "hexcoordinate.hpp"
+#include "piece_type.hpp"
+#include "players_color.hpp"
+
+/* Compact binary record of a match, for archiving finished games
+
+   A record starts with a header:
+
+     magic       "CYVR"
+     version     1 byte (gameRecordVersion)
+     matchID     length byte, bytes
+     ruleSet     length byte, bytes
+     flags       1 byte, 0x01 random, 0x02 public
+     openings    per color (white first), per PieceType value:
+                 piece count, coordinates
+
+   followed by the events of the game, which are appended as they happen.
+   Coordinates are single bytes holding the Hexagon<6>::getIndex() of the
+   tile, all of which are below 0x80:
+
+     move        from, to
+     capture     from, to | 0x80, type of the captured piece
+     promotion   0x80 | new PieceType, coordinate
+     end         0xff, winner
+
+   Setup moves aren't recorded, the openings are the board at the end of
+   the setup. Moves alternate between the players, white starts.
+ */
+
+namespace cyvasse
+{
+	class Match;
+	class Piece;
+
+	constexpr uint8_t gameRecordVersion = 1;
+
+	class GameRecordError : public std::runtime_error
+	{
+		public:
+			explicit GameRecordError(const std::string& what)
+				: std::runtime_error("Invalid game record: " + what)
+			{ }
+	};
+
+	// type from json::pieceMap
+	typedef std::map<PieceType, std::set<HexCoordinate<6>>> OpeningArray;
+
+	struct GameRecordHeader
+	{
+		std::string matchID;
+		std::string ruleSet;
+		bool random = false;
+		bool _public = false;
+
+		std::array<OpeningArray, 2> openings;
+	};
+
+	enum class GameRecordEventKind : uint8_t
+	{
+		MOVE,
+		CAPTURE,
+		PROMOTION,
+		END
+	};
+
+	struct GameRecordEvent
+	{
+		GameRecordEventKind kind;
+
+		// move and capture: from and to, promotion: to
+		HexCoordinate<6> from;
+		HexCoordinate<6> to;
+
+		// capture: captured piece, promotion: new type
+		PieceType pieceType;
+
+		// end: the winner
+		PlayersColor winner;
+	};
+
+	/** Writes the GameRecord of a match while it is played
+
+		Like the Evaluator, the writer doesn't hook into the Match itself.
+		A Match subclass forwards its removeFromBoard(), pieceMoved(),
+		piecePromoted() and endGame() hooks to the functions with the same
+		names, and calls start() once the setup is done. Before start(),
+		all events are ignored.
+	 */
+	class GameRecordWriter
+	{
+		private:
+			const Match& m_match;
+			std::string m_record;
+
+			// set by removeFromBoard(), a promotion also removes a piece
+			optional<PieceType> m_capturedType;
+
+			bool m_started = false;
+			bool m_ended = false;
+
+			void byte(uint8_t);
+			void str(const std::string&);
+
+		public:
+			explicit GameRecordWriter(const Match&);
+
+			/// Write the header, with the current board as the openings
+			void start(const std::string& ruleSet);
+
+			void removeFromBoard(const Piece&);
+			void pieceMoved(const Piece&, optional<HexCoordinate<6>> oldCoord);
+			void piecePromoted(const Piece&, PieceType origType);
+			void endGame(PlayersColor winner);
+
+			bool isEnded() const
+			{ return m_ended; }
+
+			/// The record so far; it is only ever appended to
+			auto getRecord() const -> const std::string&
+			{ return m_record; }
+	};
+
+	/** Reads a GameRecord event by event
+
+		The record isn't copied, it has to outlive the reader. The
+		constructor parses the header, next() decodes one event at a
+		time. Both throw GameRecordError for malformed data. To replay
+		the game, construct a Match from the header, pass it to setUp()
+		and then every event to apply().
+	 */
+	class GameRecordReader
+	{
+		private:
+			string_view m_record;
+			std::size_t m_pos = 0;
+
+			GameRecordHeader m_header;
+			PlayersColor m_turn = PlayersColor::WHITE;
+			bool m_ended = false;
+
+			uint8_t byte();
+			std::string str();
+			HexCoordinate<6> coord();
+			HexCoordinate<6> coord(uint8_t index);
+			PieceType pieceType(uint8_t);
+
+		public:
+			explicit GameRecordReader(string_view record);
+
+			auto getHeader() const -> const GameRecordHeader&
+			{ return m_header; }
+
+			/// The number of bytes read so far, i.e. the record size after the end event
+			std::size_t getPos() const
+			{ return m_pos; }
+
+			/// The next event, nullopt after the end event or the end of the record
+			auto next() -> optional<GameRecordEvent>;
+
+			/** Place the pieces and terrain of the openings on the board
+
+				Creates the players with their fortresses on the king tiles
+				unless the match already has them, then ends the setup.
+			*/
+			void setUp(Match&) const;
+
+			/** Apply an event returned by next() to the match
+
+				Returns false if the event is not legal in the current
+				position (the match isn't changed then).
+			*/
+			bool apply(Match&, const GameRecordEvent&);
+
+			/// Whose turn it is after the events applied so far
+			auto getTurn() const -> PlayersColor
+			{ return m_turn; }
+	};
+}
+
+#endif // _CYVASSE_GAME_RECORD_HPP_
@@ -19,6 +19,7 @@
 
 #include "hexcoordinate.hpp"
 
+#include <bitset>
 #include <set>
 
 #include <cassert>
@@ -41,6 +42,43 @@ namespace cyvasse
 
 			/// A container with all possible coordinates in this hexagon
 			static const std::set<HexCoordinate<l>> allCoordinates;
+
+			/// One bit per tile, indexed by getIndex()
+			typedef std::bitset<tileCount> TileMask;
+
+			/** Get the index of a coordinate in allCoordinates
+
+				Tiles are counted column by column (X first, then Y),
+				so the index is in the range [0, tileCount).
+			*/
+			static constexpr uint16_t getIndex(HexCoordinate<l> coord)
+			{
+				uint16_t index = 0;
+
+				for (auto X = 0; X < coord.x(); X++)
+					index += getColumnLength(X);
+
+				return index + coord.y() - getColumnBegin(coord.x());
+			}
+
+			/// Get the coordinate with the given index (see getIndex())
+			static HexCoordinate<l> getCoordinate(uint16_t index)
+			{
+				assert(index < tileCount);
+
+				int8_t X = 0;
+				while (index >= getColumnLength(X))
+					index -= getColumnLength(X++);
+
+				return HexCoordinate<l>(X, getColumnBegin(X) + index);
+			}
+
+		private:
+			static constexpr int8_t getColumnBegin(int8_t X)
+			{ return (X < (l - 1)) ? (l - 1 - X) : 0; }
+
+			static constexpr int8_t getColumnLength(int8_t X)
+			{ return (X < (l - 1)) ? (l + X) : (3 * l - 2 - X); }
 	};
 
 	template <uint8_t l>
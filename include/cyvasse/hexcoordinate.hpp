@@ -27,6 +27,7 @@
 #include <cstdint>
 
 #include <optional.hpp>
+#include <string_view.hpp>
 
 namespace cyvasse
 {
@@ -52,6 +53,48 @@ namespace cyvasse
 		BOTTOM_LEFT
 	};
 
+	/** The public notation strings of all coordinates of a hexagon
+
+		Indexed by x and y, so it also contains strings for the
+		invalid coordinates in the corners of the square.
+	 */
+	template <uint8_t l>
+	class HexCoordinateStrTable
+	{
+		private:
+			static constexpr int8_t size = l * 2 - 1;
+
+			char m_strs[size][size][4] {};
+
+		public:
+			constexpr HexCoordinateStrTable()
+			{
+				for (int8_t x = 0; x < size; x++)
+				{
+					for (int8_t y = 0; y < size; y++)
+					{
+						auto& str = m_strs[x][y];
+						auto num = y + 1;
+
+						str[0] = 'A' + x;
+						if (num < 10)
+							str[1] = '0' + num;
+						else
+						{
+							str[1] = '0' + num / 10;
+							str[2] = '0' + num % 10;
+						}
+					}
+				}
+			}
+
+			constexpr string_view get(int8_t x, int8_t y) const
+			{ return string_view(m_strs[x][y]); }
+	};
+
+	template <uint8_t l>
+	constexpr HexCoordinateStrTable<l> hexCoordinateStrTable {};
+
 	/// A coordinate on the hexboard (see mockup/hexboard-coordinates-internal.svg)
 	template <uint8_t l>
 	class HexCoordinate
@@ -97,7 +140,7 @@ namespace cyvasse
 
 			/// Create a HexCoordinate object from a coordinate in the public notation
 			HexCoordinate(const std::string& str)
-				: HexCoordinate(str.at(0) - 'A', std::stoi(str.substr(1)) - 1)
+				: HexCoordinate(parse(str))
 			{ }
 
 			template <typename T>
@@ -117,8 +160,12 @@ namespace cyvasse
 			constexpr int16_t dump() const
 			{ return (m_x << 8) | m_y; }
 
+			/// The coordinate in the public notation, pointing into a static table
+			constexpr string_view toStringView() const
+			{ return hexCoordinateStrTable<l>.get(m_x, m_y); }
+
 			std::string toString() const
-			{ return std::string(1, m_x + 'A') + std::to_string(m_y + 1); }
+			{ return std::string(toStringView()); }
 
 			bool operator==(HexCoordinate other) const
 			{ return dump() == other.dump(); }
@@ -271,12 +318,46 @@ namespace cyvasse
 				return create(va[0], va[1]);
 			}
 			/// @}
+
+			/** Parse a coordinate in the public notation (a capital letter
+				followed by a number without leading zeros)
+
+				Returns nullopt for anything that isn't a valid coordinate,
+				without throwing and without allocating.
+			 */
+			static optional<HexCoordinate> tryParse(string_view str)
+			{
+				if (str.size() < 2 || str.size() > 3 || str[0] < 'A' || str[0] > 'Z' || str[1] < '1' || str[1] > '9')
+					return nullopt;
+
+				int8_t num = str[1] - '0';
+				if (str.size() == 3)
+				{
+					if (str[2] < '0' || str[2] > '9')
+						return nullopt;
+
+					num = num * 10 + (str[2] - '0');
+				}
+
+				return create(str[0] - 'A', num - 1);
+			}
+
+			/// Like tryParse(), but throws std::invalid_argument for invalid input
+			static HexCoordinate parse(string_view str)
+			{
+				auto coord = tryParse(str);
+				if (!coord)
+					throw std::invalid_argument("Invalid HexCoordinate<" + std::to_string(l) + "> "
+						"notation: " + std::string(str));
+
+				return *coord;
+			}
 	};
 
 	template <uint8_t l>
 	std::ostream& operator<<(std::ostream& os, HexCoordinate<l> coord)
 	{
-		os << coord.toString();
+		os << coord.toStringView();
 		return os;
 	}
 }
@@ -18,6 +18,7 @@
 #define _CYVASSE_MATCH_HPP_
 
 #include <array>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <set>
@@ -26,6 +27,7 @@
 
 #include "bearing_table.hpp"
 #include "hexcoordinate.hpp"
+#include "move_cache.hpp"
 #include "piece.hpp"
 #include "player.hpp"
 #include "terrain.hpp"
@@ -51,6 +53,9 @@ namespace cyvasse
 			TerrainMap m_terrain;
 
 			BearingTable m_bearingTable;
+			MoveCache m_moveCache;
+
+			uint64_t m_version = 0;
 
 		public:
 			Match(const std::string& id = {}, bool random = false, bool _public = false, playerArray players = playerArray())
@@ -59,6 +64,7 @@ namespace cyvasse
 				, m_public{_public}
 				, m_players(std::move(players))
 				, m_bearingTable(m_activePieces)
+				, m_moveCache(*this)
 			{ }
 
 			virtual ~Match() = default;
@@ -88,17 +94,41 @@ namespace cyvasse
 			{ return m_setup; }
 
 			void setupDone()
-			{ m_setup = false; }
+			{
+				m_setup = false;
+				m_version++;
+			}
+
+			/** Incremented whenever the board or the setup state changes
+
+				Can be used to tell whether something derived from the match
+				state, like a serialized game status, is still up to date.
+			*/
+			uint64_t getVersion() const
+			{ return m_version; }
+
+			/// Invalidates the MoveCache and increments the version
+			void boardChanged()
+			{
+				m_moveCache.invalidate();
+				m_version++;
+			}
 
 			auto getActivePieces() -> CoordPieceMap&
 			{ return m_activePieces; }
 
+			auto getActivePieces() const -> const CoordPieceMap&
+			{ return m_activePieces; }
+
 			auto getTerrain() -> TerrainMap&
 			{ return m_terrain; }
 
 			auto getBearingTable() -> BearingTable&
 			{ return m_bearingTable; }
 
+			auto getMoveCache() -> MoveCache&
+			{ return m_moveCache; }
+
 			auto getHorseMovementCenters() -> std::set<HexCoordinate<6>>;
 
 			auto getPieceAt(HexCoordinate<6>) -> optional<std::reference_wrapper<Piece>>;
@@ -108,6 +138,21 @@ namespace cyvasse
 			virtual void addToBoard(PieceType, PlayersColor, HexCoordinate<6>);
 			virtual void removeFromBoard(const Piece&);
 			virtual void endGame(PlayersColor /* winner */) { }
+
+			/** Called by Piece::moveTo() after a piece was moved
+
+				oldCoord is nullopt if the piece was placed on the board
+				during the setup. A captured piece is passed to
+				removeFromBoard() before this is called.
+			*/
+			virtual void pieceMoved(const Piece&, optional<HexCoordinate<6>> /* oldCoord */) { }
+
+			/** Called by Piece::promoteTo() with the new piece
+
+				The original piece is passed to removeFromBoard() and the new
+				one to addToBoard() before this is called.
+			*/
+			virtual void piecePromoted(const Piece&, PieceType /* origType */) { }
 	};
 }
 
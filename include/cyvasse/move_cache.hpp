@@ -0,0 +1,72 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVASSE_MOVE_CACHE_HPP_
+#define _CYVASSE_MOVE_CACHE_HPP_
+
+#include <array>
+#include <set>
+
+#include "hexagon.hpp"
+#include "piece.hpp"
+
+namespace cyvasse
+{
+	class Match;
+
+	/** Caches the possible target tiles of all active pieces
+
+		The targets of every piece are generated once, on the first query after
+		the board changed, and stored as one TileMask per board tile (the tile
+		the piece stands on). Match::boardChanged() invalidates the cache
+		whenever a piece is moved, promoted, added to or removed from the board.
+	*/
+	class MoveCache
+	{
+		public:
+			typedef Hexagon<6>::TileMask TileMask;
+
+		private:
+			Match& m_match;
+
+			bool m_valid = false;
+
+			std::array<const Piece*, Hexagon<6>::tileCount> m_pieces;
+			std::array<TileMask, Hexagon<6>::tileCount> m_targetTiles;
+
+			void rebuild();
+
+		public:
+			MoveCache(Match& match)
+				: m_match(match)
+			{ }
+
+			// non-copyable
+			MoveCache(const MoveCache&) = delete;
+			MoveCache& operator=(const MoveCache&) = delete;
+
+			bool isValid() const
+			{ return m_valid; }
+
+			void invalidate()
+			{ m_valid = false; }
+
+			auto getTargetMask(const Piece&) -> const TileMask&;
+			auto getPossibleTargetTiles(const Piece&) -> std::set<HexCoordinate<6>>;
+	};
+}
+
+#endif // _CYVASSE_MOVE_CACHE_HPP_
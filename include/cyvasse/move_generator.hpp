@@ -0,0 +1,157 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVASSE_MOVE_GENERATOR_HPP_
+#define _CYVASSE_MOVE_GENERATOR_HPP_
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include <optional.hpp>
+
+#include "hexcoordinate.hpp"
+#include "piece_type.hpp"
+#include "players_color.hpp"
+
+namespace cyvasse
+{
+	class Match;
+
+	enum class MoveKind
+	{
+		CAPTURE,
+		PROMOTION,
+		QUIET
+	};
+
+	struct Move
+	{
+		MoveKind kind;
+
+		PieceType pieceType;
+		HexCoordinate<6> oldPos;
+		HexCoordinate<6> newPos; // same as oldPos for promotions
+
+		PieceType defType; // only valid for captures
+		PieceType newType; // only valid for promotions
+	};
+
+	/** Lazily generates the moves of one player
+
+		Moves are generated in stages, and a stage is only generated once
+		the moves of the previous one have been consumed:
+
+		1. captures, with the highest victim tier first
+		2. promotions
+		3. quiet moves
+
+		A consumer that only needs the first few moves (e.g. to check whether
+		there is any legal capture) never pays for the quiet moves.
+		The generator must not be used anymore after the board was modified.
+	*/
+	class MoveGenerator
+	{
+		public:
+			class iterator;
+
+		private:
+			Match& m_match;
+			const PlayersColor m_color;
+
+			MoveKind m_stage = MoveKind::CAPTURE;
+			bool m_stageGenerated = false;
+
+			std::vector<Move> m_moves;
+			std::size_t m_pos = 0;
+
+			std::size_t m_captureCount = 0;
+
+			void generateCaptures();
+			void generatePromotions();
+			void generateQuiets();
+
+		public:
+			MoveGenerator(Match& match, PlayersColor color)
+				: m_match(match)
+				, m_color(color)
+			{ }
+
+			// non-copyable
+			MoveGenerator(const MoveGenerator&) = delete;
+			MoveGenerator& operator=(const MoveGenerator&) = delete;
+
+			/// Get the next move, or nullopt if all stages are exhausted
+			auto next() -> optional<Move>;
+
+			/// Check whether there is a legal capture (only generates the first stage)
+			bool hasCapture();
+
+			iterator begin();
+			iterator end();
+	};
+
+	class MoveGenerator::iterator
+	{
+		public:
+			typedef std::input_iterator_tag iterator_category;
+			typedef Move value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef const Move* pointer;
+			typedef const Move& reference;
+
+		private:
+			MoveGenerator* m_gen;
+			optional<Move> m_move;
+
+		public:
+			iterator(MoveGenerator* gen = nullptr)
+				: m_gen(gen)
+			{
+				if (m_gen)
+					++*this;
+			}
+
+			const Move& operator*() const
+			{ return *m_move; }
+
+			const Move* operator->() const
+			{ return &*m_move; }
+
+			iterator& operator++()
+			{
+				m_move = m_gen->next();
+				if (!m_move)
+					m_gen = nullptr;
+
+				return *this;
+			}
+
+			bool operator==(const iterator& other) const
+			{ return m_gen == other.m_gen; }
+
+			bool operator!=(const iterator& other) const
+			{ return m_gen != other.m_gen; }
+	};
+
+	inline auto MoveGenerator::begin() -> iterator
+	{ return iterator(this); }
+
+	inline auto MoveGenerator::end() -> iterator
+	{ return iterator(); }
+}
+
+#endif // _CYVASSE_MOVE_GENERATOR_HPP_
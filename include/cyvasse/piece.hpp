@@ -103,7 +103,9 @@ namespace cyvasse
 
 			auto getBaseTier() const -> uint8_t;
 			auto getEffectiveDefenseTier() const -> uint8_t;
+			auto getEffectiveDefenseTier(HexCoordinate<6>) const -> uint8_t;
 			auto getHomeTerrain() const -> optional<TerrainType>;
+			static auto getHomeTerrain(PieceType) -> optional<TerrainType>;
 			auto getSetupTerrain() const -> optional<TerrainType>;
 			auto getMovementScope() const -> const MovementScope&;
 
@@ -17,6 +17,7 @@
 #ifndef _CYVASSE_PIECE_TYPE_HPP_
 #define _CYVASSE_PIECE_TYPE_HPP_
 
+#include <cstddef>
 #include <enum_str.hpp>
 
 namespace cyvasse
@@ -35,6 +36,8 @@ namespace cyvasse
 		KING
 	};
 
+	constexpr std::size_t pieceTypeCount = 10;
+
 	// placing it in a seperate file still results in unsresolved
 	// symbols although I made sure the cpp would be compiled
 	ENUM_STR(PieceType, ({
@@ -17,6 +17,7 @@
 #ifndef _CYVASSE_PLAYERS_COLOR_HPP_
 #define _CYVASSE_PLAYERS_COLOR_HPP_
 
+#include <string>
 #include <vector>
 #include <cstdint>
 #include <enum_str.hpp>
@@ -31,32 +32,37 @@ namespace cyvasse
 		private:
 			uint8_t m_val;
 
-			explicit PlayersColor(int val)
+		public:
+			// like static_cast from int to an enum
+			constexpr explicit PlayersColor(int val)
 				: m_val(val)
 			{ }
 
-		public:
 			PlayersColor(const PlayersColor&) = default;
 			PlayersColor& operator=(const PlayersColor&) = default;
 
 			static const PlayersColor WHITE;
 			static const PlayersColor BLACK;
 
-			PlayersColor operator!() const;
+			constexpr PlayersColor operator!() const
+			{
+				// int-to-bool, operator!(bool), bool-to-int
+				return PlayersColor(!m_val);
+			}
 
-			bool operator==(PlayersColor other) const
+			constexpr bool operator==(PlayersColor other) const
 			{ return m_val == other.m_val; }
 
-			bool operator!=(PlayersColor other) const
+			constexpr bool operator!=(PlayersColor other) const
 			{ return m_val != other.m_val; }
 
-			bool operator<(PlayersColor other) const
+			constexpr bool operator<(PlayersColor other) const
 			{ return m_val < other.m_val; }
 
-			bool operator>(PlayersColor other) const
+			constexpr bool operator>(PlayersColor other) const
 			{ return m_val > other.m_val; }
 
-			operator uint8_t() const
+			constexpr operator uint8_t() const
 			{ return m_val; }
 
 			// don't allow comparing with bool,
@@ -75,8 +81,9 @@ namespace cyvasse
 			bool operator>(unsigned) const  = delete;
 	};
 
-	// moving the definition to the cpp leads
-	// to undefined references for some reason
+	constexpr PlayersColor PlayersColor::WHITE = PlayersColor(0);
+	constexpr PlayersColor PlayersColor::BLACK = PlayersColor(1);
+
 	ENUM_STR(PlayersColor, ({
 		{PlayersColor::WHITE, "white"},
 		{PlayersColor::BLACK, "black"}
@@ -0,0 +1,150 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVASSE_TRANSPOSITION_TABLE_HPP_
+#define _CYVASSE_TRANSPOSITION_TABLE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <optional.hpp>
+
+namespace cyvasse
+{
+	enum class TTBound : uint8_t
+	{
+		NONE,
+		EXACT,
+		LOWER,
+		UPPER
+	};
+
+	struct TTEntry
+	{
+		int16_t score;
+		int8_t depth;
+		TTBound bound;
+
+		// best move as tile indices (see Hexagon<6>::getIndex()),
+		// equal if there is none
+		uint8_t moveFrom;
+		uint8_t moveTo;
+	};
+
+	struct TTStats
+	{
+		uint64_t probes;
+		uint64_t hits;
+		uint64_t stores;
+
+		// stores that replaced a still valid entry of another position
+		uint64_t collisions;
+
+		double hitRate() const
+		{ return probes ? double(hits) / probes : 0; }
+	};
+
+	/** Transposition table shared by any number of search threads
+
+		The table consists of cache line sized buckets of four entries.
+		Every entry stores its key XORed with its data, so a read that
+		races with a write to the same entry fails verification instead of
+		returning torn data; no locks are used. On a full bucket, the entry
+		with the lowest depth that wasn't written in the current search
+		(see newSearch()) is replaced first.
+
+		Keys are 64 bit position hashes supplied by the caller. Entries are
+		never moved, so the table may also be shared by several bots in the
+		same process, e.g. through a std::shared_ptr.
+	*/
+	class TranspositionTable
+	{
+		private:
+			struct Slot
+			{
+				std::atomic<uint64_t> keyXorData;
+				std::atomic<uint64_t> data;
+			};
+
+			static constexpr std::size_t bucketSize = 4;
+
+			struct alignas(64) Bucket
+			{
+				Slot slots[bucketSize];
+			};
+
+			Bucket* m_buckets = nullptr;
+			std::size_t m_bucketCount = 0;
+			std::size_t m_allocSize = 0;
+
+			std::atomic<uint8_t> m_generation{0};
+
+			// the statistics are counted per thread (threads are spread over
+			// the shards) so the search threads don't share a cache line,
+			// and only summed up by getStats()
+			static constexpr std::size_t statShardCount = 16;
+
+			struct alignas(64) StatShard
+			{
+				std::atomic<uint64_t> probes{0};
+				std::atomic<uint64_t> hits{0};
+				std::atomic<uint64_t> stores{0};
+				std::atomic<uint64_t> collisions{0};
+			};
+
+			StatShard m_statShards[statShardCount];
+
+			StatShard& getStatShard();
+
+			Bucket& getBucket(uint64_t key) const
+			{ return m_buckets[key & (m_bucketCount - 1)]; }
+
+		public:
+			/** Allocate a table using at most byteSize bytes (at least one bucket)
+
+				If useHugePages is set, transparent huge pages are
+				requested for the table on Linux.
+			*/
+			explicit TranspositionTable(std::size_t byteSize, bool useHugePages = false);
+			~TranspositionTable();
+
+			// non-copyable
+			TranspositionTable(const TranspositionTable&) = delete;
+			TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+			std::size_t getByteSize() const
+			{ return m_bucketCount * sizeof(Bucket); }
+
+			std::size_t getEntryCount() const
+			{ return m_bucketCount * bucketSize; }
+
+			/// Start a new search; entries of older searches are replaced first
+			void newSearch()
+			{ m_generation.fetch_add(1, std::memory_order_relaxed); }
+
+			auto probe(uint64_t key) -> optional<TTEntry>;
+			void store(uint64_t key, const TTEntry&);
+
+			/// Remove all entries (not thread safe)
+			void clear();
+
+			auto getStats() const -> TTStats;
+			void resetStats();
+	};
+}
+
+#endif // _CYVASSE_TRANSPOSITION_TABLE_HPP_
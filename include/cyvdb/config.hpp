@@ -17,6 +17,7 @@
 #ifndef _CYVDB_CONFIG_HPP_
 #define _CYVDB_CONFIG_HPP_
 
+#include <cstddef>
 #include <string>
 
 namespace cyvdb
@@ -25,6 +26,7 @@ namespace cyvdb
 	{
 		private:
 			std::string m_matchDataUrl;
+			std::size_t m_connectionPoolSize = 4;
 
 			DBConfig() = default;
 
@@ -43,6 +45,13 @@ namespace cyvdb
 
 			void setMatchDataUrl(const std::string& url)
 			{ m_matchDataUrl = url; }
+
+			/// Has to be set before ConnectionPool::glob() is first used
+			std::size_t getConnectionPoolSize() const
+			{ return m_connectionPoolSize; }
+
+			void setConnectionPoolSize(std::size_t size)
+			{ m_connectionPoolSize = size; }
 	};
 }
 
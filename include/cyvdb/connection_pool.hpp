@@ -0,0 +1,169 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVDB_CONNECTION_POOL_HPP_
+#define _CYVDB_CONNECTION_POOL_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <tntdb/connection.h>
+
+namespace cyvdb
+{
+	/// A statement the managers use with prepareCached(), so it can be prepared in advance
+	struct CachedStatement
+	{
+		const char* query;
+		const char* cacheKey;
+	};
+
+	inline tntdb::Statement prepareCached(tntdb::Connection& conn, const CachedStatement& statement)
+	{ return conn.prepareCached(statement.query, statement.cacheKey); }
+
+	/** A fixed number of database connections shared by the worker threads
+
+		All connections are opened and warmed up (the warmup functions
+		usually prepare the statements of the managers) when the pool is
+		constructed, not on demand, so a burst of requests can't cause a
+		burst of connects. acquire() hands out a connection for exclusive
+		use until the returned Lease is destroyed, waiting if all of them
+		are in use. A thread gets the connection it had last time if that
+		one is free.
+
+		A connection that turned out to be broken can be discard()ed, it is
+		then reconnected (and warmed up again) by the next acquire() that
+		gets it.
+	 */
+	class ConnectionPool
+	{
+		public:
+			typedef std::function<void(tntdb::Connection&)> Warmup;
+			/// Opens one connection, throws on failure
+			typedef std::function<tntdb::Connection()> Connector;
+
+			struct Metrics
+			{
+				std::size_t checkouts = 0;
+				/// Checkouts that had to wait for a connection to be released
+				std::size_t waits = 0;
+				/// Checkouts that got the connection the thread had last time
+				std::size_t affinityHits = 0;
+				std::size_t reconnects = 0;
+
+				std::chrono::nanoseconds totalWait {0};
+				std::chrono::nanoseconds maxWait {0};
+				/// How long connections were held, over all released leases
+				std::chrono::nanoseconds totalCheckout {0};
+				std::chrono::nanoseconds maxCheckout {0};
+			};
+
+			class Lease
+			{
+				private:
+					ConnectionPool* m_pool = nullptr;
+					std::size_t m_index = 0;
+					std::chrono::steady_clock::time_point m_checkedOut;
+					bool m_discard = false;
+
+					friend class ConnectionPool;
+					Lease(ConnectionPool* pool, std::size_t index);
+
+				public:
+					/// An empty lease, as returned by a tryAcquire() that timed out
+					Lease() = default;
+					~Lease();
+
+					Lease(Lease&&) noexcept;
+					Lease& operator=(Lease&&) noexcept;
+
+					explicit operator bool() const
+					{ return m_pool != nullptr; }
+
+					tntdb::Connection& operator*() const;
+					tntdb::Connection* operator->() const
+					{ return &**this; }
+
+					/// Mark the connection as broken, it is reconnected before it is used again
+					void discard()
+					{ m_discard = true; }
+
+					/// Give the connection back to the pool now
+					void release();
+			};
+
+		private:
+			struct Slot
+			{
+				tntdb::Connection conn;
+				bool inUse = false;
+				bool broken = false;
+			};
+
+			const Connector m_connector;
+			const std::vector<Warmup> m_warmups;
+
+			mutable std::mutex m_mutex;
+			std::condition_variable m_released;
+
+			std::vector<Slot> m_slots;
+			std::unordered_map<std::thread::id, std::size_t> m_affinity;
+			Metrics m_metrics;
+
+			void connect(Slot&);
+			bool takeFree(std::thread::id, std::size_t& index);
+			Lease checkout(bool hasDeadline, std::chrono::steady_clock::time_point deadline);
+			void release(std::size_t index, std::chrono::steady_clock::time_point checkedOut, bool discard);
+
+		public:
+			/// Connects size times to url, throws if any of the connects fails
+			ConnectionPool(std::string url, std::size_t size, std::vector<Warmup> warmups = {});
+			/// Opens (and reopens) the connections with connector instead of
+			/// tntdb::connect(), so the pool can be used without a database (unit tests)
+			ConnectionPool(Connector connector, std::size_t size, std::vector<Warmup> warmups = {});
+
+			// non-copyable
+			ConnectionPool(const ConnectionPool&) = delete;
+			ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+			/** The pool used by the default constructors of the managers
+
+				Connects to DBConfig::glob().getMatchDataUrl() with
+				DBConfig::glob().getConnectionPoolSize() connections on
+				first use, prepares the statements of all managers and
+				loads their DimensionCaches.
+			 */
+			static ConnectionPool& glob();
+
+			/// Wait until a connection is free
+			Lease acquire();
+			/// Wait at most timeout, returns an empty Lease if no connection got free
+			Lease tryAcquire(std::chrono::milliseconds timeout);
+
+			std::size_t size() const
+			{ return m_slots.size(); }
+
+			Metrics getMetrics() const;
+	};
+}
+
+#endif // _CYVDB_CONNECTION_POOL_HPP_
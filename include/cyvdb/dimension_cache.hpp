@@ -0,0 +1,82 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVDB_DIMENSION_CACHE_HPP_
+#define _CYVDB_DIMENSION_CACHE_HPP_
+
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <optional.hpp>
+#include <tntdb/connection.h>
+
+namespace cyvdb
+{
+	/** Caches the IDs of a small lookup table like players_colors
+
+		Such tables only map a string to an auto-increment ID and almost
+		never change, so looking the ID up for every insert wastes a round
+		trip. load() reads the whole table once at startup. getID() then
+		answers from memory. For a string that isn't cached, it selects the
+		ID, inserts the string if it is missing, and caches the result.
+		Thread-safe. Misses are handled one at a time, so a string isn't
+		inserted twice by this process.
+
+		Only committed IDs may be cached, so getID() must not be called
+		with a connection that is inside a transaction: if that was rolled
+		back, the cached ID would point to nothing. Code that writes in a
+		transaction or through a WriteBehindQueue resolves its IDs first.
+	 */
+	class DimensionCache
+	{
+		private:
+			const std::string m_loadQuery;
+			const std::string m_selectQuery;
+			const std::string m_insertQuery;
+			const std::string m_cacheKeyPrefix;
+
+			mutable std::shared_timed_mutex m_mutex;
+			std::mutex m_missMutex;
+
+			std::unordered_map<std::string, int> m_ids;
+			bool m_loaded = false;
+
+		public:
+			/// For a table like "CREATE TABLE <table> (<idColumn> SERIAL, <strColumn> TEXT)"
+			DimensionCache(const std::string& table, const std::string& idColumn, const std::string& strColumn);
+
+			// non-copyable
+			DimensionCache(const DimensionCache&) = delete;
+			DimensionCache& operator=(const DimensionCache&) = delete;
+
+			/// Replace the cached IDs with the contents of the table
+			void load(tntdb::Connection&);
+
+			bool isLoaded() const;
+
+			/// The ID of str, inserted into the table if necessary.
+			/// The connection must not be inside a transaction.
+			int getID(tntdb::Connection&, const std::string& str);
+
+			/// The ID of str if it is cached, doesn't touch the database
+			optional<int> getCachedID(const std::string& str) const;
+
+			void prepareStatements(tntdb::Connection&) const;
+	};
+}
+
+#endif // _CYVDB_DIMENSION_CACHE_HPP_
@@ -17,36 +17,73 @@
 #ifndef _CYVDB_MATCH_MANAGER_HPP_
 #define _CYVDB_MATCH_MANAGER_HPP_
 
-#include <memory>
-#include <cassert>
+#include <array>
+#include <string>
+#include <vector>
 #include <tntdb/connection.h>
-#include <cyvasse/match.hpp>
+#include <cyvasse/players_color.hpp>
+#include <cyvdb/connection_pool.hpp>
+#include <cyvdb/dimension_cache.hpp>
 
 namespace cyvdb
 {
+	/// A row of the matches table, with the IDs of the players that joined
+	struct MatchInfo
+	{
+		std::string id;
+		std::string ruleSet;
+		bool isRandom = false;
+		bool isPublic = false;
+
+		/// Indexed by PlayersColor, empty if no player of that color joined
+		std::array<std::string, 2> playerIDs;
+
+		unsigned getPlayerCount() const
+		{ return !playerIDs[0].empty() + !playerIDs[1].empty(); }
+	};
+
 	class MatchManager
 	{
 		private:
+			ConnectionPool* m_pool = nullptr; // m_conn is used if this is null
 			tntdb::Connection m_conn;
 
-			static bool matchValid(const cyvasse::Match& match);
+			static bool matchValid(const MatchInfo& match);
 
-			//int getRuleSetID(cyvasse::RuleSet);
+			/// From the cache, only uses a connection if the rule set isn't cached yet
+			int getRuleSetID(const std::string& ruleSet);
+
+			/// Runs func with m_conn, or with a connection borrowed from m_pool for the call
+			template<class Func>
+			void withConnection(Func func);
 
 		public:
 			explicit MatchManager(tntdb::Connection& conn);
+			/// Borrows a connection from the pool for each operation
+			explicit MatchManager(ConnectionPool& pool);
+			/// Borrows connections from ConnectionPool::glob()
 			MatchManager();
 
+			/// Prepare all statements used by MatchManager (ConnectionPool warmup)
+			static void prepareStatements(tntdb::Connection&);
+
+			/// The IDs of the rule_sets table
+			static DimensionCache& getRuleSets();
+
 			// queries
-			typedef std::vector<std::unique_ptr<cyvasse::Match>> matchList;
 
-			//matchList getOpenRandomMatches();
-			//matchList getRunningPublicMatches();
+			/** All matches with their players, in the order they were created
+
+				One query for everything, used to fill the MatchRegistry at
+				startup. The lobby lists are served by the MatchRegistry.
+			 */
+			std::vector<MatchInfo> getAllMatches();
 
 			// modifications
-			//void addMatch(std::unique_ptr<cyvasse::Match>);
+			/// Only inserts the match, the players are added through the PlayerManager
+			void addMatch(const MatchInfo&);
 
-			//void removeMatch(const std::string& id);
+			void removeMatch(const std::string& id);
 	};
 }
 
@@ -0,0 +1,123 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVDB_MATCH_REGISTRY_HPP_
+#define _CYVDB_MATCH_REGISTRY_HPP_
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <optional.hpp>
+#include <cyvasse/players_color.hpp>
+#include <cyvdb/connection_pool.hpp>
+#include <cyvdb/match_manager.hpp>
+
+namespace cyvdb
+{
+	/** All matches in memory, indexed by their lobby status
+
+		Replaces the lobby queries, which grouped all matches by their
+		player count on every refresh and then fetched the players of
+		every match separately. The registry is filled with a single query
+		by load() at startup. After that the lobby lists are served from
+		memory, without touching the database.
+
+		Modifications are written through: the database is updated first,
+		on the calling thread, and the registry only after that succeeded.
+		A match and its players are written in one transaction.
+		They are serialized among each other, but don't block readers
+		while the database is written.
+
+		A match is an open random match while it is random and has one
+		player, and a running public match while it is public and has two.
+		Both lists are in the order the matches were created.
+
+		The database is only accessed through the protected virtual
+		functions, the unit tests replace them with an in-memory table.
+	 */
+	class MatchRegistry
+	{
+		private:
+			struct Entry
+			{
+				MatchInfo info;
+				uint64_t seq; // creation order
+			};
+
+			ConnectionPool* m_pool;
+
+			std::mutex m_writeMutex;
+			mutable std::shared_timed_mutex m_mutex;
+
+			std::unordered_map<std::string, Entry> m_matches;
+			std::map<uint64_t, const MatchInfo*> m_openRandom;
+			std::map<uint64_t, const MatchInfo*> m_runningPublic;
+			uint64_t m_nextSeq = 0;
+
+			void index(const Entry&);
+			void unindex(const Entry&);
+
+			/// Copy of the entry, throws std::invalid_argument if there is none
+			MatchInfo getExisting(const std::string& matchID) const;
+
+			static std::vector<MatchInfo> toList(const std::map<uint64_t, const MatchInfo*>&);
+
+		protected:
+			/// pool may be null if all of the database functions below are overridden
+			explicit MatchRegistry(ConnectionPool* pool);
+
+			// database access, called with the write lock held but not the registry lock
+			virtual std::vector<MatchInfo> loadMatches();
+			/// Inserts the match and its players in one transaction
+			virtual void insertMatch(const MatchInfo&);
+			/// Deletes the match and its players in one transaction
+			virtual void deleteMatch(const MatchInfo&);
+			virtual void insertPlayer(const std::string& matchID, cyvasse::PlayersColor, const std::string& playerID);
+			virtual void deletePlayer(const std::string& playerID);
+
+		public:
+			explicit MatchRegistry(ConnectionPool& pool = ConnectionPool::glob());
+			virtual ~MatchRegistry() = default;
+
+			// non-copyable
+			MatchRegistry(const MatchRegistry&) = delete;
+			MatchRegistry& operator=(const MatchRegistry&) = delete;
+
+			/// Replace the contents with all matches from the database
+			void load();
+
+			// queries
+			optional<MatchInfo> getMatch(const std::string& matchID) const;
+			std::vector<MatchInfo> getOpenRandomMatches() const;
+			std::vector<MatchInfo> getRunningPublicMatches() const;
+
+			std::size_t size() const;
+
+			// modifications, these throw std::invalid_argument for unknown
+			// matches or occupied colors, and pass on database errors
+			void addMatch(const MatchInfo&);
+			void removeMatch(const std::string& matchID);
+
+			void addPlayer(const std::string& matchID, cyvasse::PlayersColor, const std::string& playerID);
+			void removePlayer(const std::string& matchID, cyvasse::PlayersColor);
+	};
+}
+
+#endif // _CYVDB_MATCH_REGISTRY_HPP_
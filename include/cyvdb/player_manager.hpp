@@ -23,6 +23,9 @@
 #include <tntdb/connection.h>
 #include <cyvasse/match.hpp>
 #include <cyvasse/player.hpp>
+#include <cyvdb/connection_pool.hpp>
+#include <cyvdb/dimension_cache.hpp>
+#include <cyvdb/write_behind_queue.hpp>
 
 namespace cyvdb
 {
@@ -32,22 +35,55 @@ namespace cyvdb
 			typedef std::array<std::unique_ptr<cyvasse::Player>, 2> playerArray;
 
 		private:
+			ConnectionPool* m_pool = nullptr; // m_conn is used if this is null
 			tntdb::Connection m_conn;
+			WriteBehindQueue* m_writeQueue = nullptr;
 
-			static bool playerValid(const cyvasse::Player&);
+			static bool playerIDValid(const std::string& playerID);
 
+			/// From the cache, only uses a connection if the color isn't cached yet.
+			/// With a WriteBehindQueue, a color that isn't cached is an error.
 			int getPlayersColorID(cyvasse::PlayersColor color);
 
+			static void insertPlayer(tntdb::Connection&, const std::string& playerID,
+				const std::string& matchID, int colorID);
+
+			/// Runs func with m_conn, or with a connection borrowed from m_pool for the call
+			template<class Func>
+			void withConnection(Func func);
+
 		public:
 			explicit PlayerManager(tntdb::Connection& conn);
+			/// Borrows a connection from the pool for each operation
+			explicit PlayerManager(ConnectionPool& pool);
+			/// Borrows connections from ConnectionPool::glob()
 			PlayerManager();
 
+			/** Queue modifications instead of executing them on the calling thread
+
+				Doesn't use a connection on the calling thread. The
+				players_color IDs are taken from getPlayersColors(), which
+				has to be loaded (the ConnectionPool::glob() warmup does
+				that); addPlayer() throws std::logic_error otherwise.
+			 */
+			explicit PlayerManager(WriteBehindQueue& writeQueue);
+
+			/// Prepare all statements used by PlayerManager (ConnectionPool warmup)
+			static void prepareStatements(tntdb::Connection&);
+
+			/// The IDs of the players_colors table
+			static DimensionCache& getPlayersColors();
+
 			// queries
 			//cyvasse::Player getPlayer(const std::string& playerID);
 			//playerArray getPlayers(cyvasse::Match&);
 
 			// modifications
+			// (with a WriteBehindQueue, these throw WriteQueueFull if it is full)
 			void addPlayer(std::unique_ptr<cyvasse::Player>, const std::string& matchID);
+			void addPlayer(const std::string& playerID, cyvasse::PlayersColor, const std::string& matchID);
+
+			void removePlayer(const std::string& playerID);
 	};
 }
 
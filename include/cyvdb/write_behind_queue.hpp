@@ -0,0 +1,147 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVDB_WRITE_BEHIND_QUEUE_HPP_
+#define _CYVDB_WRITE_BEHIND_QUEUE_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <tntdb/connection.h>
+
+namespace cyvdb
+{
+	/// Thrown by WriteBehindQueue::push() if the queue is full
+	class WriteQueueFull : public std::runtime_error
+	{
+		public:
+			WriteQueueFull()
+				: std::runtime_error("The database write queue is full")
+			{ }
+	};
+
+	/** Runs database modifications on a background thread
+
+		push() only queues an operation and returns immediately, so the
+		game loop never waits for the database. A writer thread with its
+		own connection takes the queued operations in order and runs them
+		in one transaction per batch. A batch is started when maxBatchSize
+		operations are queued or the oldest one has waited maxBatchDelay,
+		whichever comes first.
+
+		The queue holds at most capacity operations. If it is full, push()
+		throws WriteQueueFull instead of blocking. This is the backpressure
+		that lets callers reject new work while the database is behind.
+
+		If a batch fails, it is rolled back and every operation is retried
+		in a transaction of its own. Operations that still fail are passed
+		to the error handler and dropped.
+	 */
+	class WriteBehindQueue
+	{
+		public:
+			/// Called on the writer thread with its connection
+			typedef std::function<void(tntdb::Connection&)> Operation;
+			typedef std::function<void(const std::exception&)> ErrorHandler;
+			/// Runs func in a transaction on the connection: commits if
+			/// func returns, rolls back and rethrows if it throws
+			typedef std::function<void(tntdb::Connection&, const std::function<void()>& func)> TransactionRunner;
+
+		private:
+			struct Entry
+			{
+				Operation operation;
+				std::chrono::steady_clock::time_point queued;
+			};
+
+			tntdb::Connection m_conn;
+			TransactionRunner m_runTransaction;
+
+			const std::size_t m_capacity;
+			const std::size_t m_maxBatchSize;
+			const std::chrono::milliseconds m_maxBatchDelay;
+
+			ErrorHandler m_errorHandler;
+
+			mutable std::mutex m_mutex;
+			std::condition_variable m_pushed;
+			std::condition_variable m_written;
+
+			std::deque<Entry> m_queue;
+			std::size_t m_pushedCount = 0;
+			std::size_t m_writtenCount = 0;
+			std::size_t m_failedCount = 0;
+			std::size_t m_transactionCount = 0;
+			unsigned m_flushWaiters = 0;
+			bool m_stopping = false;
+
+			std::thread m_thread;
+
+			void run();
+			std::size_t write(std::vector<Operation>& batch);
+
+		public:
+			/// conn is only used by the writer thread from now on
+			explicit WriteBehindQueue(tntdb::Connection conn, std::size_t capacity = 4096,
+				std::size_t maxBatchSize = 256, std::chrono::milliseconds maxBatchDelay = std::chrono::milliseconds(20));
+			/// Runs the transactions through runTransaction instead of tntdb::Transaction,
+			/// so the queue can be used without a database (unit tests)
+			WriteBehindQueue(tntdb::Connection conn, TransactionRunner runTransaction, std::size_t capacity = 4096,
+				std::size_t maxBatchSize = 256, std::chrono::milliseconds maxBatchDelay = std::chrono::milliseconds(20));
+			/// Opens a new connection to DBConfig::glob().getMatchDataUrl()
+			WriteBehindQueue();
+			/// Writes everything still queued, then stops the writer thread
+			~WriteBehindQueue();
+
+			// non-copyable
+			WriteBehindQueue(const WriteBehindQueue&) = delete;
+			WriteBehindQueue& operator=(const WriteBehindQueue&) = delete;
+
+			/// Set before the first push(), the default handler ignores errors.
+			/// Called on the writer thread, must not throw.
+			void setErrorHandler(ErrorHandler handler)
+			{ m_errorHandler = std::move(handler); }
+
+			/** Queue an operation, throws WriteQueueFull if the queue is full
+
+				The operation has to own everything it uses (capture by
+				value), it runs after push() returned. Throws
+				std::logic_error if the queue is already being destroyed.
+			 */
+			void push(Operation);
+			/// Like push(), but returns false instead of throwing WriteQueueFull
+			/// (std::logic_error is still thrown while the queue is destroyed)
+			bool tryPush(Operation);
+
+			/// Block until everything pushed before the call was written (or failed)
+			void flush();
+
+			std::size_t getPendingCount() const;
+			/// Operations taken off the queue so far, including the failed ones
+			std::size_t getWrittenCount() const;
+			std::size_t getFailedCount() const;
+			std::size_t getTransactionCount() const;
+	};
+}
+
+#endif // _CYVDB_WRITE_BEHIND_QUEUE_HPP_
@@ -0,0 +1,53 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVWS_ARENA_MSG_HPP_
+#define _CYVWS_ARENA_MSG_HPP_
+
+#include <string_view.hpp>
+#include <cyvws/msg_arena.hpp>
+
+namespace cyvws
+{
+	/** Message builders that serialize into a MsgArena
+
+		Each function produces byte-for-byte the same output as serializing
+		the Json::Value returned by the json:: function of the same name
+		with a Json::StreamWriterBuilder with empty indentation, but the
+		only memory it uses comes from the arena. jsoncpp's Value can't
+		use a custom allocator, so these write the JSON text directly.
+
+		The returned views are valid until the arena is reset. Game
+		messages themselves are written by GameMsgWriter, which reuses its
+		buffer and so doesn't allocate in the steady state either.
+	 */
+	namespace arena
+	{
+		string_view gameMsgAck(MsgArena&, unsigned msgID);
+		string_view gameMsgErr(MsgArena&, unsigned msgID, string_view error);
+
+		string_view requestSuccess(MsgArena&, unsigned msgID);
+		string_view requestErr(MsgArena&, unsigned msgID, string_view error, string_view errDetails = {});
+		string_view createGameSuccess(MsgArena&, unsigned msgID, string_view matchID, string_view playerID);
+
+		string_view commErr(MsgArena&, string_view errMsg);
+		string_view userJoined(MsgArena&, string_view username, bool registered, string_view role);
+		string_view userLeft(MsgArena&, string_view username);
+		string_view usernameUpdate(MsgArena&, string_view oldUsername, string_view newUsername);
+	}
+}
+
+#endif // _CYVWS_ARENA_MSG_HPP_
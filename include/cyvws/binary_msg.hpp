@@ -0,0 +1,147 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVWS_BINARY_MSG_HPP_
+#define _CYVWS_BINARY_MSG_HPP_
+
+#include <cstdint>
+#include <string>
+#include <enum_str.hpp>
+#include <optional.hpp>
+#include <string_view.hpp>
+#include <cyvws/game_msg.hpp>
+#include <cyvws/json_game_msg.hpp>
+#include <cyvws/msg.hpp>
+
+/* Binary encoding of the cyvws messages
+
+   Used instead of JSON text when the client appended BINARY_PROTOCOL_SUFFIX
+   to the protocolVersion of its initComm request and the server echoed it
+   in the protocolVersion of its reply (see replyProtocolVersion()). Both
+   sides switch after the initComm reply; a server that doesn't know the
+   encoding replies without the suffix, and the client keeps sending JSON
+   text. Every message starts with
+   a MsgTypeCode byte; most message types then carry the msgID as an
+   unsigned LEB128 varint:
+
+     chatMsg       msgID, user (string), content (string)
+     chatMsgAck    msgID
+     gameMsg       msgID, GameMsgActionCode, action parameters
+     gameMsgAck    msgID
+     gameMsgErr    msgID, error (string)
+     json          the rest of the message is a JSON text message
+
+   Strings are a varint byte length followed by the bytes. Piece types are
+   single bytes holding the PieceType value, coordinates single bytes
+   holding the Hexagon<6>::getIndex() of the tile. The game message
+   parameters are:
+
+     move             pieceType, oldPos, newPos
+     moveCapture      atkPieceType, oldPos, newPos, defPieceType, defPiecePos
+     promote          origType, newType
+     setOpeningArray  type count, then per type: pieceType, coordinate count, coordinates
+
+   Notifications, server requests and server replies are rare compared to
+   game messages and are sent as json messages.
+ */
+
+namespace cyvws
+{
+	enum class MsgTypeCode : uint8_t
+	{
+		JSON,
+		CHAT_MSG,
+		CHAT_MSG_ACK,
+		GAME_MSG,
+		GAME_MSG_ACK,
+		GAME_MSG_ERR
+	};
+
+	ENUM_STR(MsgTypeCode, ({
+		{MsgTypeCode::JSON, "json"},
+		{MsgTypeCode::CHAT_MSG, MsgType::CHAT_MSG},
+		{MsgTypeCode::CHAT_MSG_ACK, MsgType::CHAT_MSG_ACK},
+		{MsgTypeCode::GAME_MSG, MsgType::GAME_MSG},
+		{MsgTypeCode::GAME_MSG_ACK, MsgType::GAME_MSG_ACK},
+		{MsgTypeCode::GAME_MSG_ERR, MsgType::GAME_MSG_ERR}
+	}))
+
+	enum class BinaryMsgError
+	{
+		NONE,
+		TRUNCATED,
+		TRAILING_DATA,
+		INVALID_VARINT,
+		INVALID_MSG_TYPE,
+		INVALID_ACTION,
+		INVALID_PIECE_TYPE,
+		INVALID_COORDINATE
+	};
+
+	/// A decoded binary message. All views point into the decoded buffer.
+	struct BinaryMsg
+	{
+		MsgTypeCode type;
+		unsigned msgID;
+
+		// gameMsg
+		GameMsgActionCode action;
+		optional<PieceMovement> movement;
+		optional<MoveCapture> moveCapture;
+		optional<Promotion> promotion;
+		PieceMap pieceMap;
+
+		// chatMsg: user and content, gameMsgErr: error in text,
+		// json: the complete JSON message in text
+		string_view user;
+		string_view text;
+	};
+
+	namespace binary
+	{
+		/** Whether a protocolVersion requests the binary encoding
+
+			Used by the server on the initComm request, and by the client
+			on the initComm reply to check that the server agreed.
+		*/
+		bool requestsBinaryProtocol(const std::string& protocolVersion);
+
+		/// The protocolVersion for the initComm reply, with the suffix if the client requested it
+		std::string replyProtocolVersion(const std::string& serverVersion, const std::string& requestedVersion);
+
+		std::string jsonMsg(const std::string& msg);
+
+		std::string chatMsg(unsigned msgID, const std::string& user, const std::string& content);
+		std::string chatMsgAck(unsigned msgID);
+
+		std::string gameMsgSetOpeningArray(unsigned msgID, const PieceMap&);
+		std::string gameMsgSetIsReady(unsigned msgID);
+		std::string gameMsgMove(unsigned msgID, cyvasse::PieceType pieceType,
+		                        cyvasse::HexCoordinate<6> oldPos, cyvasse::HexCoordinate<6> newPos);
+		std::string gameMsgMoveCapture(unsigned msgID, cyvasse::PieceType atkPT, cyvasse::HexCoordinate<6> oldPos,
+		                               cyvasse::HexCoordinate<6> newPos, cyvasse::PieceType defPT,
+		                               cyvasse::HexCoordinate<6> defPiecePos);
+		std::string gameMsgPromote(unsigned msgID, cyvasse::PieceType origType, cyvasse::PieceType newType);
+		std::string gameMsgEndTurn(unsigned msgID);
+		std::string gameMsgResign(unsigned msgID);
+		std::string gameMsgAck(unsigned msgID);
+		std::string gameMsgErr(unsigned msgID, const std::string& error);
+
+		BinaryMsgError decode(string_view msg, BinaryMsg&);
+	}
+}
+
+#endif // _CYVWS_BINARY_MSG_HPP_
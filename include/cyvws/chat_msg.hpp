@@ -17,13 +17,11 @@
 #ifndef _CYVWS_CHAT_MSG_HPP_
 #define _CYVWS_CHAT_MSG_HPP_
 
-#include <string>
-
 namespace cyvws
 {
-	const std::string
-		CONTENT = "content",
-		USER    = "user";
+	constexpr char
+		CONTENT[] = "content",
+		USER[]    = "user";
 }
 
 #endif // _CYVWS_CHAT_MSG_HPP_
@@ -17,26 +17,24 @@
 #ifndef _CYVWS_COMMON_HPP_
 #define _CYVWS_COMMON_HPP_
 
-#include <string>
-
 namespace cyvws
 {
-	const std::string
-		ACTION      = "action",
-		COLOR       = "color",
-		ERR_MSG     = "errMsg",
-		ERR_DETAILS = "errDetails",
-		MATCH_ID    = "matchID",
-		MSG_DATA    = "msgData",
-		PARAM       = "param",
-		PLAYER_ID   = "playerID",
-		PUBLIC      = "public",
-		RANDOM      = "random",
-		REGISTERED  = "registered",
-		ROLE        = "role",
-		RULE_SET    = "ruleSet",
-		TYPE        = "type",
-		USERNAME    = "username";
+	constexpr char
+		ACTION[]      = "action",
+		COLOR[]       = "color",
+		ERR_MSG[]     = "errMsg",
+		ERR_DETAILS[] = "errDetails",
+		MATCH_ID[]    = "matchID",
+		MSG_DATA[]    = "msgData",
+		PARAM[]       = "param",
+		PLAYER_ID[]   = "playerID",
+		PUBLIC[]      = "public",
+		RANDOM[]      = "random",
+		REGISTERED[]  = "registered",
+		ROLE[]        = "role",
+		RULE_SET[]    = "ruleSet",
+		TYPE[]        = "type",
+		USERNAME[]    = "username";
 }
 
 #endif // _CYVWS_COMMON_HPP_
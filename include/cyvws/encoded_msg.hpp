@@ -0,0 +1,81 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVWS_ENCODED_MSG_HPP_
+#define _CYVWS_ENCODED_MSG_HPP_
+
+#include <memory>
+#include <string>
+#include <string_view.hpp>
+
+namespace Json { class Value; }
+
+namespace cyvws
+{
+	enum class MsgEncoding
+	{
+		JSON,
+		BINARY
+	};
+
+	/** An encoded message that can be sent to any number of connections
+
+		The message is serialized once when the EncodedMsg is created. After
+		that, the buffer is immutable and shared by all copies through a
+		reference count, so handing it to N connections costs N reference
+		count increments instead of N serializations.
+
+		If requested, the WebSocket frame header of an unfragmented, unmasked
+		server-to-client frame (text for JSON, binary for the binary encoding)
+		is put directly in front of the payload. getFrame() then returns
+		header and payload as one contiguous buffer.
+	 */
+	class EncodedMsg
+	{
+		private:
+			// enough for the longest frame header (opcode byte, length byte, 64-bit length)
+			static constexpr std::size_t maxFrameHeaderSize = 10;
+
+			std::shared_ptr<const std::string> m_buf;
+			std::size_t m_frameOffset;
+			MsgEncoding m_encoding;
+
+		public:
+			EncodedMsg(MsgEncoding encoding, string_view payload, bool withFrame = false);
+
+			/// Serialize a message to compact JSON
+			static EncodedMsg fromJson(const Json::Value&, bool withFrame = false);
+
+			MsgEncoding getEncoding() const
+			{ return m_encoding; }
+
+			string_view getPayload() const
+			{ return string_view(*m_buf).substr(maxFrameHeaderSize); }
+
+			bool hasFrame() const
+			{ return m_frameOffset != maxFrameHeaderSize; }
+
+			/// The frame header followed by the payload, empty if created without frame
+			string_view getFrame() const
+			{ return hasFrame() ? string_view(*m_buf).substr(m_frameOffset) : string_view(); }
+
+			/// The number of EncodedMsg objects sharing this message
+			long getUseCount() const
+			{ return m_buf.use_count(); }
+	};
+}
+
+#endif // _CYVWS_ENCODED_MSG_HPP_
@@ -17,31 +17,57 @@
 #ifndef _CYVWS_GAME_MSG_HPP_
 #define _CYVWS_GAME_MSG_HPP_
 
-#include <string>
+#include <cstdint>
+#include <enum_str.hpp>
 
 namespace cyvws
 {
-	const std::string
-		ATK_PIECE  = "atkPiece",
-		DEF_PIECE  = "defPiece",
-		NEW_POS    = "newPos",
-		NEW_TYPE   = "newType",
-		OLD_POS    = "oldPos",
-		ORIG_TYPE  = "origType",
-		PIECE_TYPE = "pieceType",
-		POS        = "pos";
+	constexpr char
+		ATK_PIECE[]  = "atkPiece",
+		DEF_PIECE[]  = "defPiece",
+		NEW_POS[]    = "newPos",
+		NEW_TYPE[]   = "newType",
+		OLD_POS[]    = "oldPos",
+		ORIG_TYPE[]  = "origType",
+		PIECE_TYPE[] = "pieceType",
+		POS[]        = "pos";
 
 	namespace GameMsgAction
 	{
-		const std::string
-			END_TURN          = "endTurn",
-			MOVE              = "move",
-			MOVE_CAPTURE      = "moveCapture",
-			PROMOTE           = "promote",
-			RESIGN            = "resign",
-			SET_IS_READY      = "setIsReady",
-			SET_OPENING_ARRAY = "setOpeningArray";
+		constexpr char
+			END_TURN[]          = "endTurn",
+			MOVE[]              = "move",
+			MOVE_CAPTURE[]      = "moveCapture",
+			PROMOTE[]           = "promote",
+			RESIGN[]            = "resign",
+			SET_IS_READY[]      = "setIsReady",
+			SET_OPENING_ARRAY[] = "setOpeningArray";
 	}
+
+	enum class GameMsgActionCode : uint8_t
+	{
+		END_TURN,
+		MOVE,
+		MOVE_CAPTURE,
+		PROMOTE,
+		RESIGN,
+		SET_IS_READY,
+		SET_OPENING_ARRAY
+	};
+
+	ENUM_STR(GameMsgActionCode, ({
+		{GameMsgActionCode::END_TURN, GameMsgAction::END_TURN},
+		{GameMsgActionCode::MOVE, GameMsgAction::MOVE},
+		{GameMsgActionCode::MOVE_CAPTURE, GameMsgAction::MOVE_CAPTURE},
+		{GameMsgActionCode::PROMOTE, GameMsgAction::PROMOTE},
+		{GameMsgActionCode::RESIGN, GameMsgAction::RESIGN},
+		{GameMsgActionCode::SET_IS_READY, GameMsgAction::SET_IS_READY},
+		{GameMsgActionCode::SET_OPENING_ARRAY, GameMsgAction::SET_OPENING_ARRAY}
+	}))
+
+	/// Map an action string to its code in constant time, nullopt for unknown actions
+	constexpr optional<GameMsgActionCode> findGameMsgAction(string_view action)
+	{ return tryStrToGameMsgActionCode(action); }
 }
 
 #endif // _CYVWS_GAME_MSG_HPP_
@@ -0,0 +1,98 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVWS_GAME_MSG_PARSER_HPP_
+#define _CYVWS_GAME_MSG_PARSER_HPP_
+
+#include <cstddef>
+#include <enum_str.hpp>
+#include <optional.hpp>
+#include <string_view.hpp>
+#include <cyvws/json_game_msg.hpp>
+
+namespace cyvws
+{
+	enum class GameMsgParseError
+	{
+		NONE,
+		SYNTAX_ERROR,
+		NESTING_TOO_DEEP,
+		UNEXPECTED_TYPE,
+		MISSING_MEMBER,
+		WRONG_MSG_TYPE,
+		INVALID_MSG_ID,
+		INVALID_PIECE_TYPE,
+		INVALID_COORDINATE,
+		TOO_MANY_PIECES
+	};
+
+	ENUM_STR(GameMsgParseError, ({
+		{GameMsgParseError::NONE, "none"},
+		{GameMsgParseError::SYNTAX_ERROR, "syntax error"},
+		{GameMsgParseError::NESTING_TOO_DEEP, "nesting too deep"},
+		{GameMsgParseError::UNEXPECTED_TYPE, "unexpected type"},
+		{GameMsgParseError::MISSING_MEMBER, "missing member"},
+		{GameMsgParseError::WRONG_MSG_TYPE, "wrong msgType"},
+		{GameMsgParseError::INVALID_MSG_ID, "invalid msgID"},
+		{GameMsgParseError::INVALID_PIECE_TYPE, "invalid piece type"},
+		{GameMsgParseError::INVALID_COORDINATE, "invalid coordinate"},
+		{GameMsgParseError::TOO_MANY_PIECES, "too many pieces"}
+	}))
+
+	/// The envelope of a game message. All views point into the parsed buffer.
+	struct GameMsgView
+	{
+		string_view action;
+		/// The code of action, nullopt if it is not a known game message action
+		optional<GameMsgActionCode> actionCode;
+		optional<int> msgID;
+
+		/// The unparsed param value, empty if the message has none
+		string_view param;
+	};
+
+	/** In-situ parser for incoming game messages
+
+		These functions read the JSON text directly, without building a
+		Json::Value first, and report malformed input through the return
+		value instead of throwing. Strings are not unescaped, so a value
+		containing escape sequences never matches a valid piece type,
+		coordinate or msgType. Unknown members are skipped.
+
+		Parsing is done in two steps: parseGameMsg() validates the whole
+		message and hands out the param value, which is then decoded by
+		the parse function belonging to the action.
+	 */
+	namespace parser
+	{
+		GameMsgParseError parseGameMsg(string_view msg, GameMsgView&);
+
+		GameMsgParseError parseMovement(string_view param, PieceMovement&);
+		GameMsgParseError parseMoveCapture(string_view param, MoveCapture&);
+		GameMsgParseError parsePromotion(string_view param, Promotion&);
+
+		/** Decode the param of setOpeningArray into a caller-provided buffer
+
+			Fails with TOO_MANY_PIECES if more than maxCount positions are found.
+		 */
+		GameMsgParseError parsePiecePositions(string_view param, PiecePosition* positions,
+		                                      std::size_t maxCount, std::size_t& count);
+		/// Same as above, but inserting into a PieceMap (which is left partially filled on errors)
+		GameMsgParseError parsePieceMap(string_view param, PieceMap&);
+	}
+}
+
+#endif // _CYVWS_GAME_MSG_PARSER_HPP_
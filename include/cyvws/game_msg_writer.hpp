@@ -0,0 +1,77 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVWS_GAME_MSG_WRITER_HPP_
+#define _CYVWS_GAME_MSG_WRITER_HPP_
+
+#include <map>
+#include <string>
+#include <cyvws/json_game_msg.hpp>
+
+namespace cyvws
+{
+	/** Serializes game messages directly into a reusable buffer
+
+		Produces byte-for-byte the same output as serializing the
+		Json::Value returned by the matching json::gameMsg*() function
+		with a Json::StreamWriterBuilder with empty indentation,
+		without building the intermediate Json::Value.
+
+		Every write method replaces the buffer contents and returns a
+		reference to the buffer, which is valid until the next call.
+	 */
+	class GameMsgWriter
+	{
+		private:
+			std::string m_buffer;
+
+			void begin(const char* action);
+			void end();
+
+			void appendCoord(cyvasse::HexCoordinate<6>);
+			void appendPieceType(cyvasse::PieceType);
+
+		public:
+			explicit GameMsgWriter(std::size_t reserve = 512);
+
+			const std::string& getBuffer() const
+			{ return m_buffer; }
+
+			const std::string& setOpeningArray(const PieceMap&);
+			template <class piece_t> // convenience overload
+			const std::string& setOpeningArray(const std::map<cyvasse::HexCoordinate<6>, piece_t>& pieces);
+
+			const std::string& setIsReady();
+			const std::string& move(cyvasse::PieceType pieceType, cyvasse::HexCoordinate<6> oldPos,
+			                        cyvasse::HexCoordinate<6> newPos);
+			const std::string& moveCapture(cyvasse::PieceType atkPT, cyvasse::HexCoordinate<6> oldPos,
+			                               cyvasse::HexCoordinate<6> newPos, cyvasse::PieceType defPT,
+			                               cyvasse::HexCoordinate<6> defPiecePos);
+			const std::string& promote(cyvasse::PieceType origType, cyvasse::PieceType newType);
+	};
+
+	template <class piece_t>
+	const std::string& GameMsgWriter::setOpeningArray(const std::map<cyvasse::HexCoordinate<6>, piece_t>& pieces)
+	{
+		PieceMap map;
+		for (auto&& it : pieces)
+			map[it.second->getType()].insert(it.first);
+
+		return setOpeningArray(map);
+	}
+}
+
+#endif // _CYVWS_GAME_MSG_WRITER_HPP_
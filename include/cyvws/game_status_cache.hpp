@@ -0,0 +1,69 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVWS_GAME_STATUS_CACHE_HPP_
+#define _CYVWS_GAME_STATUS_CACHE_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <cyvws/encoded_msg.hpp>
+
+namespace Json { class Value; }
+namespace cyvasse { class Match; }
+
+namespace cyvws
+{
+	/** Serialized gameStatus of one match, shared by everyone joining it
+
+		The piece positions in a joinGame reply are built by walking the
+		whole board. When many spectators join the same match, they all get
+		the same gameStatus, so it is serialized once per Match version and
+		reused until the match changes again (see Match::getVersion()).
+
+		Like Match itself, this isn't synchronized, it has to be used under
+		the same lock as the match.
+	 */
+	class GameStatusCache
+	{
+		private:
+			const cyvasse::Match& m_match;
+
+			std::shared_ptr<const std::string> m_gameStatus;
+			uint64_t m_version = 0;
+			uint64_t m_rebuildCount = 0;
+
+		public:
+			explicit GameStatusCache(const cyvasse::Match& match)
+				: m_match(match)
+			{ }
+
+			/// The gameStatus as compact JSON, rebuilt if the match changed since the last call
+			std::shared_ptr<const std::string> get();
+
+			/** A joinGame reply with the cached gameStatus added to replyData
+
+				replyData must not contain a gameStatus member itself.
+			 */
+			EncodedMsg joinGameReply(unsigned msgID, const Json::Value& replyData, bool withFrame = false);
+
+			/// How often the gameStatus had to be serialized
+			uint64_t getRebuildCount() const
+			{ return m_rebuildCount; }
+	};
+}
+
+#endif // _CYVWS_GAME_STATUS_CACHE_HPP_
@@ -17,11 +17,13 @@
 #ifndef _CYVWS_INIT_COMM_HPP_
 #define _CYVWS_INIT_COMM_HPP_
 
-#include <string>
-
 namespace cyvws
 {
-	const std::string PROTOCOL_VERSION = "protocolVersion";
+	constexpr char PROTOCOL_VERSION[] = "protocolVersion";
+
+	/// Appended to the protocolVersion by clients that understand the
+	/// binary encoding (see binary_msg.hpp), for example "1.0+bin"
+	constexpr char BINARY_PROTOCOL_SUFFIX[] = "+bin";
 }
 
 #endif // _CYVWS_INIT_COMM_HPP_
@@ -94,6 +94,9 @@ namespace cyvws
 		Json::Value gameMsgMoveCapture(PieceType atkPT, HexCoordinate<6> oldPos, HexCoordinate<6> newPos,
 		                               PieceType defPT, HexCoordinate<6> defPiecePos);
 		Json::Value gameMsgPromote(PieceType origType, PieceType newType);
+
+		Json::Value gameMsgAck(unsigned msgID);
+		Json::Value gameMsgErr(unsigned msgID, const string& error);
 	}
 }
 
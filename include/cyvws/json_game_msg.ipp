@@ -28,7 +28,7 @@ namespace cyvws
 			for (auto&& it : pieces)
 			{
 				auto pieceTypeStr = PieceTypeToStr(it.second->getType());
-				data[pieceTypeStr].append(it.first.toString());
+				data[std::string(pieceTypeStr)].append(it.first.toString());
 			}
 
 			return data;
@@ -18,6 +18,7 @@
 #define _CYVWS_JSON_NOTIFICATION_HPP_
 
 #include <string>
+#include <vector>
 #include <cyvws/notification.hpp>
 
 namespace Json { class Value; }
@@ -27,9 +28,17 @@ namespace cyvws
 	namespace json
 	{
 		Json::Value notification(const Json::Value& notificationData);
+		Json::Value notificationBatch(const std::vector<Json::Value>& notificationDatas);
+
+		/// Read the listContent (or added / modified) array of a games list notification,
+		/// throws std::invalid_argument or Json::LogicError if it is malformed
+		GamesListMap gamesListContent(const Json::Value& content);
 
 		Json::Value commErr(const std::string& errMsg);
 		Json::Value listUpdate(const std::string& listName, const GamesListMap& curList);
+		Json::Value listUpdate(const std::string& listName, const GamesListMap& curList, unsigned version);
+		Json::Value listDelta(const std::string& listName, unsigned baseVersion, unsigned version,
+			const GamesListMap& added, const GamesListMap& modified, const std::vector<std::string>& removed);
 		Json::Value userJoined(const std::string& username, bool registered, const std::string& role);
 		Json::Value userLeft(const std::string& username);
 		Json::Value usernameUpdate(const std::string& oldUsername, const std::string& newUsername);
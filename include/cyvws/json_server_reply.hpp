@@ -19,6 +19,8 @@
 
 #include <json/value.h>
 
+namespace cyvasse { class Match; }
+
 namespace cyvws
 {
 	namespace json
@@ -27,7 +29,15 @@ namespace cyvws
 
 		Json::Value requestSuccess(unsigned msgID);
 		Json::Value requestErr(unsigned msgID, const std::string& error, const std::string& errDetails = {});
+		/// protocolVersion is the negotiated one, see binary::replyProtocolVersion()
+		Json::Value initCommSuccess(unsigned msgID, const std::string& protocolVersion);
 		Json::Value createGameSuccess(unsigned msgID, const std::string& matchID, const std::string& playerID);
+
+		/** The gameStatus member of a joinGame reply, see GameStatusCache
+
+			Only contains the piece positions once the setup is done.
+		 */
+		Json::Value gameStatus(const cyvasse::Match&);
 	}
 }
 
@@ -17,25 +17,24 @@
 #ifndef _CYVWS_MSG_HPP_
 #define _CYVWS_MSG_HPP_
 
-#include <string>
-
 namespace cyvws
 {
-	const std::string
-		MSG_TYPE = "msgType",
-		MSG_ID   = "msgID";
+	constexpr char
+		MSG_TYPE[]  = "msgType",
+		MSG_ID[]    = "msgID",
+		MSG_ERROR[] = "error";
 
 	namespace MsgType
 	{
-		const std::string
-			CHAT_MSG       = "chatMsg",
-			CHAT_MSG_ACK   = "chatMsgAck",
-			GAME_MSG       = "gameMsg",
-			GAME_MSG_ACK   = "gameMsgAck",
-			GAME_MSG_ERR   = "gameMsgErr",
-			NOTIFICATION   = "notification",
-			SERVER_REPLY   = "serverReply",
-			SERVER_REQUEST = "serverRequest";
+		constexpr char
+			CHAT_MSG[]       = "chatMsg",
+			CHAT_MSG_ACK[]   = "chatMsgAck",
+			GAME_MSG[]       = "gameMsg",
+			GAME_MSG_ACK[]   = "gameMsgAck",
+			GAME_MSG_ERR[]   = "gameMsgErr",
+			NOTIFICATION[]   = "notification",
+			SERVER_REPLY[]   = "serverReply",
+			SERVER_REQUEST[] = "serverRequest";
 	}
 }
 
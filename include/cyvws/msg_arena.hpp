@@ -0,0 +1,82 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVWS_MSG_ARENA_HPP_
+#define _CYVWS_MSG_ARENA_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace cyvws
+{
+	/** Monotonic memory arena for building outgoing messages
+
+		allocate() hands out memory by bumping a pointer, there is no way
+		to free single allocations. Instead, all memory is released at once
+		with reset(), usually after the message built in the arena was sent.
+
+		If a message needed more than one block, reset() replaces the blocks
+		by a single one of their combined size. After the first few messages
+		the arena therefore doesn't allocate at all anymore, which can be
+		confirmed with getBlockAllocCount().
+	 */
+	class MsgArena
+	{
+		private:
+			struct Block
+			{
+				std::unique_ptr<char[]> data;
+				std::size_t size;
+			};
+
+			std::vector<Block> m_blocks;
+			std::size_t m_blockSize;
+
+			char* m_pos = nullptr;
+			char* m_end = nullptr;
+
+			std::size_t m_bytesUsed = 0;
+			std::size_t m_blockAllocCount = 0;
+
+			void addBlock(std::size_t minSize);
+
+		public:
+			explicit MsgArena(std::size_t blockSize = 4096);
+
+			// non-copyable
+			MsgArena(const MsgArena&) = delete;
+			MsgArena& operator=(const MsgArena&) = delete;
+
+			void* allocate(std::size_t size, std::size_t align = alignof(std::max_align_t));
+
+			/// Invalidates everything allocated from the arena
+			void reset();
+
+			/// The number of bytes allocated since the last reset
+			std::size_t getBytesUsed() const
+			{ return m_bytesUsed; }
+
+			/// The combined size of all blocks
+			std::size_t getCapacity() const;
+
+			/// How often the arena had to allocate a block since it was created
+			std::size_t getBlockAllocCount() const
+			{ return m_blockAllocCount; }
+	};
+}
+
+#endif // _CYVWS_MSG_ARENA_HPP_
@@ -0,0 +1,117 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVWS_MSG_COMPRESSION_HPP_
+#define _CYVWS_MSG_COMPRESSION_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <optional.hpp>
+#include <string_view.hpp>
+
+/* Per-message deflate with a preset dictionary (only built if zlib is found)
+
+   The messages are small and consist mostly of the same few tokens, which
+   plain deflate can't exploit because every message starts with an empty
+   window. Both sides therefore preload the window with a dictionary of
+   those tokens. With context takeover (the default), the window is also
+   kept from one message to the next, like WebSocket permessage-deflate
+   does. The output is raw deflate data without the trailing empty block
+   (00 00 ff ff), so it can be used as a permessage-deflate payload.
+
+   Both ends have to use the same dictionary, getDictionaryID() can be
+   exchanged to make sure they do.
+ */
+
+struct z_stream_s;
+
+namespace cyvws
+{
+	/** Build a preset dictionary from sample messages
+
+		Collects the substrings between JSON token boundaries that occur in
+		more than one place and keeps those that save the most bytes, most
+		valuable last (deflate encodes short distances cheaper).
+	 */
+	std::string trainDictionary(const std::vector<std::string>& samples, std::size_t maxSize = 4096);
+
+	/** The dictionary used if no other one is given
+
+		Trained on the compact serialization of all message types with
+		every piece type, plus the quoted strings of all coordinates.
+		Generated once, on first use.
+	 */
+	const std::string& defaultDictionary();
+
+	/// The Adler-32 checksum of a dictionary, as zlib reports it
+	uint32_t getDictionaryID(string_view dictionary);
+
+	class MsgDeflater
+	{
+		private:
+			std::unique_ptr<z_stream_s> m_stream;
+			std::string m_dictionary;
+			std::string m_buffer;
+			bool m_contextTakeover;
+
+		public:
+			/// level is a zlib compression level (0 - 9, -1 for the default)
+			explicit MsgDeflater(string_view dictionary = defaultDictionary(), bool contextTakeover = true, int level = -1);
+			~MsgDeflater();
+
+			// non-copyable
+			MsgDeflater(const MsgDeflater&) = delete;
+			MsgDeflater& operator=(const MsgDeflater&) = delete;
+
+			/// Compress one message, the result is valid until the next call
+			string_view compress(string_view msg);
+	};
+
+	class MsgInflater
+	{
+		private:
+			std::unique_ptr<z_stream_s> m_stream;
+			std::string m_dictionary;
+			std::string m_buffer;
+			std::size_t m_maxMsgSize;
+			bool m_contextTakeover;
+
+			void resetStream();
+
+		public:
+			/// contextTakeover has to match the setting of the other side's MsgDeflater
+			explicit MsgInflater(string_view dictionary = defaultDictionary(), bool contextTakeover = true,
+			                     std::size_t maxMsgSize = 1 << 20);
+			~MsgInflater();
+
+			// non-copyable
+			MsgInflater(const MsgInflater&) = delete;
+			MsgInflater& operator=(const MsgInflater&) = delete;
+
+			/** Decompress one message, the result is valid until the next call
+
+				Returns nullopt for corrupt data or messages larger than
+				maxMsgSize. The stream can't be used after that, the
+				connection should be closed.
+			 */
+			optional<string_view> decompress(string_view data);
+	};
+}
+
+#endif // _CYVWS_MSG_COMPRESSION_HPP_
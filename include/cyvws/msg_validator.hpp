@@ -0,0 +1,147 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVWS_MSG_VALIDATOR_HPP_
+#define _CYVWS_MSG_VALIDATOR_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <enum_str.hpp>
+
+namespace Json { class Value; }
+
+namespace cyvws
+{
+	enum class MsgValidationError
+	{
+		NONE,
+		UNEXPECTED_TYPE,
+		MISSING_MEMBER,
+		UNEXPECTED_VALUE,
+		INVALID_VALUE,
+		UNKNOWN_MSG_TYPE,
+		UNKNOWN_VARIANT
+	};
+
+	ENUM_STR(MsgValidationError, ({
+		{MsgValidationError::NONE, "none"},
+		{MsgValidationError::UNEXPECTED_TYPE, "unexpected type"},
+		{MsgValidationError::MISSING_MEMBER, "missing member"},
+		{MsgValidationError::UNEXPECTED_VALUE, "unexpected value"},
+		{MsgValidationError::INVALID_VALUE, "invalid value"},
+		{MsgValidationError::UNKNOWN_MSG_TYPE, "unknown msgType"},
+		{MsgValidationError::UNKNOWN_VARIANT, "unknown action or type"}
+	}))
+
+	struct MsgValidationResult
+	{
+		MsgValidationError error = MsgValidationError::NONE;
+		/// Where the error was found, like "msgData.param.oldPos" or "param.lists[1]"
+		std::string path;
+
+		explicit operator bool() const
+		{ return error == MsgValidationError::NONE; }
+
+		/// "<path>: <error>", suitable for gameMsgErr and commError
+		std::string toString() const;
+	};
+
+	/** Validates messages against a schema compiled from a declarative description
+
+		The description is a JSON array of message schemas, written like the
+		examples in ws-msg-examples:
+
+		 - an object requires all of its members, keys starting with '?'
+		   are optional. Members not in the schema are allowed.
+		 - an object with the single key "<pieceType>" is a map from piece
+		   types to the given value schema
+		 - an array with one element is an array of values of that schema
+		 - "<any>", "<bool>", "<uint>", "<string>", "<coord>", "<pieceType>",
+		   "<color>" and "<gamesList>" match values of that type / domain
+		 - any other string only matches itself
+
+		Messages are looked up by msgType. If there are multiple schemas for
+		one msgType, the path of the string constant which tells them apart
+		(like msgData.action) is found when compiling, so a message is only
+		checked against the one schema that applies to it. Validation is one
+		pass over the message and only builds strings if it fails.
+	 */
+	class MsgValidator
+	{
+		public:
+			/// Throws std::invalid_argument if the description is malformed
+			explicit MsgValidator(const Json::Value& description);
+
+			MsgValidationResult validate(const Json::Value& msg) const;
+
+			/// The validator for everything a client sends to the server, compiled on first use
+			static const MsgValidator& inbound();
+
+		private:
+			enum class NodeType : uint8_t
+			{
+				ANY,
+				BOOL,
+				UINT,
+				STRING,
+				LITERAL,
+				COORD,
+				PIECE_TYPE,
+				COLOR,
+				GAMES_LIST,
+				OBJECT,
+				ARRAY,
+				MAP
+			};
+
+			struct Member
+			{
+				std::string key;
+				bool optional;
+				std::size_t node;
+			};
+
+			struct Node
+			{
+				NodeType type;
+				std::string literal;         // LITERAL
+				std::vector<Member> members; // OBJECT
+				std::size_t element = 0;     // ARRAY, MAP
+				NodeType keyType = NodeType::STRING; // MAP
+			};
+
+			struct MsgTypeSchemas
+			{
+				// empty if there is only one schema
+				std::vector<std::string> discriminator;
+				std::map<std::string, std::size_t> variants;
+			};
+
+			std::vector<Node> m_nodes;
+			std::map<std::string, MsgTypeSchemas> m_msgTypes;
+
+			std::size_t compile(const Json::Value& description);
+			void findDiscriminator(MsgTypeSchemas&, const std::vector<std::size_t>& roots);
+
+			static bool checkString(NodeType, string_view);
+			bool check(std::size_t node, const Json::Value&, MsgValidationResult&, std::vector<std::string>& path) const;
+	};
+}
+
+#endif // _CYVWS_MSG_VALIDATOR_HPP_
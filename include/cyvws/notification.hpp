@@ -17,37 +17,46 @@
 #ifndef _CYVWS_NOTIFICATION_HPP_
 #define _CYVWS_NOTIFICATION_HPP_
 
+#include <map>
 #include <string>
 #include <cyvasse/players_color.hpp>
 
 namespace cyvws
 {
-	const std::string
-		NOTIFICATION_DATA = "notificationData",
-		LIST_NAME         = "listName",
-		LIST_CONTENT      = "listContent",
-		TITLE             = "title",
-		PLAY_AS           = "playAs",
-		OLD_USERNAME      = "oldUsername",
-		NEW_USERNAME      = "newUsername";
+	constexpr char
+		NOTIFICATION_DATA[] = "notificationData",
+		LIST_NAME[]         = "listName",
+		LIST_CONTENT[]      = "listContent",
+		TITLE[]             = "title",
+		PLAY_AS[]           = "playAs",
+		OLD_USERNAME[]      = "oldUsername",
+		NEW_USERNAME[]      = "newUsername",
+		LIST_VERSION[]      = "version",
+		BASE_VERSION[]      = "baseVersion",
+		ADDED[]             = "added",
+		MODIFIED[]          = "modified",
+		REMOVED[]           = "removed",
+		NOTIFICATIONS[]     = "notifications";
 
 	namespace NotificationType
 	{
-		const std::string
-			COMM_ERROR      = "commError",
-			LIST_UPDATE     = "listUpdate",
-			USER_JOINED     = "userJoined",
-			USER_LEFT       = "userLeft",
-			USERNAME_UPDATE = "usernameUpdate";
+		constexpr char
+			BATCH[]           = "batch",
+			COMM_ERROR[]      = "commError",
+			LIST_DELTA[]      = "listDelta",
+			LIST_UPDATE[]     = "listUpdate",
+			USER_JOINED[]     = "userJoined",
+			USER_LEFT[]       = "userLeft",
+			USERNAME_UPDATE[] = "usernameUpdate";
 	}
 
-	const std::string LISTS = "lists";
+	constexpr char LISTS[] = "lists";
 
 	namespace GamesList
 	{
-		const std::string
-			OPEN_RANDOM_GAMES    = "openRandomGames",
-			RUNNING_PUBLIC_GAMES = "runningPublicGames";
+		constexpr char
+			OPEN_RANDOM_GAMES[]    = "openRandomGames",
+			RUNNING_PUBLIC_GAMES[] = "runningPublicGames";
 	}
 
 	struct GamesListMappedType
@@ -0,0 +1,151 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVWS_NOTIFICATION_COALESCER_HPP_
+#define _CYVWS_NOTIFICATION_COALESCER_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+#include <json/value.h>
+#include <optional.hpp>
+
+namespace cyvws
+{
+	/** The notifications queued for one subscriber during one window
+
+		add() merges the new notification with the queued ones where
+		possible:
+
+		 - userJoined followed by userLeft of the same user cancel out
+		 - usernameUpdates are applied to a queued userJoined or chained
+		   with a queued usernameUpdate of the same user
+		 - a listUpdate replaces all queued notifications for that list
+		 - a listDelta is merged into a queued listUpdate or listDelta for
+		   that list if the versions line up
+	 */
+	class NotificationBatch
+	{
+		private:
+			// notificationData values, null for the ones that were merged away
+			std::vector<Json::Value> m_notifications;
+			std::size_t m_received = 0;
+			std::size_t m_size = 0;
+
+			Json::Value* findLast(const char* type, const char* key, const Json::Value& value);
+			void drop(Json::Value& notificationData);
+
+		public:
+			/// Takes a complete notification message as built by json::notification()
+			void add(const Json::Value& msg);
+
+			/// The number of notifications passed to add()
+			std::size_t getReceived() const
+			{ return m_received; }
+
+			/// The number of notifications left after merging
+			std::size_t size() const
+			{ return m_size; }
+
+			bool empty() const
+			{ return m_size == 0; }
+
+			/** The message to send
+
+				A single notification is returned as is, multiple ones are
+				wrapped in a batch notification. Null if nothing is left.
+			 */
+			Json::Value toMsg() const;
+	};
+
+	struct CoalescerStats
+	{
+		uint64_t received = 0; // notifications pushed
+		uint64_t merged   = 0; // notifications that were cancelled or merged into others
+		uint64_t frames   = 0; // messages handed to the send function
+	};
+
+	/** Per-subscriber queue that coalesces bursts of lobby notifications
+
+		The first notification for a subscriber opens a window of the
+		configured length, everything pushed for that subscriber until the
+		window ends is merged into one NotificationBatch. flush() sends the
+		batches whose window has ended, it should be called at least every
+		getWindow() (or at getNextDeadline()).
+
+		SubscriberT is whatever identifies a connection, Compare can be used
+		for handles that aren't ordered by operator< (like std::owner_less
+		for weak_ptrs). The statistics are updated when a batch is flushed.
+	 */
+	template <typename SubscriberT, typename Compare = std::less<SubscriberT>, typename Clock = std::chrono::steady_clock>
+	class NotificationCoalescer
+	{
+		public:
+			typedef typename Clock::duration Duration;
+			typedef typename Clock::time_point TimePoint;
+
+		private:
+			struct Pending
+			{
+				TimePoint windowEnd;
+				NotificationBatch batch;
+			};
+
+			std::map<SubscriberT, Pending, Compare> m_pending;
+			Duration m_window;
+			CoalescerStats m_stats;
+
+			template <typename SendFunc>
+			void send(const SubscriberT&, const NotificationBatch&, SendFunc&);
+
+		public:
+			explicit NotificationCoalescer(Duration window = std::chrono::milliseconds(50))
+				: m_window(window)
+			{ }
+
+			Duration getWindow() const
+			{ return m_window; }
+
+			const CoalescerStats& getStats() const
+			{ return m_stats; }
+
+			/// The number of subscribers with queued notifications
+			std::size_t getPendingCount() const
+			{ return m_pending.size(); }
+
+			/// The earliest end of a window, nullopt if nothing is queued
+			optional<TimePoint> getNextDeadline() const;
+
+			void push(const SubscriberT& subscriber, const Json::Value& msg, TimePoint now = Clock::now());
+
+			/** Calls send(subscriber, msg) for every batch whose window has ended
+
+				Returns the number of messages sent.
+			 */
+			template <typename SendFunc>
+			std::size_t flush(SendFunc&& send, TimePoint now = Clock::now());
+
+			/// Sends all batches, regardless of their window
+			template <typename SendFunc>
+			std::size_t flushAll(SendFunc&& send);
+	};
+}
+
+#include "notification_coalescer.ipp"
+
+#endif // _CYVWS_NOTIFICATION_COALESCER_HPP_
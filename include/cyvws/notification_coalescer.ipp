@@ -0,0 +1,90 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace cyvws
+{
+	template <typename SubscriberT, typename Compare, typename Clock>
+	template <typename SendFunc>
+	void NotificationCoalescer<SubscriberT, Compare, Clock>::send(const SubscriberT& subscriber,
+		const NotificationBatch& batch, SendFunc& sendFunc)
+	{
+		m_stats.received += batch.getReceived();
+		m_stats.merged   += batch.getReceived() - batch.size();
+
+		if (!batch.empty())
+		{
+			sendFunc(subscriber, batch.toMsg());
+			m_stats.frames++;
+		}
+	}
+
+	template <typename SubscriberT, typename Compare, typename Clock>
+	auto NotificationCoalescer<SubscriberT, Compare, Clock>::getNextDeadline() const -> optional<TimePoint>
+	{
+		optional<TimePoint> deadline;
+		for (auto&& it : m_pending)
+		{
+			if (!deadline || it.second.windowEnd < *deadline)
+				deadline = it.second.windowEnd;
+		}
+
+		return deadline;
+	}
+
+	template <typename SubscriberT, typename Compare, typename Clock>
+	void NotificationCoalescer<SubscriberT, Compare, Clock>::push(const SubscriberT& subscriber,
+		const Json::Value& msg, TimePoint now)
+	{
+		auto it = m_pending.find(subscriber);
+		if (it == m_pending.end())
+			it = m_pending.emplace(subscriber, Pending {now + m_window, NotificationBatch()}).first;
+
+		it->second.batch.add(msg);
+	}
+
+	template <typename SubscriberT, typename Compare, typename Clock>
+	template <typename SendFunc>
+	std::size_t NotificationCoalescer<SubscriberT, Compare, Clock>::flush(SendFunc&& sendFunc, TimePoint now)
+	{
+		auto framesBefore = m_stats.frames;
+
+		for (auto it = m_pending.begin(); it != m_pending.end();)
+		{
+			if (it->second.windowEnd <= now)
+			{
+				send(it->first, it->second.batch, sendFunc);
+				it = m_pending.erase(it);
+			}
+			else
+				++it;
+		}
+
+		return m_stats.frames - framesBefore;
+	}
+
+	template <typename SubscriberT, typename Compare, typename Clock>
+	template <typename SendFunc>
+	std::size_t NotificationCoalescer<SubscriberT, Compare, Clock>::flushAll(SendFunc&& sendFunc)
+	{
+		auto framesBefore = m_stats.frames;
+
+		for (auto&& it : m_pending)
+			send(it.first, it.second.batch, sendFunc);
+
+		m_pending.clear();
+		return m_stats.frames - framesBefore;
+	}
+}
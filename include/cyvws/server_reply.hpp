@@ -17,33 +17,31 @@
 #ifndef _CYVWS_SERVER_REPLY_HPP_
 #define _CYVWS_SERVER_REPLY_HPP_
 
-#include <string>
-
 namespace cyvws
 {
-	const std::string
-		GAME_STATUS = "gameStatus",
-		REPLY_DATA  = "replyData";
+	constexpr char
+		GAME_STATUS[] = "gameStatus",
+		REPLY_DATA[]  = "replyData";
 
-	const std::string
-		OPPONENT        = "opponent",
-		PIECE_POSITIONS = "piecePositions",
-		SETUP           = "setup",
-		SUCCESS         = "success",
-		USERS           = "users";
+	constexpr char
+		OPPONENT[]        = "opponent",
+		PIECE_POSITIONS[] = "piecePositions",
+		SETUP[]           = "setup",
+		SUCCESS[]         = "success",
+		USERS[]           = "users";
 
 	namespace ServerReplyErrMsg
 	{
-		const std::string
-			CONN_IN_USE         = "connInUse",
-			DIFF_MAJOR_PROT_V   = "differingMajorProtVersion",
-			GAME_EMPTY          = "gameEmpty",
-			GAME_FULL           = "gameFull",
-			GAME_IN_SETUP       = "gameInSetup", // resuming already set-up games not yet supported
-			GAME_NOT_FOUND      = "gameNotFound",
-			LIST_DOES_NOT_EXIST = "listDoesNotExist",
-			MAINTENANCE_MODE    = "maintenanceMode",
-			NOT_IN_GAME         = "notInGame";
+		constexpr char
+			CONN_IN_USE[]         = "connInUse",
+			DIFF_MAJOR_PROT_V[]   = "differingMajorProtVersion",
+			GAME_EMPTY[]          = "gameEmpty",
+			GAME_FULL[]           = "gameFull",
+			GAME_IN_SETUP[]       = "gameInSetup", // resuming already set-up games not yet supported
+			GAME_NOT_FOUND[]      = "gameNotFound",
+			LIST_DOES_NOT_EXIST[] = "listDoesNotExist",
+			MAINTENANCE_MODE[]    = "maintenanceMode",
+			NOT_IN_GAME[]         = "notInGame";
 	}
 }
 
@@ -17,22 +17,46 @@
 #ifndef _CYVWS_SERVER_REQUEST_HPP_
 #define _CYVWS_SERVER_REQUEST_HPP_
 
-#include <string>
+#include <cstdint>
+#include <enum_str.hpp>
 
 namespace cyvws
 {
-	const std::string REQUEST_DATA = "requestData";
+	constexpr char REQUEST_DATA[] = "requestData";
 
 	namespace ServerRequestAction
 	{
-		const std::string
-			CREATE_GAME                = "createGame",
-			INIT_COMM                  = "initComm",
-			JOIN_GAME                  = "joinGame",
-			SET_USERNAME               = "setUsername",
-			SUBSCR_GAME_LIST_UPDATES   = "subscrGameListUpdates",
-			UNSUBSCR_GAME_LIST_UPDATES = "unsubscrGameListUpdates";
+		constexpr char
+			CREATE_GAME[]                = "createGame",
+			INIT_COMM[]                  = "initComm",
+			JOIN_GAME[]                  = "joinGame",
+			SET_USERNAME[]               = "setUsername",
+			SUBSCR_GAME_LIST_UPDATES[]   = "subscrGameListUpdates",
+			UNSUBSCR_GAME_LIST_UPDATES[] = "unsubscrGameListUpdates";
 	}
+
+	enum class ServerRequestActionCode : uint8_t
+	{
+		CREATE_GAME,
+		INIT_COMM,
+		JOIN_GAME,
+		SET_USERNAME,
+		SUBSCR_GAME_LIST_UPDATES,
+		UNSUBSCR_GAME_LIST_UPDATES
+	};
+
+	ENUM_STR(ServerRequestActionCode, ({
+		{ServerRequestActionCode::CREATE_GAME, ServerRequestAction::CREATE_GAME},
+		{ServerRequestActionCode::INIT_COMM, ServerRequestAction::INIT_COMM},
+		{ServerRequestActionCode::JOIN_GAME, ServerRequestAction::JOIN_GAME},
+		{ServerRequestActionCode::SET_USERNAME, ServerRequestAction::SET_USERNAME},
+		{ServerRequestActionCode::SUBSCR_GAME_LIST_UPDATES, ServerRequestAction::SUBSCR_GAME_LIST_UPDATES},
+		{ServerRequestActionCode::UNSUBSCR_GAME_LIST_UPDATES, ServerRequestAction::UNSUBSCR_GAME_LIST_UPDATES}
+	}))
+
+	/// Map an action string to its code in constant time, nullopt for unknown actions
+	constexpr optional<ServerRequestActionCode> findServerRequestAction(string_view action)
+	{ return tryStrToServerRequestActionCode(action); }
 }
 
 #endif // _CYVWS_SERVER_REQUEST_HPP_
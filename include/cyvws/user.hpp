@@ -17,15 +17,13 @@
 #ifndef _CYVWS_USER_HPP_
 #define _CYVWS_USER_HPP_
 
-#include <string>
-
 namespace cyvws
 {
 	namespace UserType
 	{
-		const std::string
-			PLAYER    = "player",
-			SPECTATOR = "spectator";
+		constexpr char
+			PLAYER[]    = "player",
+			SPECTATOR[] = "spectator";
 	}
 }
 
@@ -0,0 +1,106 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CYVWS_VERSIONED_GAMES_LIST_HPP_
+#define _CYVWS_VERSIONED_GAMES_LIST_HPP_
+
+#include <deque>
+#include <string>
+#include <cyvws/notification.hpp>
+
+namespace Json { class Value; }
+
+namespace cyvws
+{
+	/** A games list with a version number that is incremented on every change
+
+		Instead of sending the whole list after every change, the server
+		broadcasts the listDelta notifications returned by add(), modify()
+		and remove(). The full list (listUpdate with a version) is only sent
+		to new subscribers and to clients whose version is too old for the
+		changes that are still remembered, see getUpdate().
+
+		On the client, apply() keeps a copy of the list in sync. It returns
+		false for a delta that doesn't start at the local version, the client
+		then has to request the list again with subscrGameListUpdates.
+	 */
+	class VersionedGamesList
+	{
+		private:
+			enum class ChangeKind
+			{
+				ADDED,
+				MODIFIED,
+				REMOVED
+			};
+
+			struct Change
+			{
+				unsigned version;
+				ChangeKind kind;
+				std::string matchID;
+			};
+
+			std::string m_listName;
+			GamesListMap m_games;
+			unsigned m_version = 0;
+
+			std::deque<Change> m_history;
+			std::size_t m_historySize;
+
+			Json::Value recordChange(ChangeKind, const std::string& matchID);
+
+		public:
+			explicit VersionedGamesList(std::string listName, std::size_t historySize = 64);
+
+			const std::string& getListName() const
+			{ return m_listName; }
+
+			const GamesListMap& getGames() const
+			{ return m_games; }
+
+			unsigned getVersion() const
+			{ return m_version; }
+
+			// These throw std::invalid_argument if the match is already
+			// in the list (add) or not in the list (modify, remove).
+			// The return value is the listDelta notification to broadcast.
+			Json::Value add(const std::string& matchID, GamesListMappedType game);
+			Json::Value modify(const std::string& matchID, GamesListMappedType game);
+			Json::Value remove(const std::string& matchID);
+
+			/// A listUpdate notification with the full list and current version
+			Json::Value getSnapshot() const;
+
+			/** What a client that has the list at knownVersion needs
+
+				Returns one listDelta combining all changes since knownVersion
+				if they are still in the history, a snapshot otherwise and a
+				null value if the client is up to date.
+			 */
+			Json::Value getUpdate(unsigned knownVersion) const;
+
+			/** Apply the notificationData of a listUpdate or listDelta
+
+				Returns false if the notification is a delta that doesn't
+				fit the local version or is for a different list, the list
+				is left unchanged in that case.
+			 */
+			bool apply(const Json::Value& notificationData);
+	};
+}
+
+#endif // _CYVWS_VERSIONED_GAMES_LIST_HPP_
@@ -1,50 +1,117 @@
 #ifndef _ENUM_STR_HPP_
 #define _ENUM_STR_HPP_
 
-#include <initializer_list>
-#include <map>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
-#include <type_traits>
+#include <utility>
+#include <optional.hpp>
+#include <perfect_hash.hpp>
+#include <string_view.hpp>
 
-template <typename T>
-using initMap = std::initializer_list<std::pair<const T, std::string>>;
+/** Constexpr two-way mapping between enum values and strings
 
-template <typename EnumT>
-std::map<std::string, const EnumT> swapFirstSecond(initMap<EnumT> orig)
+	The enum values have to be the integers 0 to N - 1 (in any order),
+	so the strings can be looked up by value. String to enum lookup goes
+	through a PerfectHash. Neither direction allocates.
+ */
+template <typename EnumT, std::size_t N>
+class EnumStrTable
 {
-	std::map<std::string, const EnumT> ret;
-	for(const std::pair<const EnumT, std::string>& it : orig)
-		ret.emplace(it.second, it.first);
+	private:
+		std::array<string_view, N> m_strs;
+		PerfectHash<uint8_t, N> m_hash;
 
-	return ret;
-}
+		static constexpr std::array<string_view, N> makeStrs(const std::pair<EnumT, string_view> (&init)[N])
+		{
+			std::array<string_view, N> strs {};
+
+			for (std::size_t i = 0; i < N; i++)
+			{
+				auto index = static_cast<std::size_t>(init[i].first);
+				if (index >= N || !strs[index].empty())
+					throw std::logic_error("EnumStrTable: enum values have to be 0 to N - 1 and unique");
+
+				strs[index] = init[i].second;
+			}
+
+			return strs;
+		}
+
+		static constexpr std::array<uint8_t, N> makeIndices()
+		{
+			std::array<uint8_t, N> indices {};
+			for (std::size_t i = 0; i < N; i++)
+				indices[i] = static_cast<uint8_t>(i);
+
+			return indices;
+		}
+
+	public:
+		constexpr EnumStrTable(const std::pair<EnumT, string_view> (&init)[N])
+			: m_strs(makeStrs(init))
+			, m_hash(m_strs, makeIndices())
+		{ }
+
+		constexpr optional<string_view> getStr(EnumT e) const
+		{
+			auto index = static_cast<std::size_t>(e);
+			if (index >= N)
+				return nullopt;
+
+			return m_strs[index];
+		}
+
+		constexpr optional<EnumT> getEnum(string_view str) const
+		{
+			auto index = m_hash.find(str);
+			if (!index)
+				return nullopt;
+
+			return static_cast<EnumT>(*index);
+		}
+
+		constexpr std::size_t size() const
+		{ return N; }
+};
+
+template <typename EnumT, std::size_t N>
+constexpr EnumStrTable<EnumT, N> makeEnumStrTable(const std::pair<EnumT, string_view> (&init)[N])
+{ return EnumStrTable<EnumT, N>(init); }
+
+#define ENUM_STR_UNPAREN(...) __VA_ARGS__
 
 #define ENUM_STR_PROT(type) \
-	std::string type ## ToStr(type e); \
-	type StrTo ## type(const std::string& s);
+	constexpr string_view type ## ToStr(type e); \
+	constexpr type StrTo ## type(string_view s); \
+	constexpr optional<type> tryStrTo ## type(string_view s);
 
+/* Defines type ## ToStr(), StrTo ## type() (which both throw
+   std::invalid_argument for unknown values) and tryStrTo ## type().
+   The strings returned by type ## ToStr() are the string literals
+   from init, so they are null-terminated.
+ */
 #define ENUM_STR(type, init) \
-	inline std::string type ## ToStr(type e) \
+	inline constexpr std::pair< type , string_view> type ## StrPairs[] = ENUM_STR_UNPAREN init; \
+	inline constexpr auto type ## StrTable = makeEnumStrTable(type ## StrPairs); \
+	\
+	constexpr string_view type ## ToStr(type e) \
 	{ \
-		static std::map< type , std::string> data(initMap< type > init); \
-		\
-		auto it = data.find(e); \
-		if(it == data.end()) \
-			throw std::invalid_argument("Invalid " #type ": " + std::to_string(static_cast<int>(e))); \
-		\
-		return it->second; \
-	}\
+		return type ## StrTable.getStr(e) \
+			? *type ## StrTable.getStr(e) \
+			: throw std::invalid_argument("Invalid " #type ": " + std::to_string(static_cast<int>(e))); \
+	} \
 	\
-	inline type StrTo ## type(const std::string& s) \
+	constexpr type StrTo ## type(string_view s) \
 	{ \
-		static std::map<std::string, const type > data(swapFirstSecond(initMap< type > init)); \
-		\
-		auto it = data.find(s); \
-		if(it == data.end()) \
-			throw std::invalid_argument("Invalid " #type ": " + s); \
-		\
-		return it->second; \
-	}
+		return type ## StrTable.getEnum(s) \
+			? *type ## StrTable.getEnum(s) \
+			: throw std::invalid_argument("Invalid " #type ": " + std::string(s)); \
+	} \
+	\
+	constexpr optional<type> tryStrTo ## type(string_view s) \
+	{ return type ## StrTable.getEnum(s); }
 
 #endif // _ENUM_STR_HPP_
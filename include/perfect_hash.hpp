@@ -0,0 +1,155 @@
+#ifndef _PERFECT_HASH_HPP_
+#define _PERFECT_HASH_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <optional.hpp>
+#include <string_view.hpp>
+
+/** Compile-time perfect hash from a fixed set of strings to values
+
+	The constructor searches for a seed with which the hashes of all keys
+	land in distinct slots of a table with at least twice as many slots as
+	there are keys. A cheap hash of the length and three characters is
+	tried first, FNV-1a over the whole string if no seed works with that.
+	A lookup then costs one hash calculation and at most one string
+	comparison.
+
+	Construct it as a constexpr variable so the seed search runs at compile
+	time, preferably through makePerfectHash():
+
+	constexpr std::pair<string_view, Foo> fooStrings[] = {...};
+	constexpr auto fooHash = makePerfectHash(fooStrings);
+ */
+template <typename T, std::size_t N>
+class PerfectHash
+{
+	static_assert(N > 0 && N < 0xff, "PerfectHash supports 1 to 254 keys");
+
+	private:
+		static constexpr std::size_t getTableSize()
+		{
+			std::size_t size = 1;
+			while (size < N * 2)
+				size *= 2;
+
+			return size;
+		}
+
+		static constexpr std::size_t tableSize = getTableSize();
+		static constexpr uint8_t emptySlot = 0xff;
+
+		std::array<string_view, N> m_keys {};
+		std::array<T, N> m_values {};
+		std::array<uint8_t, tableSize> m_slots {};
+		uint32_t m_seed = 0;
+		bool m_fullHash = false;
+
+		static constexpr uint32_t mix(uint32_t h, uint32_t seed)
+		{ return ((h ^ seed) * 0x9e3779b1u) >> 16; }
+
+		// only looks at the length and three characters, the key
+		// comparison in find() rejects strings that merely collide
+		static constexpr uint32_t sampledHash(string_view str, uint32_t seed)
+		{
+			auto len = static_cast<uint32_t>(str.size());
+			if (len == 0)
+				return mix(0, seed);
+
+			return mix(len
+				^ (static_cast<uint32_t>(static_cast<uint8_t>(str[0])) << 8)
+				^ (static_cast<uint32_t>(static_cast<uint8_t>(str[len / 2])) << 16)
+				^ (static_cast<uint32_t>(static_cast<uint8_t>(str[len - 1])) << 24), seed);
+		}
+
+		// FNV-1a, for key sets the sampled hash can't tell apart
+		static constexpr uint32_t fullHash(string_view str, uint32_t seed)
+		{
+			uint32_t h = 2166136261u;
+			for (char c : str)
+			{
+				h ^= static_cast<uint8_t>(c);
+				h *= 16777619u;
+			}
+
+			return mix(h, seed);
+		}
+
+		constexpr uint32_t hash(string_view str) const
+		{ return m_fullHash ? fullHash(str, m_seed) : sampledHash(str, m_seed); }
+
+		constexpr bool trySeed(uint32_t seed, bool full)
+		{
+			for (auto& slot : m_slots)
+				slot = emptySlot;
+
+			for (std::size_t i = 0; i < N; i++)
+			{
+				auto h = full ? fullHash(m_keys[i], seed) : sampledHash(m_keys[i], seed);
+
+				auto& slot = m_slots[h & (tableSize - 1)];
+				if (slot != emptySlot)
+					return false;
+
+				slot = static_cast<uint8_t>(i);
+			}
+
+			m_seed = seed;
+			m_fullHash = full;
+			return true;
+		}
+
+		constexpr void findSeed()
+		{
+			for (uint32_t seed = 0; seed < 0x100; seed++)
+				if (trySeed(seed, false))
+					return;
+
+			for (uint32_t seed = 0; seed < 0x1000; seed++)
+				if (trySeed(seed, true))
+					return;
+
+			// only happens for duplicate keys
+			throw std::logic_error("PerfectHash: no seed found, are there duplicate keys?");
+		}
+
+	public:
+		constexpr PerfectHash(const std::pair<string_view, T> (&entries)[N])
+		{
+			for (std::size_t i = 0; i < N; i++)
+			{
+				m_keys[i]   = entries[i].first;
+				m_values[i] = entries[i].second;
+			}
+
+			findSeed();
+		}
+
+		constexpr PerfectHash(const std::array<string_view, N>& keys, const std::array<T, N>& values)
+			: m_keys(keys)
+			, m_values(values)
+		{
+			findSeed();
+		}
+
+		constexpr optional<T> find(string_view str) const
+		{
+			auto index = m_slots[hash(str) & (tableSize - 1)];
+			if (index == emptySlot || m_keys[index] != str)
+				return nullopt;
+
+			return m_values[index];
+		}
+
+		constexpr std::size_t size() const
+		{ return N; }
+};
+
+template <typename T, std::size_t N>
+constexpr PerfectHash<T, N> makePerfectHash(const std::pair<string_view, T> (&entries)[N])
+{ return PerfectHash<T, N>(entries); }
+
+#endif // _PERFECT_HASH_HPP_
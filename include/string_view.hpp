@@ -0,0 +1,13 @@
+#ifndef __has_include
+	#error No feature testing macro support
+#endif
+
+#if __has_include(<string_view>)
+	#include <string_view>
+	using std::string_view;
+#elif __has_include(<experimental/string_view>)
+	#include <experimental/string_view>
+	using std::experimental::string_view;
+#else
+	#error No string_view support
+#endif
@@ -22,31 +22,20 @@ using namespace std;
 
 namespace cyvasse
 {
-	bool BearingTable::canTake(const Piece& atkPiece, const Piece& defPiece) const
+	auto BearingTable::getAttackTier(const Piece& atkPiece, const PieceVec& reachingPieces) -> uint8_t
 	{
-		assert(defPiece.getType() != PieceType::MOUNTAINS);
-
-		uint8_t defenseTier = defPiece.getEffectiveDefenseTier();
-
-		if (atkPiece.getBaseTier() >= defenseTier)
-			return true;
-
 		bool haveKing = (atkPiece.getType() == PieceType::KING);
 
 		uint8_t maxAllowedTier = haveKing ? 3 : atkPiece.getBaseTier();
 		uint8_t maxTier = 1;
 
-		auto defPieceIt = m_canBeReachedBy.find(defPiece);
-		if (defPieceIt == m_canBeReachedBy.end())
-			return false;
-
 		map<uint8_t, uint8_t> flankingTiers {
 			{1, 0},
 			{2, 0},
 			{3, 0}
 		};
 
-		for (auto&& piece : defPieceIt->second)
+		for (auto&& piece : reachingPieces)
 		{
 			auto baseTier = piece.get().getBaseTier();
 
@@ -72,17 +61,31 @@ namespace cyvasse
 		for (uint8_t i = 1; i < maxTier; ++i)
 			flankingTiers[i+1] += (flankingTiers[i] > 0 ? flankingTiers[i] - 1 : 0);
 
-		uint8_t attackTier = maxTier + flankingTiers[maxTier] - 1;
+		return maxTier + flankingTiers[maxTier] - 1;
+	}
+
+	bool BearingTable::canTake(const Piece& atkPiece, const Piece& defPiece) const
+	{
+		assert(defPiece.getType() != PieceType::MOUNTAINS);
+
+		uint8_t defenseTier = defPiece.getEffectiveDefenseTier();
+
+		if (atkPiece.getBaseTier() >= defenseTier)
+			return true;
+
+		auto defPieceIt = m_canBeReachedBy.find(defPiece);
+		if (defPieceIt == m_canBeReachedBy.end())
+			return false;
 
-		return attackTier >= defenseTier;
+		return getAttackTier(atkPiece, defPieceIt->second) >= defenseTier;
 	}
 
 	void BearingTable::init()
 	{
-		for (auto it : m_pieceMap)
+		for (const auto& it : m_pieceMap)
 		{
 			assert(it.second);
-			auto piece = *it.second;
+			const Piece& piece = *it.second;
 
 			if (piece.getType() == PieceType::MOUNTAINS || piece.getType() == PieceType::DRAGON)
 				continue;
@@ -97,7 +100,7 @@ namespace cyvasse
 				auto opPieceIt = m_canBeReachedBy.find(opPiece);
 				if (opPieceIt == m_canBeReachedBy.end())
 				{
-					auto res = m_canBeReachedBy.emplace(opPiece, vector<reference_wrapper<const Piece>>{piece});
+					auto res = m_canBeReachedBy.emplace(opPiece, PieceVec{piece});
 					assert(res.second);
 				}
 				else
@@ -0,0 +1,238 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvasse/evaluator.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cyvasse/exchange.hpp>
+#include <cyvasse/fortress.hpp>
+#include <cyvasse/match.hpp>
+
+using namespace std;
+
+namespace cyvasse
+{
+	static const vector<PieceType> allPieceTypes {
+		PieceType::MOUNTAINS,
+		PieceType::RABBLE,
+		PieceType::CROSSBOWS,
+		PieceType::SPEARS,
+		PieceType::LIGHT_HORSE,
+		PieceType::TREBUCHET,
+		PieceType::ELEPHANT,
+		PieceType::HEAVY_HORSE,
+		PieceType::DRAGON,
+		PieceType::KING
+	};
+
+	static string trim(const string& str)
+	{
+		auto begin = str.find_first_not_of(" \t\r");
+		if (begin == string::npos)
+			return {};
+
+		return str.substr(begin, str.find_last_not_of(" \t\r") - begin + 1);
+	}
+
+	EvalWeights EvalWeights::defaults()
+	{
+		EvalWeights weights;
+
+		for (auto type : allPieceTypes)
+		{
+			weights.material[size_t(type)] = getExchangeValue(type) * 100;
+			weights.pieceSquare[size_t(type)].fill(0);
+		}
+
+		weights.homeTerrain    = 20;
+		weights.fortress       = 50;
+		weights.kingInFortress = 30;
+		weights.kingDistance   = -5;
+
+		return weights;
+	}
+
+	EvalWeights EvalWeights::read(istream& is)
+	{
+		EvalWeights weights = defaults();
+
+		const map<string, int*> scalars {
+			{"homeTerrain",    &weights.homeTerrain},
+			{"fortress",       &weights.fortress},
+			{"kingInFortress", &weights.kingInFortress},
+			{"kingDistance",   &weights.kingDistance}
+		};
+
+		string line;
+		for (unsigned lineNr = 1; getline(is, line); lineNr++)
+		{
+			auto errPrefix = "EvalWeights: line " + to_string(lineNr) + ": ";
+
+			line = trim(line.substr(0, line.find('#')));
+			if (line.empty())
+				continue;
+
+			auto eqPos = line.find('=');
+			if (eqPos == string::npos)
+				throw runtime_error(errPrefix + "missing '='");
+
+			auto lhs = trim(line.substr(0, eqPos));
+			auto termEnd = lhs.find_first_of(" \t");
+			auto term = lhs.substr(0, termEnd);
+			auto pieceTypeStr = (termEnd == string::npos) ? string() : trim(lhs.substr(termEnd));
+
+			istringstream values(line.substr(eqPos + 1));
+			auto readValue = [&] {
+				int value;
+				if (!(values >> value))
+					throw runtime_error(errPrefix + "expected a number");
+
+				return value;
+			};
+
+			if (term == "material" || term == "pieceSquare")
+			{
+				PieceType type;
+				try
+				{
+					type = StrToPieceType(pieceTypeStr);
+				}
+				catch (invalid_argument&)
+				{
+					throw runtime_error(errPrefix + "invalid piece type '" + pieceTypeStr + "'");
+				}
+
+				if (term == "material")
+					weights.material[size_t(type)] = readValue();
+				else
+					for (auto& value : weights.pieceSquare[size_t(type)])
+						value = readValue();
+			}
+			else
+			{
+				auto it = scalars.find(term);
+				if (it == scalars.end())
+					throw runtime_error(errPrefix + "unknown term '" + term + "'");
+
+				*it->second = readValue();
+			}
+
+			string rest;
+			if (values >> rest)
+				throw runtime_error(errPrefix + "too many values");
+		}
+
+		return weights;
+	}
+
+	EvalWeights EvalWeights::readFile(const string& path)
+	{
+		ifstream file(path);
+		if (!file)
+			throw runtime_error("EvalWeights: can't open " + path);
+
+		return read(file);
+	}
+
+	void EvalWeights::write(ostream& os) const
+	{
+		for (auto type : allPieceTypes)
+			os << "material " << PieceTypeToStr(type) << " = " << material[size_t(type)] << '\n';
+
+		for (auto type : allPieceTypes)
+		{
+			os << "pieceSquare " << PieceTypeToStr(type) << " =";
+			for (auto value : pieceSquare[size_t(type)])
+				os << ' ' << value;
+			os << '\n';
+		}
+
+		os << "homeTerrain = "    << homeTerrain    << '\n'
+		   << "fortress = "       << fortress       << '\n'
+		   << "kingInFortress = " << kingInFortress << '\n'
+		   << "kingDistance = "   << kingDistance   << '\n';
+	}
+
+	int Evaluator::getPieceScore(PieceType type, PlayersColor color, HexCoordinate<6> coord) const
+	{
+		const auto& weights = *m_weights;
+		auto index = Hexagon<6>::getIndex(coord);
+
+		// the board is point symmetric, mirroring a
+		// tile through the center reverses the index
+		auto pstIndex = (color == PlayersColor::WHITE) ? index : Hexagon<6>::tileCount - 1 - index;
+
+		int score = weights.material[size_t(type)] + weights.pieceSquare[size_t(type)][pstIndex];
+
+		if (m_terrain[index] && m_terrain[index] == Piece::getHomeTerrain(type))
+			score += weights.homeTerrain;
+
+		const auto& fortressCoord = m_fortressCoords[color];
+		if (type == PieceType::KING && fortressCoord)
+		{
+			if (coord == *fortressCoord)
+				score += weights.kingInFortress;
+
+			score += weights.kingDistance * coord.getDistance(*fortressCoord);
+		}
+
+		return (color == PlayersColor::WHITE) ? score : -score;
+	}
+
+	void Evaluator::init(Match& match)
+	{
+		m_score = 0;
+
+		m_terrain.fill(nullopt);
+		for (const auto& it : match.getTerrain())
+			m_terrain[Hexagon<6>::getIndex(it.first)] = it.second->getType();
+
+		for (auto color : allPlayersColors)
+		{
+			auto& fortress = match.getPlayer(color).getFortress();
+			m_fortressCoords[color] = fortress.getCoord();
+
+			if (!fortress.isRuined)
+				m_score += (color == PlayersColor::WHITE) ? m_weights->fortress : -m_weights->fortress;
+		}
+
+		for (const auto& it : match.getActivePieces())
+			m_score += getPieceScore(it.second->getType(), it.second->getColor(), it.first);
+	}
+
+	void Evaluator::pieceAdded(PieceType type, PlayersColor color, HexCoordinate<6> coord)
+	{
+		m_score += getPieceScore(type, color, coord);
+	}
+
+	void Evaluator::pieceRemoved(PieceType type, PlayersColor color, HexCoordinate<6> coord)
+	{
+		m_score -= getPieceScore(type, color, coord);
+	}
+
+	void Evaluator::pieceMoved(PieceType type, PlayersColor color, HexCoordinate<6> from, HexCoordinate<6> to)
+	{
+		m_score += getPieceScore(type, color, to) - getPieceScore(type, color, from);
+	}
+
+	void Evaluator::fortressRuined(PlayersColor color, bool ruined)
+	{
+		int diff = (color == PlayersColor::WHITE) ? m_weights->fortress : -m_weights->fortress;
+		m_score += ruined ? -diff : diff;
+	}
+}
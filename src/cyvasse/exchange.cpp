@@ -0,0 +1,136 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvasse/exchange.hpp>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <cyvasse/match.hpp>
+
+using namespace std;
+
+namespace cyvasse
+{
+	int getExchangeValue(PieceType type)
+	{
+		static const map<PieceType, int> data {
+			{PieceType::RABBLE,      1},
+			{PieceType::CROSSBOWS,   2},
+			{PieceType::SPEARS,      2},
+			{PieceType::LIGHT_HORSE, 2},
+			{PieceType::TREBUCHET,   3},
+			{PieceType::ELEPHANT,    3},
+			{PieceType::HEAVY_HORSE, 3},
+			{PieceType::DRAGON,      4},
+			{PieceType::KING,        5}
+		};
+
+		auto it = data.find(type);
+		if (it == data.end())
+			return 0;
+
+		return it->second;
+	}
+
+	int staticExchangeEval(Match& match, HexCoordinate<6> target)
+	{
+		auto occupant = match.getPieceAt(target);
+		if (!occupant || occupant->get().getType() == PieceType::MOUNTAINS)
+			return 0;
+
+		// all pieces that could move to target, per color, least valuable first
+		array<BearingTable::PieceVec, 2> attackers;
+
+		for (const auto& it : match.getActivePieces())
+		{
+			const Piece& piece = *it.second;
+
+			if (&piece == &occupant->get() || piece.getType() == PieceType::MOUNTAINS)
+				continue;
+
+			if (piece.canReach(target))
+				attackers[piece.getColor()].push_back(piece);
+		}
+
+		for (auto& vec : attackers)
+		{
+			stable_sort(vec.begin(), vec.end(), [](const Piece& lhs, const Piece& rhs) {
+				return getExchangeValue(lhs.getType()) < getExchangeValue(rhs.getType());
+			});
+		}
+
+		// dragons don't take part in flanking
+		auto getFlankingPieces = [](const BearingTable::PieceVec& pieces) {
+			BearingTable::PieceVec ret;
+			for (const Piece& piece : pieces)
+				if (piece.getType() != PieceType::DRAGON)
+					ret.push_back(piece);
+
+			return ret;
+		};
+
+		// gain[d] is the material balance after the d-th capture,
+		// from the point of view of the side that made it
+		vector<int> gain;
+		const Piece* onTarget = &occupant->get();
+		PlayersColor side = !onTarget->getColor();
+
+		while (true)
+		{
+			auto& sideAttackers = attackers[side];
+			auto defenseTier = onTarget->getEffectiveDefenseTier(target);
+			auto flankingPieces = getFlankingPieces(sideAttackers);
+
+			auto atkIt = find_if(sideAttackers.begin(), sideAttackers.end(), [&](const Piece& piece) {
+				return piece.getBaseTier() >= defenseTier ||
+					BearingTable::getAttackTier(piece, flankingPieces) >= defenseTier;
+			});
+
+			if (atkIt == sideAttackers.end())
+				break;
+
+			auto capturedValue = getExchangeValue(onTarget->getType());
+			gain.push_back(gain.empty() ? capturedValue : capturedValue - gain.back());
+
+			// taking the king ends the exchange
+			if (onTarget->getType() == PieceType::KING)
+				break;
+
+			onTarget = &atkIt->get();
+			sideAttackers.erase(atkIt);
+			side = !side;
+		}
+
+		if (gain.empty())
+			return 0;
+
+		// every side only continues the exchange if that doesn't lose material
+		for (auto d = gain.size() - 1; d > 0; d--)
+			gain[d - 1] = -max(-gain[d - 1], gain[d]);
+
+		return gain[0];
+	}
+
+	bool isHanging(Match& match, const Piece& piece)
+	{
+		auto coord = piece.getCoord();
+		if (!coord)
+			return false;
+
+		return staticExchangeEval(match, *coord) > 0;
+	}
+}
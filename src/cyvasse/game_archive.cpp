@@ -0,0 +1,206 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvasse/game_archive.hpp>
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace cyvasse
+{
+	static constexpr char magic[] = {'C', 'Y', 'V', 'A'};
+
+	static constexpr size_t headerSize = sizeof(magic) + 1;
+	static constexpr size_t footerSize = 8 + 8 + sizeof(magic);
+
+	static void putUint64(string& buf, uint64_t val)
+	{
+		for (auto i = 0; i < 8; i++)
+			buf += static_cast<char>(val >> (i * 8));
+	}
+
+	static uint64_t getUint64(const char* data)
+	{
+		uint64_t ret = 0;
+		for (auto i = 0; i < 8; i++)
+			ret |= uint64_t(static_cast<uint8_t>(data[i])) << (i * 8);
+
+		return ret;
+	}
+
+	static runtime_error archiveError(const string& path, const string& what)
+	{
+		return runtime_error("Game archive " + path + ": " + what);
+	}
+
+	GameArchiveWriter::GameArchiveWriter(const string& path)
+		: m_file(path, ios::binary | ios::trunc)
+	{
+		if (!m_file)
+			throw archiveError(path, "can't open the file for writing");
+
+		m_file.write(magic, sizeof(magic));
+		m_file.put(static_cast<char>(gameArchiveVersion));
+		m_pos = headerSize;
+	}
+
+	GameArchiveWriter::~GameArchiveWriter()
+	{
+		if (m_finished)
+			return;
+
+		try
+		{
+			finish();
+		}
+		catch (exception&) { }
+	}
+
+	void GameArchiveWriter::add(string_view record)
+	{
+		assert(!m_finished);
+
+		m_offsets.push_back(m_pos);
+		m_file.write(record.data(), record.size());
+		m_pos += record.size();
+	}
+
+	void GameArchiveWriter::finish()
+	{
+		assert(!m_finished);
+		m_finished = true;
+
+		string index;
+		index.reserve(m_offsets.size() * 8 + footerSize);
+
+		for (auto offset : m_offsets)
+			putUint64(index, offset);
+
+		putUint64(index, m_pos);
+		putUint64(index, m_offsets.size());
+		index.append(magic, sizeof(magic));
+
+		m_file.write(index.data(), index.size());
+		m_file.close();
+
+		if (!m_file)
+			throw runtime_error("Writing the game archive failed");
+	}
+
+	GameArchive::GameArchive(const string& path)
+	{
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd == -1)
+			throw archiveError(path, strerror(errno));
+
+		struct stat st;
+		if (fstat(fd, &st) == -1)
+		{
+			auto err = errno;
+			close(fd);
+			throw archiveError(path, strerror(err));
+		}
+
+		m_byteSize = static_cast<size_t>(st.st_size);
+		if (m_byteSize < headerSize + footerSize)
+		{
+			close(fd);
+			throw archiveError(path, "file too small");
+		}
+
+		void* data = mmap(nullptr, m_byteSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		auto err = errno;
+		close(fd);
+
+		if (data == MAP_FAILED)
+			throw archiveError(path, strerror(err));
+
+		m_data = static_cast<const char*>(data);
+
+		try
+		{
+			auto footer = m_data + m_byteSize - footerSize;
+
+			if (memcmp(m_data, magic, sizeof(magic)) != 0 || memcmp(footer + 16, magic, sizeof(magic)) != 0)
+				throw archiveError(path, "wrong magic bytes");
+
+			if (static_cast<uint8_t>(m_data[sizeof(magic)]) != gameArchiveVersion)
+				throw archiveError(path, "unsupported version " + to_string(static_cast<uint8_t>(m_data[sizeof(magic)])));
+
+			m_indexOffset = getUint64(footer);
+			auto count = getUint64(footer + 8);
+
+			if (m_indexOffset < headerSize || m_indexOffset > m_byteSize - footerSize)
+				throw archiveError(path, "invalid index offset");
+
+			auto indexSize = m_byteSize - footerSize - m_indexOffset;
+			if (indexSize % 8 != 0 || indexSize / 8 != count)
+				throw archiveError(path, "index size doesn't match the record count");
+
+			m_index = m_data + m_indexOffset;
+			m_size = static_cast<size_t>(count);
+
+			// offsets have to be ascending, so getRecord() can't fail
+			uint64_t last = headerSize;
+			for (size_t i = 0; i < m_size; i++)
+			{
+				auto offset = getOffset(i);
+				if (offset < last || offset > m_indexOffset)
+					throw archiveError(path, "invalid offset of record " + to_string(i));
+
+				last = offset;
+			}
+		}
+		catch (...)
+		{
+			munmap(const_cast<char*>(m_data), m_byteSize);
+			throw;
+		}
+
+#ifdef __linux__
+		// archives are usually read completely, start paging the file in now
+		madvise(const_cast<char*>(m_data), m_byteSize, MADV_WILLNEED);
+#endif
+	}
+
+	GameArchive::~GameArchive()
+	{
+		munmap(const_cast<char*>(m_data), m_byteSize);
+	}
+
+	uint64_t GameArchive::getOffset(size_t i) const
+	{
+		return getUint64(m_index + i * 8);
+	}
+
+	string_view GameArchive::getRecord(size_t i) const
+	{
+		assert(i < m_size);
+
+		auto begin = getOffset(i);
+		auto end = (i + 1 < m_size) ? getOffset(i + 1) : m_indexOffset;
+
+		return string_view(m_data + begin, end - begin);
+	}
+}
@@ -0,0 +1,354 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvasse/game_record.hpp>
+
+#include <memory>
+#include <cyvasse/fortress.hpp>
+#include <cyvasse/hexagon.hpp>
+#include <cyvasse/match.hpp>
+#include <cyvasse/piece.hpp>
+#include <cyvasse/player.hpp>
+#include <cyvasse/terrain.hpp>
+
+using namespace std;
+
+namespace cyvasse
+{
+	static constexpr char magic[] = {'C', 'Y', 'V', 'R'};
+
+	static constexpr uint8_t flagRandom  = 0x01;
+	static constexpr uint8_t flagPublic  = 0x02;
+
+	// tile indices are below 0x80, so the high bit marks the other events
+	static constexpr uint8_t captureFlag  = 0x80;
+	static constexpr uint8_t promotionTag = 0x80;
+	static constexpr uint8_t endTag       = 0xff;
+
+	static_assert(Hexagon<6>::tileCount <= 0x80, "tile indices have to fit into 7 bits");
+	static_assert(pieceTypeCount <= endTag - promotionTag, "promotion tags must not overlap the end tag");
+
+	static uint8_t tileIndex(HexCoordinate<6> coord)
+	{ return static_cast<uint8_t>(Hexagon<6>::getIndex(coord)); }
+
+	GameRecordWriter::GameRecordWriter(const Match& match)
+		: m_match(match)
+	{ }
+
+	void GameRecordWriter::byte(uint8_t val)
+	{
+		m_record += static_cast<char>(val);
+	}
+
+	void GameRecordWriter::str(const string& val)
+	{
+		if (val.size() > 0xff)
+			throw invalid_argument("Strings in game records can't be longer than 255 bytes");
+
+		byte(static_cast<uint8_t>(val.size()));
+		m_record += val;
+	}
+
+	void GameRecordWriter::start(const string& ruleSet)
+	{
+		if (m_started)
+			throw logic_error("GameRecordWriter::start() called twice");
+
+		array<OpeningArray, 2> openings;
+		for (const auto& it : m_match.getActivePieces())
+			openings[it.second->getColor()][it.second->getType()].insert(it.first);
+
+		m_record.append(magic, sizeof(magic));
+		byte(gameRecordVersion);
+		str(m_match.getID());
+		str(ruleSet);
+		byte((m_match.isRandom() ? flagRandom : 0) | (m_match.isPublic() ? flagPublic : 0));
+
+		for (const auto& opening : openings)
+		{
+			for (size_t type = 0; type < pieceTypeCount; type++)
+			{
+				auto it = opening.find(static_cast<PieceType>(type));
+				if (it == opening.end())
+				{
+					byte(0);
+					continue;
+				}
+
+				byte(static_cast<uint8_t>(it->second.size()));
+				for (auto coord : it->second)
+					byte(tileIndex(coord));
+			}
+		}
+
+		m_started = true;
+	}
+
+	void GameRecordWriter::removeFromBoard(const Piece& piece)
+	{
+		if (m_started)
+			m_capturedType = piece.getType();
+	}
+
+	void GameRecordWriter::pieceMoved(const Piece& piece, optional<HexCoordinate<6>> oldCoord)
+	{
+		if (!m_started || m_ended)
+			return;
+
+		assert(oldCoord);
+
+		byte(tileIndex(*oldCoord));
+
+		if (m_capturedType)
+		{
+			byte(tileIndex(*piece.getCoord()) | captureFlag);
+			byte(static_cast<uint8_t>(*m_capturedType));
+			m_capturedType = nullopt;
+		}
+		else
+			byte(tileIndex(*piece.getCoord()));
+	}
+
+	void GameRecordWriter::piecePromoted(const Piece& piece, PieceType)
+	{
+		// the promoted piece was passed to removeFromBoard()
+		m_capturedType = nullopt;
+
+		if (!m_started || m_ended)
+			return;
+
+		byte(promotionTag | static_cast<uint8_t>(piece.getType()));
+		byte(tileIndex(*piece.getCoord()));
+	}
+
+	void GameRecordWriter::endGame(PlayersColor winner)
+	{
+		// Player::onTurnEnd() may report the end more than once
+		if (!m_started || m_ended)
+			return;
+
+		byte(endTag);
+		byte(winner);
+		m_ended = true;
+	}
+
+	GameRecordReader::GameRecordReader(string_view record)
+		: m_record(record)
+	{
+		if (m_record.substr(0, sizeof(magic)) != string_view(magic, sizeof(magic)))
+			throw GameRecordError("wrong magic bytes");
+
+		m_pos = sizeof(magic);
+
+		auto version = byte();
+		if (version != gameRecordVersion)
+			throw GameRecordError("unsupported version " + to_string(version));
+
+		m_header.matchID = str();
+		m_header.ruleSet = str();
+
+		auto flags = byte();
+		m_header.random  = flags & flagRandom;
+		m_header._public = flags & flagPublic;
+
+		for (auto& opening : m_header.openings)
+		{
+			for (size_t type = 0; type < pieceTypeCount; type++)
+			{
+				auto count = byte();
+				if (!count)
+					continue;
+
+				auto& coords = opening[static_cast<PieceType>(type)];
+				for (auto i = 0; i < count; i++)
+					coords.insert(coord());
+			}
+		}
+	}
+
+	uint8_t GameRecordReader::byte()
+	{
+		if (m_pos >= m_record.size())
+			throw GameRecordError("truncated");
+
+		return static_cast<uint8_t>(m_record[m_pos++]);
+	}
+
+	string GameRecordReader::str()
+	{
+		auto len = byte();
+		if (m_record.size() - m_pos < len)
+			throw GameRecordError("truncated");
+
+		string ret(m_record.substr(m_pos, len));
+		m_pos += len;
+
+		return ret;
+	}
+
+	HexCoordinate<6> GameRecordReader::coord()
+	{
+		return coord(byte());
+	}
+
+	HexCoordinate<6> GameRecordReader::coord(uint8_t index)
+	{
+		if (index >= Hexagon<6>::tileCount)
+			throw GameRecordError("invalid tile index " + to_string(index));
+
+		return Hexagon<6>::getCoordinate(index);
+	}
+
+	PieceType GameRecordReader::pieceType(uint8_t val)
+	{
+		if (val >= pieceTypeCount)
+			throw GameRecordError("invalid piece type " + to_string(val));
+
+		return static_cast<PieceType>(val);
+	}
+
+	auto GameRecordReader::next() -> optional<GameRecordEvent>
+	{
+		// for the coordinates that aren't used by an event
+		static constexpr HexCoordinate<6> unusedCoord(0, 5);
+
+		if (m_ended || m_pos == m_record.size())
+			return nullopt;
+
+		auto first = byte();
+
+		if (first == endTag)
+		{
+			auto winner = byte();
+			if (winner > 1)
+				throw GameRecordError("invalid winner " + to_string(winner));
+
+			m_ended = true;
+			return GameRecordEvent {GameRecordEventKind::END, unusedCoord, unusedCoord, PieceType::KING, PlayersColor(winner)};
+		}
+
+		if (first & promotionTag)
+		{
+			auto type = pieceType(first & ~promotionTag);
+			return GameRecordEvent {GameRecordEventKind::PROMOTION, unusedCoord, coord(), type, m_turn};
+		}
+
+		auto from = coord(first);
+		auto second = byte();
+
+		if (second & captureFlag)
+		{
+			auto to = coord(second & ~captureFlag);
+			return GameRecordEvent {GameRecordEventKind::CAPTURE, from, to, pieceType(byte()), m_turn};
+		}
+
+		return GameRecordEvent {GameRecordEventKind::MOVE, from, coord(second), PieceType::KING, m_turn};
+	}
+
+	void GameRecordReader::setUp(Match& match) const
+	{
+		for (auto color : allPlayersColors)
+		{
+			const auto& opening = m_header.openings[color];
+
+			auto kingIt = opening.find(PieceType::KING);
+			if (kingIt == opening.end() || kingIt->second.size() != 1)
+				throw GameRecordError("there has to be exactly one king per player");
+
+			auto fortressCoord = *kingIt->second.begin();
+
+			if (match.hasPlayer(color))
+				match.getPlayer(color).getFortress().setCoord(fortressCoord);
+			else
+			{
+				match.setPlayer(color, unique_ptr<Player>(new Player(match, color,
+					unique_ptr<Fortress>(new Fortress(color, fortressCoord))
+				)));
+			}
+
+			auto& player = match.getPlayer(color);
+
+			for (const auto& it : opening)
+			{
+				for (auto coord : it.second)
+				{
+					if (match.getPieceAt(coord))
+						throw GameRecordError("two pieces on " + coord.toString());
+
+					auto piece = make_shared<Piece>(color, it.first, nullopt, match);
+					player.getInactivePieces().emplace(it.first, piece);
+					match.addToBoard(it.first, color, coord);
+
+					auto terrainType = piece->getSetupTerrain();
+					if (terrainType)
+						match.getTerrain().emplace(coord, make_shared<Terrain>(*terrainType, coord));
+				}
+			}
+
+			player.setupDone();
+		}
+
+		match.setupDone();
+		match.getBearingTable().init();
+	}
+
+	bool GameRecordReader::apply(Match& match, const GameRecordEvent& event)
+	{
+		switch (event.kind)
+		{
+			case GameRecordEventKind::MOVE:
+			case GameRecordEventKind::CAPTURE:
+			{
+				auto piece = match.getPieceAt(event.from);
+				if (!piece || piece->get().getColor() != m_turn)
+					return false;
+
+				auto target = match.getPieceAt(event.to);
+				if (event.kind == GameRecordEventKind::CAPTURE
+						? !target || target->get().getType() != event.pieceType
+						: bool(target))
+					return false;
+
+				if (!piece->get().moveTo(event.to, false))
+					return false;
+
+				match.getBearingTable().update();
+				m_turn = !m_turn;
+				break;
+			}
+			case GameRecordEventKind::PROMOTION:
+			{
+				// see Player::onTurnEnd(), the player who just moved promotes
+				auto color = !m_turn;
+				auto& player = match.getPlayer(color);
+				auto piece = match.getPieceAt(event.to);
+
+				if (event.pieceType != PieceType::KING || !player.isKingTaken() ||
+					player.getFortress().isRuined || player.getFortress().getCoord() != event.to ||
+					!piece || piece->get().getColor() != color || piece->get().getBaseTier() != 3)
+					return false;
+
+				piece->get().promoteTo(event.pieceType);
+				break;
+			}
+			case GameRecordEventKind::END:
+				match.endGame(event.winner);
+				break;
+		}
+
+		return true;
+	}
+}
@@ -77,6 +77,8 @@ namespace cyvasse
 
 		piece->setCoord(coord);
 		m_activePieces.emplace(coord, piece);
+
+		boardChanged();
 	}
 
 	void Match::removeFromBoard(const Piece& piece)
@@ -88,6 +90,7 @@ namespace cyvasse
 		assert(it != m_activePieces.end());
 		auto pieceSharedPtr = it->second;
 		m_activePieces.erase(it);
+		boardChanged();
 
 		auto& player = getPlayer(piece.getColor());
 
@@ -0,0 +1,79 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvasse/move_cache.hpp>
+
+#include <cyvasse/match.hpp>
+
+using namespace std;
+
+namespace cyvasse
+{
+	void MoveCache::rebuild()
+	{
+		m_pieces.fill(nullptr);
+
+		for (auto& mask : m_targetTiles)
+			mask.reset();
+
+		for (const auto& it : m_match.getActivePieces())
+		{
+			auto index = Hexagon<6>::getIndex(it.first);
+			const Piece& piece = *it.second;
+
+			m_pieces[index] = &piece;
+
+			// mountains can't move
+			if (piece.getType() == PieceType::MOUNTAINS)
+				continue;
+
+			for (auto coord : piece.getPossibleTargetTiles())
+				m_targetTiles[index].set(Hexagon<6>::getIndex(coord));
+		}
+
+		m_valid = true;
+	}
+
+	auto MoveCache::getTargetMask(const Piece& piece) -> const TileMask&
+	{
+		static const TileMask empty;
+
+		if (!piece.getCoord())
+			return empty;
+
+		if (!m_valid)
+			rebuild();
+
+		// pieces that were removed from the board keep their last coordinate
+		auto index = Hexagon<6>::getIndex(*piece.getCoord());
+		if (m_pieces[index] != &piece)
+			return empty;
+
+		return m_targetTiles[index];
+	}
+
+	auto MoveCache::getPossibleTargetTiles(const Piece& piece) -> set<HexCoordinate<6>>
+	{
+		set<HexCoordinate<6>> ret;
+
+		const auto& mask = getTargetMask(piece);
+		for (uint16_t i = 0; i < Hexagon<6>::tileCount; i++)
+			if (mask[i])
+				ret.insert(Hexagon<6>::getCoordinate(i));
+
+		return ret;
+	}
+}
@@ -0,0 +1,170 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvasse/move_generator.hpp>
+
+#include <algorithm>
+#include <cyvasse/exchange.hpp>
+#include <cyvasse/fortress.hpp>
+#include <cyvasse/match.hpp>
+
+using namespace std;
+
+namespace cyvasse
+{
+	void MoveGenerator::generateCaptures()
+	{
+		auto& bearingTable = m_match.getBearingTable();
+
+		auto addCapture = [&](const Piece& piece, const Piece& defPiece) {
+			if (bearingTable.canTake(piece, defPiece))
+			{
+				m_moves.push_back({
+					MoveKind::CAPTURE, piece.getType(), *piece.getCoord(), *defPiece.getCoord(),
+					defPiece.getType(), piece.getType()
+				});
+			}
+		};
+
+		for (const auto& it : m_match.getActivePieces())
+		{
+			const Piece& piece = *it.second;
+
+			if (piece.getColor() != m_color || piece.getType() == PieceType::MOUNTAINS)
+				continue;
+
+			// dragons don't have part in flanking,
+			// so getReachableOpponentPieces() can't be used
+			if (piece.getType() == PieceType::DRAGON)
+			{
+				for (auto coord : piece.getReachableTiles())
+				{
+					auto defPiece = m_match.getPieceAt(coord);
+					if (defPiece)
+						addCapture(piece, *defPiece);
+				}
+			}
+			else
+			{
+				for (const Piece& defPiece : piece.getReachableOpponentPieces())
+					addCapture(piece, defPiece);
+			}
+		}
+
+		stable_sort(m_moves.begin(), m_moves.end(), [](const Move& lhs, const Move& rhs) {
+			auto lhsValue = getExchangeValue(lhs.defType);
+			auto rhsValue = getExchangeValue(rhs.defType);
+
+			if (lhsValue != rhsValue)
+				return lhsValue > rhsValue;
+
+			// prefer capturing with the weaker piece
+			return getExchangeValue(lhs.pieceType) < getExchangeValue(rhs.pieceType);
+		});
+
+		m_captureCount = m_moves.size();
+	}
+
+	void MoveGenerator::generatePromotions()
+	{
+		// a tier 3 piece in the fortress can replace a
+		// taken king as long as the fortress isn't ruined
+		// (see Player::onTurnEnd())
+		auto& player = m_match.getPlayer(m_color);
+		auto& fortress = player.getFortress();
+
+		if (!player.isKingTaken() || fortress.isRuined)
+			return;
+
+		auto piece = m_match.getPieceAt(fortress.getCoord());
+		if (piece && piece->get().getColor() == m_color && piece->get().getBaseTier() == 3)
+		{
+			m_moves.push_back({
+				MoveKind::PROMOTION, piece->get().getType(), fortress.getCoord(), fortress.getCoord(),
+				piece->get().getType(), PieceType::KING
+			});
+		}
+	}
+
+	void MoveGenerator::generateQuiets()
+	{
+		auto& moveCache = m_match.getMoveCache();
+
+		for (const auto& it : m_match.getActivePieces())
+		{
+			const Piece& piece = *it.second;
+
+			if (piece.getColor() != m_color || piece.getType() == PieceType::MOUNTAINS)
+				continue;
+
+			const auto& targetMask = moveCache.getTargetMask(piece);
+			for (uint16_t i = 0; i < Hexagon<6>::tileCount; i++)
+			{
+				if (!targetMask[i])
+					continue;
+
+				auto coord = Hexagon<6>::getCoordinate(i);
+				if (!m_match.getPieceAt(coord))
+				{
+					m_moves.push_back({
+						MoveKind::QUIET, piece.getType(), it.first, coord,
+						piece.getType(), piece.getType()
+					});
+				}
+			}
+		}
+	}
+
+	auto MoveGenerator::next() -> optional<Move>
+	{
+		while (m_pos == m_moves.size())
+		{
+			if (m_stageGenerated)
+			{
+				if (m_stage == MoveKind::QUIET)
+					return nullopt;
+
+				m_stage = (m_stage == MoveKind::CAPTURE) ? MoveKind::PROMOTION : MoveKind::QUIET;
+				m_stageGenerated = false;
+			}
+
+			m_moves.clear();
+			m_pos = 0;
+
+			switch (m_stage)
+			{
+				case MoveKind::CAPTURE:   generateCaptures();   break;
+				case MoveKind::PROMOTION: generatePromotions(); break;
+				case MoveKind::QUIET:     generateQuiets();     break;
+			}
+
+			m_stageGenerated = true;
+		}
+
+		return m_moves[m_pos++];
+	}
+
+	bool MoveGenerator::hasCapture()
+	{
+		if (m_stage == MoveKind::CAPTURE && !m_stageGenerated)
+		{
+			generateCaptures();
+			m_stageGenerated = true;
+		}
+
+		return m_captureCount > 0;
+	}
+}
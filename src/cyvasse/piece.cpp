@@ -139,18 +139,23 @@ namespace cyvasse
 	}
 
 	auto Piece::getEffectiveDefenseTier() const -> uint8_t
+	{
+		return getEffectiveDefenseTier(m_coord.value());
+	}
+
+	auto Piece::getEffectiveDefenseTier(HexCoordinate<6> coord) const -> uint8_t
 	{
 		auto baseTier = getBaseTier();
 
 		if (baseTier < 1 || baseTier >= 4)
 			return baseTier;
 
-		auto fortress = m_match.getPlayer(m_color).getFortress();
+		auto& fortress = m_match.getPlayer(m_color).getFortress();
 
-		if (!fortress.isRuined && fortress.getCoord() == m_coord.value())
+		if (!fortress.isRuined && fortress.getCoord() == coord)
 			return ++baseTier;
 
-		auto terrainIt = m_match.getTerrain().find(*m_coord);
+		auto terrainIt = m_match.getTerrain().find(coord);
 		if (terrainIt != m_match.getTerrain().end() &&
 			terrainIt->second->getType() == getHomeTerrain())
 		{
@@ -161,6 +166,11 @@ namespace cyvasse
 	}
 
 	auto Piece::getHomeTerrain() const -> optional<TerrainType>
+	{
+		return getHomeTerrain(m_type);
+	}
+
+	auto Piece::getHomeTerrain(PieceType type) -> optional<TerrainType>
 	{
 		static const map<PieceType, TerrainType> data {
 			{PieceType::CROSSBOWS,   TerrainType::HILL},
@@ -171,7 +181,7 @@ namespace cyvasse
 			{PieceType::HEAVY_HORSE, TerrainType::GRASSLAND}
 		};
 
-		auto it = data.find(m_type);
+		auto it = data.find(type);
 		if (it == data.end())
 			return nullopt;
 
@@ -564,6 +574,7 @@ namespace cyvasse
 		if (!(setup || moveToValid(target)))
 			return false;
 
+		auto oldCoord = m_coord;
 		auto& activePieces = m_match.getActivePieces();
 		auto& player = m_match.getPlayer(m_color);
 
@@ -624,6 +635,8 @@ namespace cyvasse
 		auto res = activePieces.emplace(target, selfSharedPtr);
 		assert(res.second);
 
+		m_match.boardChanged();
+
 		if (!setup)
 		{
 			auto& opFortress = m_match.getPlayer(!m_color).getFortress();
@@ -631,6 +644,8 @@ namespace cyvasse
 				opFortress.ruined();
 		}
 
+		m_match.pieceMoved(*this, oldCoord);
+
 		return true;
 	}
 
@@ -649,6 +664,8 @@ namespace cyvasse
 			assert(player.isKingTaken());
 			player.kingTaken(false);
 		}
+
+		m_match.piecePromoted(m_match.getPieceAt(coord)->get(), m_type);
 	}
 
 	static const map<PieceType, uint8_t> openingPieceCounts {
@@ -679,7 +696,7 @@ namespace cyvasse
 			if (it.second.size() != expectedPieceCount)
 			{
 				throw runtime_error("There have to be exactly " + to_string(expectedPieceCount) + ' ' +
-					PieceTypeToStr(it.first) + " pieces in the opening array (got " + to_string(it.second.size()) + ")");
+					string(PieceTypeToStr(it.first)) + " pieces in the opening array (got " + to_string(it.second.size()) + ")");
 			}
 
 			// TODO: check whether all pieces are on correct side of the board
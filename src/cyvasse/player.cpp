@@ -62,5 +62,6 @@ namespace cyvasse
 			m_match.endGame(m_color);
 
 		m_match.getBearingTable().update();
+		m_match.boardChanged();
 	}
 }
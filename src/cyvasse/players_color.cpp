@@ -16,17 +16,10 @@
 
 #include <cyvasse/players_color.hpp>
 
+#include <map>
+
 namespace cyvasse
 {
-	const PlayersColor PlayersColor::WHITE = PlayersColor(0);
-	const PlayersColor PlayersColor::BLACK = PlayersColor(1);
-
-	PlayersColor PlayersColor::operator!() const
-	{
-		// int-to-bool, operator!(bool), bool-to-int
-		return PlayersColor(!m_val);
-	}
-
 	const std::vector<PlayersColor> allPlayersColors {
 		PlayersColor::WHITE,
 		PlayersColor::BLACK
@@ -0,0 +1,208 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvasse/transposition_table.hpp>
+
+#include <new>
+#include <cstdlib>
+
+#ifdef __linux__
+	#include <sys/mman.h>
+#endif
+
+using namespace std;
+
+namespace cyvasse
+{
+	// layout of the data word of a slot
+	static constexpr unsigned scoreShift      = 0;
+	static constexpr unsigned depthShift      = 16;
+	static constexpr unsigned boundShift      = 24;
+	static constexpr unsigned moveFromShift   = 32;
+	static constexpr unsigned moveToShift     = 40;
+	static constexpr unsigned generationShift = 48;
+
+	static uint64_t pack(const TTEntry& entry, uint8_t generation)
+	{
+		return uint64_t(uint16_t(entry.score)) << scoreShift |
+			uint64_t(uint8_t(entry.depth))    << depthShift |
+			uint64_t(entry.bound)             << boundShift |
+			uint64_t(entry.moveFrom)          << moveFromShift |
+			uint64_t(entry.moveTo)            << moveToShift |
+			uint64_t(generation)              << generationShift;
+	}
+
+	static TTEntry unpack(uint64_t data)
+	{
+		return {
+			int16_t(uint16_t(data >> scoreShift)),
+			int8_t(uint8_t(data >> depthShift)),
+			TTBound(uint8_t(data >> boundShift)),
+			uint8_t(data >> moveFromShift),
+			uint8_t(data >> moveToShift)
+		};
+	}
+
+	static uint8_t getGeneration(uint64_t data)
+	{ return uint8_t(data >> generationShift); }
+
+	TranspositionTable::TranspositionTable(size_t byteSize, bool useHugePages)
+	{
+		m_bucketCount = 1;
+		while (m_bucketCount * 2 * sizeof(Bucket) <= byteSize)
+			m_bucketCount *= 2;
+
+		static constexpr size_t hugePageSize = 2 * 1024 * 1024;
+		auto alignment = (useHugePages && getByteSize() >= hugePageSize) ? hugePageSize : alignof(Bucket);
+
+		void* mem = nullptr;
+		if (posix_memalign(&mem, alignment, getByteSize()) != 0)
+			throw bad_alloc();
+
+#ifdef MADV_HUGEPAGE
+		if (alignment == hugePageSize)
+			madvise(mem, getByteSize(), MADV_HUGEPAGE);
+#endif
+
+		m_buckets = new (mem) Bucket[m_bucketCount];
+		clear();
+	}
+
+	TranspositionTable::~TranspositionTable()
+	{
+		for (size_t i = 0; i < m_bucketCount; i++)
+			m_buckets[i].~Bucket();
+
+		free(m_buckets);
+	}
+
+	auto TranspositionTable::getStatShard() -> StatShard&
+	{
+		// assigned round robin on the first use of any table in a thread
+		static atomic<size_t> nextShard{0};
+		static thread_local size_t shard = nextShard.fetch_add(1, memory_order_relaxed) % statShardCount;
+
+		return m_statShards[shard];
+	}
+
+	auto TranspositionTable::probe(uint64_t key) -> optional<TTEntry>
+	{
+		auto& stats = getStatShard();
+		stats.probes.fetch_add(1, memory_order_relaxed);
+
+		for (auto& slot : getBucket(key).slots)
+		{
+			auto data = slot.data.load(memory_order_relaxed);
+			auto keyXorData = slot.keyXorData.load(memory_order_relaxed);
+
+			// fails if the slot holds another position or
+			// was written by another thread in between
+			if ((keyXorData ^ data) != key)
+				continue;
+
+			auto entry = unpack(data);
+			if (entry.bound == TTBound::NONE)
+				continue;
+
+			stats.hits.fetch_add(1, memory_order_relaxed);
+			return entry;
+		}
+
+		return nullopt;
+	}
+
+	void TranspositionTable::store(uint64_t key, const TTEntry& entry)
+	{
+		auto generation = m_generation.load(memory_order_relaxed);
+
+		Slot* replace = nullptr;
+		bool replaceValid = false;
+		int replaceScore = 0;
+
+		for (auto& slot : getBucket(key).slots)
+		{
+			auto data = slot.data.load(memory_order_relaxed);
+			auto keyXorData = slot.keyXorData.load(memory_order_relaxed);
+			auto oldEntry = unpack(data);
+
+			if (oldEntry.bound == TTBound::NONE || (keyXorData ^ data) == key)
+			{
+				// empty slot or same position
+				replace = &slot;
+				replaceValid = false;
+				break;
+			}
+
+			// prefer replacing shallow entries of old searches
+			uint8_t age = generation - getGeneration(data);
+			int score = oldEntry.depth - 8 * age;
+
+			if (!replace || score < replaceScore)
+			{
+				replace = &slot;
+				replaceValid = true;
+				replaceScore = score;
+			}
+		}
+
+		auto data = pack(entry, generation);
+		replace->data.store(data, memory_order_relaxed);
+		replace->keyXorData.store(key ^ data, memory_order_relaxed);
+
+		auto& stats = getStatShard();
+		stats.stores.fetch_add(1, memory_order_relaxed);
+		if (replaceValid)
+			stats.collisions.fetch_add(1, memory_order_relaxed);
+	}
+
+	void TranspositionTable::clear()
+	{
+		for (size_t i = 0; i < m_bucketCount; i++)
+		{
+			for (auto& slot : m_buckets[i].slots)
+			{
+				slot.keyXorData.store(0, memory_order_relaxed);
+				slot.data.store(0, memory_order_relaxed);
+			}
+		}
+	}
+
+	auto TranspositionTable::getStats() const -> TTStats
+	{
+		TTStats ret {0, 0, 0, 0};
+
+		for (const auto& shard : m_statShards)
+		{
+			ret.probes     += shard.probes.load(memory_order_relaxed);
+			ret.hits       += shard.hits.load(memory_order_relaxed);
+			ret.stores     += shard.stores.load(memory_order_relaxed);
+			ret.collisions += shard.collisions.load(memory_order_relaxed);
+		}
+
+		return ret;
+	}
+
+	void TranspositionTable::resetStats()
+	{
+		for (auto& shard : m_statShards)
+		{
+			shard.probes.store(0, memory_order_relaxed);
+			shard.hits.store(0, memory_order_relaxed);
+			shard.stores.store(0, memory_order_relaxed);
+			shard.collisions.store(0, memory_order_relaxed);
+		}
+	}
+}
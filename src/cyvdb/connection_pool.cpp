@@ -0,0 +1,225 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvdb/connection_pool.hpp>
+
+#include <algorithm>
+#include <utility>
+#include <tntdb/connect.h>
+#include <cyvdb/config.hpp>
+#include <cyvdb/match_manager.hpp>
+#include <cyvdb/player_manager.hpp>
+
+using namespace std;
+
+namespace cyvdb
+{
+	ConnectionPool::Lease::Lease(ConnectionPool* pool, size_t index)
+		: m_pool(pool)
+		, m_index(index)
+		, m_checkedOut(chrono::steady_clock::now())
+	{ }
+
+	ConnectionPool::Lease::~Lease()
+	{
+		release();
+	}
+
+	ConnectionPool::Lease::Lease(Lease&& other) noexcept
+		: m_pool(other.m_pool)
+		, m_index(other.m_index)
+		, m_checkedOut(other.m_checkedOut)
+		, m_discard(other.m_discard)
+	{
+		other.m_pool = nullptr;
+	}
+
+	ConnectionPool::Lease& ConnectionPool::Lease::operator=(Lease&& other) noexcept
+	{
+		if (this != &other)
+		{
+			release();
+
+			m_pool       = other.m_pool;
+			m_index      = other.m_index;
+			m_checkedOut = other.m_checkedOut;
+			m_discard    = other.m_discard;
+
+			other.m_pool = nullptr;
+		}
+
+		return *this;
+	}
+
+	tntdb::Connection& ConnectionPool::Lease::operator*() const
+	{
+		// the slot isn't touched by anyone else while it is leased
+		return m_pool->m_slots[m_index].conn;
+	}
+
+	void ConnectionPool::Lease::release()
+	{
+		if (m_pool)
+		{
+			m_pool->release(m_index, m_checkedOut, m_discard);
+			m_pool = nullptr;
+		}
+	}
+
+	// not connectCached(): the pool is the cache
+	ConnectionPool::ConnectionPool(string url, size_t size, vector<Warmup> warmups)
+		: ConnectionPool([url] { return tntdb::connect(url); }, size, move(warmups))
+	{ }
+
+	ConnectionPool::ConnectionPool(Connector connector, size_t size, vector<Warmup> warmups)
+		: m_connector(move(connector))
+		, m_warmups(move(warmups))
+		, m_slots(max<size_t>(size, 1))
+	{
+		for (auto& slot : m_slots)
+			connect(slot);
+	}
+
+	ConnectionPool& ConnectionPool::glob()
+	{
+		static ConnectionPool s_glob(
+			DBConfig::glob().getMatchDataUrl(),
+			DBConfig::glob().getConnectionPoolSize(),
+			{
+				MatchManager::prepareStatements,
+				PlayerManager::prepareStatements,
+				// fill the dimension caches with the first connection
+				[](tntdb::Connection& conn) {
+					for (auto cache : {&MatchManager::getRuleSets(), &PlayerManager::getPlayersColors()})
+						if (!cache->isLoaded())
+							cache->load(conn);
+				}
+			}
+		);
+
+		return s_glob;
+	}
+
+	void ConnectionPool::connect(Slot& slot)
+	{
+		slot.conn = m_connector();
+
+		for (auto&& warmup : m_warmups)
+			warmup(slot.conn);
+
+		slot.broken = false;
+	}
+
+	bool ConnectionPool::takeFree(thread::id threadID, size_t& index)
+	{
+		auto affinityIt = m_affinity.find(threadID);
+		if (affinityIt != m_affinity.end() && !m_slots[affinityIt->second].inUse)
+		{
+			index = affinityIt->second;
+			m_metrics.affinityHits++;
+		}
+		else
+		{
+			auto it = find_if(m_slots.begin(), m_slots.end(), [](const Slot& slot) { return !slot.inUse; });
+			if (it == m_slots.end())
+				return false;
+
+			index = static_cast<size_t>(it - m_slots.begin());
+			m_affinity[threadID] = index;
+		}
+
+		m_slots[index].inUse = true;
+		return true;
+	}
+
+	ConnectionPool::Lease ConnectionPool::checkout(bool hasDeadline, chrono::steady_clock::time_point deadline)
+	{
+		auto begin = chrono::steady_clock::now();
+		auto threadID = this_thread::get_id();
+
+		size_t index;
+		auto gotFree = [&] { return takeFree(threadID, index); };
+
+		unique_lock<mutex> lock(m_mutex);
+
+		bool waited = !gotFree();
+		if (waited)
+		{
+			if (!hasDeadline)
+				m_released.wait(lock, gotFree);
+			else if (!m_released.wait_until(lock, deadline, gotFree))
+				return Lease();
+		}
+
+		auto wait = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin);
+
+		m_metrics.checkouts++;
+		m_metrics.waits += waited;
+		m_metrics.totalWait += wait;
+		m_metrics.maxWait = max(m_metrics.maxWait, wait);
+
+		bool broken = m_slots[index].broken;
+		if (broken)
+			m_metrics.reconnects++;
+
+		lock.unlock();
+
+		// hand out the lease first, so the slot is released if reconnecting throws
+		Lease lease(this, index);
+		if (broken)
+		{
+			lease.discard();
+			connect(m_slots[index]);
+			lease.m_discard = false;
+		}
+
+		return lease;
+	}
+
+	void ConnectionPool::release(size_t index, chrono::steady_clock::time_point checkedOut, bool discard)
+	{
+		auto duration = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - checkedOut);
+
+		{
+			lock_guard<mutex> lock(m_mutex);
+
+			auto& slot = m_slots[index];
+			slot.inUse = false;
+			slot.broken = slot.broken || discard;
+
+			m_metrics.totalCheckout += duration;
+			m_metrics.maxCheckout = max(m_metrics.maxCheckout, duration);
+		}
+
+		m_released.notify_one();
+	}
+
+	ConnectionPool::Lease ConnectionPool::acquire()
+	{
+		return checkout(false, {});
+	}
+
+	ConnectionPool::Lease ConnectionPool::tryAcquire(chrono::milliseconds timeout)
+	{
+		return checkout(true, chrono::steady_clock::now() + timeout);
+	}
+
+	ConnectionPool::Metrics ConnectionPool::getMetrics() const
+	{
+		lock_guard<mutex> lock(m_mutex);
+		return m_metrics;
+	}
+}
@@ -0,0 +1,104 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvdb/dimension_cache.hpp>
+
+#include <utility>
+#include <tntdb/error.h>
+#include <tntdb/result.h>
+#include <tntdb/row.h>
+#include <tntdb/statement.h>
+
+using namespace std;
+
+namespace cyvdb
+{
+	DimensionCache::DimensionCache(const string& table, const string& idColumn, const string& strColumn)
+		: m_loadQuery("SELECT " + idColumn + ", " + strColumn + " FROM " + table)
+		, m_selectQuery("SELECT " + idColumn + " FROM " + table + " WHERE " + strColumn + " = :str")
+		, m_insertQuery("INSERT INTO " + table + "(" + strColumn + ") VALUES (:str)")
+		, m_cacheKeyPrefix(table + "DimensionCache")
+	{ }
+
+	void DimensionCache::prepareStatements(tntdb::Connection& conn) const
+	{
+		conn.prepareCached(m_selectQuery, m_cacheKeyPrefix + "Select");
+		conn.prepareCached(m_insertQuery, m_cacheKeyPrefix + "Insert");
+	}
+
+	void DimensionCache::load(tntdb::Connection& conn)
+	{
+		unordered_map<string, int> ids;
+		for(const auto& row : conn.prepare(m_loadQuery).select())
+			ids.emplace(row.getString(1), row.getInt(0));
+
+		unique_lock<shared_timed_mutex> lock(m_mutex);
+		m_ids = move(ids);
+		m_loaded = true;
+	}
+
+	bool DimensionCache::isLoaded() const
+	{
+		shared_lock<shared_timed_mutex> lock(m_mutex);
+		return m_loaded;
+	}
+
+	optional<int> DimensionCache::getCachedID(const string& str) const
+	{
+		shared_lock<shared_timed_mutex> lock(m_mutex);
+
+		auto it = m_ids.find(str);
+		if (it == m_ids.end())
+			return nullopt;
+
+		return it->second;
+	}
+
+	int DimensionCache::getID(tntdb::Connection& conn, const string& str)
+	{
+		if (auto id = getCachedID(str))
+			return *id;
+
+		lock_guard<mutex> missLock(m_missMutex);
+
+		// another thread might have had the same miss
+		if (auto id = getCachedID(str))
+			return *id;
+
+		int id;
+
+		try
+		{
+			id = conn.prepareCached(m_selectQuery, m_cacheKeyPrefix + "Select")
+				.set("str", str)
+				.selectValue()
+				.getInt();
+		}
+		catch(tntdb::NotFound&)
+		{
+			conn.prepareCached(m_insertQuery, m_cacheKeyPrefix + "Insert")
+				.set("str", str)
+				.execute();
+
+			id = conn.lastInsertId();
+		}
+
+		unique_lock<shared_timed_mutex> lock(m_mutex);
+		m_ids.emplace(str, id);
+
+		return id;
+	}
+}
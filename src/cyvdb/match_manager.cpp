@@ -17,143 +17,145 @@
 #include <cyvdb/match_manager.hpp>
 
 #include <stdexcept>
-#include <thread>
-#include <tntdb/connect.h>
-#include <tntdb/error.h>
+#include <unordered_map>
+#include <tntdb/result.h>
+#include <tntdb/row.h>
 #include <tntdb/statement.h>
-#include <cyvdb/config.hpp>
-#include <cyvdb/player_manager.hpp>
 
+using namespace std;
 using namespace cyvasse;
 
 namespace cyvdb
 {
-	bool MatchManager::matchValid(const Match& match)
+	static constexpr CachedStatement
+		getAllMatchesStmt {
+			"SELECT matches.match_id, rule_set_str, random, public, player_id, players_color_str "
+			"FROM matches "
+			"INNER JOIN rule_sets ON matches.rule_set = rule_sets.rule_set_id "
+			"LEFT JOIN players ON players.match_id = matches.match_id "
+			"LEFT JOIN players_colors ON players.color = players_colors.players_color_id "
+			"ORDER BY created ASC, matches.match_id",
+			"getAllMatches" // cache key
+		},
+		addMatchStmt {
+			"INSERT INTO matches (match_id, rule_set, random, public) "
+			"VALUES (:id, :ruleSetID, :random, :public)",
+			"addMatch" // cache key
+		},
+		removeMatchStmt {
+			"DELETE FROM matches WHERE match_id = :id",
+			"removeMatch" // cache key
+		};
+
+	void MatchManager::prepareStatements(tntdb::Connection& conn)
 	{
-		return match.getID().length() == 4;
+		for (auto&& statement : {getAllMatchesStmt, addMatchStmt, removeMatchStmt})
+			prepareCached(conn, statement);
+
+		getRuleSets().prepareStatements(conn);
+	}
+
+	DimensionCache& MatchManager::getRuleSets()
+	{
+		static DimensionCache s_ruleSets("rule_sets", "rule_set_id", "rule_set_str");
+		return s_ruleSets;
 	}
 
-	/*int MatchManager::getRuleSetID(RuleSet ruleSet)
+	bool MatchManager::matchValid(const MatchInfo& match)
 	{
-		auto ruleSetStr = RuleSetToStr(ruleSet);
+		return match.id.length() == 4;
+	}
+
+	int MatchManager::getRuleSetID(const string& ruleSet)
+	{
+		if (auto id = getRuleSets().getCachedID(ruleSet))
+			return *id;
+
+		int id;
+		withConnection([&](tntdb::Connection& conn) {
+			id = getRuleSets().getID(conn, ruleSet);
+		});
 
-		try
+		return id;
+	}
+
+	template<class Func>
+	void MatchManager::withConnection(Func func)
+	{
+		if(!m_pool)
 		{
-			return m_conn.prepareCached(
-					"SELECT rule_set_id "
-					"FROM rule_sets "
-					"WHERE rule_set_str = :ruleSetStr",
-					"getRuleSetID" // cache key
-				)
-				.set("ruleSetStr", ruleSetStr)
-				.selectValue()
-				.getInt();
+			func(m_conn);
+			return;
 		}
-		catch(tntdb::NotFound&)
-		{
-			m_conn.prepareCached(
-					"INSERT INTO rule_sets(rule_set_str) "
-					"VALUES (:ruleSetStr)",
-					"addRuleSet" // cache key
-				)
-				.set("ruleSetStr", ruleSetStr)
-				.execute();
 
-			return m_conn.lastInsertId();
-		}
+		auto lease = m_pool->acquire();
+		func(*lease);
 	}
 
 	MatchManager::MatchManager(tntdb::Connection& conn)
 		: m_conn(conn)
 	{ }
 
+	MatchManager::MatchManager(ConnectionPool& pool)
+		: m_pool(&pool)
+	{ }
+
 	MatchManager::MatchManager()
-		: m_conn(tntdb::connectCached(DBConfig::glob().getMatchDataUrl()))
+		: MatchManager(ConnectionPool::glob())
 	{ }
 
-	MatchManager::matchList MatchManager::getOpenRandomMatches()
+	vector<MatchInfo> MatchManager::getAllMatches()
 	{
-		matchList ret;
-
-		for(const auto& row : m_conn.prepareCached(
-				"SELECT rule_set_str, match_id, public "
-				"FROM matches "
-				"INNER JOIN rule_sets ON matches.rule_set_id = rule_sets.rule_set_id "
-				"WHERE random = TRUE "
-				"GROUP BY match_id "
-				"HAVING COUNT(*) = 1 "
-				"ORDER BY created ASC",
-				"getOpenRandomMatches" // cache key
-			))
-		{
-			auto&& match = createMatch(
-				cyvasse::StrToRuleSet(row.getString(0)),
-				row.getString(1), true, row.getBool(2)
-			);
+		vector<MatchInfo> ret;
 
-			auto&& players = PlayerManager(m_conn).getPlayers(*match);
-			assert(players[0] && !players[1]);
+		withConnection([&](tntdb::Connection& conn) {
+			// one row per player (or one for a match without players), ordered by match
+			for(const auto& row : prepareCached(conn, getAllMatchesStmt).select())
+			{
+				auto id = row.getString(0);
 
-			match->setPlayers(std::move(players));
+				if(ret.empty() || ret.back().id != id)
+				{
+					ret.emplace_back();
 
-			ret.push_back(std::move(match));
-		}
+					auto& match = ret.back();
+					match.id       = move(id);
+					match.ruleSet  = row.getString(1);
+					match.isRandom = row.getBool(2);
+					match.isPublic = row.getBool(3);
+				}
+
+				if(!row.isNull(4))
+					ret.back().playerIDs[StrToPlayersColor(row.getString(5))] = row.getString(4);
+			}
+		});
 
 		return ret;
 	}
 
-	MatchManager::matchList MatchManager::getRunningPublicMatches()
+	void MatchManager::addMatch(const MatchInfo& match)
 	{
-		matchList ret;
-
-		for(const auto& row : m_conn.prepareCached(
-				"SELECT rule_set_str, match_id, random "
-				"FROM matches "
-				"INNER JOIN rule_sets ON matches.rule_set_id = rule_sets.rule_set_id "
-				"WHERE public = TRUE "
-				"GROUP BY match_id "
-				"HAVING COUNT(*) = 2 "
-				"ORDER BY created ASC",
-				"getRunningPublicMatches" // cache key
-			))
-			{
-				auto&& match = createMatch(
-					cyvasse::StrToRuleSet(row.getString(0)),
-					row.getString(1), row.getBool(2), true
-				);
+		if(!matchValid(match))
+			throw invalid_argument("The given match is invalid");
 
-				auto&& players = PlayerManager(m_conn).getPlayers(*match);
-				assert(players[0] && players[1]);
+		auto ruleSetID = getRuleSetID(match.ruleSet);
 
-				match->setPlayers(std::move(players));
-
-				ret.push_back(std::move(match));
-			}
-
-			return ret;
+		withConnection([&](tntdb::Connection& conn) {
+			prepareCached(conn, addMatchStmt)
+				.set("id", match.id)
+				.set("ruleSetID", ruleSetID)
+				.set("random", match.isRandom)
+				.set("public", match.isPublic)
+				.execute();
+		});
 	}
 
-	void MatchManager::addMatch(std::unique_ptr<Match> match)
+	void MatchManager::removeMatch(const string& id)
 	{
-		if(!matchValid(*match))
-			throw std::invalid_argument("The given Match object is invalid");
-
-		m_conn.prepareCached(
-				"INSERT INTO matches (match_id, rule_set, random, public) "
-				"VALUES (:id, :ruleSetID, :random, :public)",
-				"addMatch" // cache key
-			)
-			.set("id", match->getID())
-			.set("ruleSetID", getRuleSetID(match->getRuleSet()))
-			.set("random", match->isRandom())
-			.set("public", match->isPublic())
-			.execute();
+		withConnection([&](tntdb::Connection& conn) {
+			prepareCached(conn, removeMatchStmt)
+				.set("id", id)
+				.execute();
+		});
 	}
-
-	void MatchManager::removeMatch(const std::string& id)
-	{
-		m_conn.prepareCached("DELETE FROM matches WHERE match_id = :id", "removeMatch")
-			.set("id", id)
-			.execute();
-	}*/
 }
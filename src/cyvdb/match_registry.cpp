@@ -0,0 +1,243 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvdb/match_registry.hpp>
+
+#include <stdexcept>
+#include <utility>
+#include <tntdb/transaction.h>
+#include <cyvdb/player_manager.hpp>
+
+using namespace std;
+using namespace cyvasse;
+
+namespace cyvdb
+{
+	MatchRegistry::MatchRegistry(ConnectionPool* pool)
+		: m_pool(pool)
+	{ }
+
+	MatchRegistry::MatchRegistry(ConnectionPool& pool)
+		: MatchRegistry(&pool)
+	{ }
+
+	vector<MatchInfo> MatchRegistry::loadMatches()
+	{
+		return MatchManager(*m_pool).getAllMatches();
+	}
+
+	void MatchRegistry::insertMatch(const MatchInfo& match)
+	{
+		// one connection for both managers, a second lease could wait
+		// for a connection forever if every other writer holds one too
+		auto lease = m_pool->acquire();
+
+		// the managers look the IDs up in the DimensionCaches, which
+		// may only miss outside of a transaction
+		MatchManager::getRuleSets().getID(*lease, match.ruleSet);
+		for (auto color : {PlayersColor::WHITE, PlayersColor::BLACK})
+			if (!match.playerIDs[color].empty())
+				PlayerManager::getPlayersColors().getID(*lease, string(PlayersColorToStr(color)));
+
+		tntdb::Transaction transaction(*lease);
+
+		MatchManager(*lease).addMatch(match);
+
+		PlayerManager playerManager(*lease);
+		for (auto color : {PlayersColor::WHITE, PlayersColor::BLACK})
+			if (!match.playerIDs[color].empty())
+				playerManager.addPlayer(match.playerIDs[color], color, match.id);
+
+		transaction.commit();
+	}
+
+	void MatchRegistry::deleteMatch(const MatchInfo& match)
+	{
+		auto lease = m_pool->acquire();
+		tntdb::Transaction transaction(*lease);
+
+		PlayerManager playerManager(*lease);
+		for (auto&& playerID : match.playerIDs)
+			if (!playerID.empty())
+				playerManager.removePlayer(playerID);
+
+		MatchManager(*lease).removeMatch(match.id);
+
+		transaction.commit();
+	}
+
+	void MatchRegistry::insertPlayer(const string& matchID, PlayersColor color, const string& playerID)
+	{
+		PlayerManager(*m_pool).addPlayer(playerID, color, matchID);
+	}
+
+	void MatchRegistry::deletePlayer(const string& playerID)
+	{
+		PlayerManager(*m_pool).removePlayer(playerID);
+	}
+
+	void MatchRegistry::index(const Entry& entry)
+	{
+		const auto& info = entry.info;
+		auto playerCount = info.getPlayerCount();
+
+		if (info.isRandom && playerCount == 1)
+			m_openRandom.emplace(entry.seq, &info);
+		if (info.isPublic && playerCount == 2)
+			m_runningPublic.emplace(entry.seq, &info);
+	}
+
+	void MatchRegistry::unindex(const Entry& entry)
+	{
+		m_openRandom.erase(entry.seq);
+		m_runningPublic.erase(entry.seq);
+	}
+
+	MatchInfo MatchRegistry::getExisting(const string& matchID) const
+	{
+		shared_lock<shared_timed_mutex> lock(m_mutex);
+
+		auto it = m_matches.find(matchID);
+		if (it == m_matches.end())
+			throw invalid_argument("Unknown match " + matchID);
+
+		return it->second.info;
+	}
+
+	vector<MatchInfo> MatchRegistry::toList(const map<uint64_t, const MatchInfo*>& index)
+	{
+		vector<MatchInfo> ret;
+		ret.reserve(index.size());
+
+		for (auto&& it : index)
+			ret.push_back(*it.second);
+
+		return ret;
+	}
+
+	void MatchRegistry::load()
+	{
+		lock_guard<mutex> writeLock(m_writeMutex);
+
+		auto matches = loadMatches();
+
+		unique_lock<shared_timed_mutex> lock(m_mutex);
+
+		m_matches.clear();
+		m_openRandom.clear();
+		m_runningPublic.clear();
+		m_nextSeq = 0;
+
+		for (auto&& match : matches)
+		{
+			auto id = match.id;
+			auto& entry = m_matches.emplace(move(id), Entry {move(match), m_nextSeq++}).first->second;
+			index(entry);
+		}
+	}
+
+	optional<MatchInfo> MatchRegistry::getMatch(const string& matchID) const
+	{
+		shared_lock<shared_timed_mutex> lock(m_mutex);
+
+		auto it = m_matches.find(matchID);
+		if (it == m_matches.end())
+			return nullopt;
+
+		return it->second.info;
+	}
+
+	vector<MatchInfo> MatchRegistry::getOpenRandomMatches() const
+	{
+		shared_lock<shared_timed_mutex> lock(m_mutex);
+		return toList(m_openRandom);
+	}
+
+	vector<MatchInfo> MatchRegistry::getRunningPublicMatches() const
+	{
+		shared_lock<shared_timed_mutex> lock(m_mutex);
+		return toList(m_runningPublic);
+	}
+
+	size_t MatchRegistry::size() const
+	{
+		shared_lock<shared_timed_mutex> lock(m_mutex);
+		return m_matches.size();
+	}
+
+	void MatchRegistry::addMatch(const MatchInfo& match)
+	{
+		lock_guard<mutex> writeLock(m_writeMutex);
+
+		if (getMatch(match.id))
+			throw invalid_argument("Match " + match.id + " already exists");
+
+		insertMatch(match);
+
+		unique_lock<shared_timed_mutex> lock(m_mutex);
+
+		auto& entry = m_matches.emplace(match.id, Entry {match, m_nextSeq++}).first->second;
+		index(entry);
+	}
+
+	void MatchRegistry::removeMatch(const string& matchID)
+	{
+		lock_guard<mutex> writeLock(m_writeMutex);
+
+		deleteMatch(getExisting(matchID));
+
+		unique_lock<shared_timed_mutex> lock(m_mutex);
+
+		auto it = m_matches.find(matchID);
+		unindex(it->second);
+		m_matches.erase(it);
+	}
+
+	void MatchRegistry::addPlayer(const string& matchID, PlayersColor color, const string& playerID)
+	{
+		lock_guard<mutex> writeLock(m_writeMutex);
+
+		if (!getExisting(matchID).playerIDs.at(color).empty())
+			throw invalid_argument("Match " + matchID + " already has a player of that color");
+
+		insertPlayer(matchID, color, playerID);
+
+		unique_lock<shared_timed_mutex> lock(m_mutex);
+
+		auto& entry = m_matches.at(matchID);
+		unindex(entry);
+		entry.info.playerIDs[color] = playerID;
+		index(entry);
+	}
+
+	void MatchRegistry::removePlayer(const string& matchID, PlayersColor color)
+	{
+		lock_guard<mutex> writeLock(m_writeMutex);
+
+		auto playerID = getExisting(matchID).playerIDs.at(color);
+		if (playerID.empty())
+			throw invalid_argument("Match " + matchID + " has no player of that color");
+
+		deletePlayer(playerID);
+
+		unique_lock<shared_timed_mutex> lock(m_mutex);
+
+		auto& entry = m_matches.at(matchID);
+		unindex(entry);
+		entry.info.playerIDs[color].clear();
+		index(entry);
+	}
+}
@@ -16,57 +16,91 @@
 
 #include <cyvdb/player_manager.hpp>
 
-#include <tntdb/connect.h>
+#include <stdexcept>
 #include <tntdb/error.h>
 #include <tntdb/statement.h>
-#include <cyvdb/config.hpp>
 
 using namespace std;
 using namespace cyvasse;
 
 namespace cyvdb
 {
-	bool PlayerManager::playerValid(const cyvasse::Player& player)
+	static constexpr CachedStatement
+		addPlayerStmt {
+			"INSERT INTO players (player_id, match_id, color) "
+			"VALUES (:id, :matchID, :color)",
+			"addPlayer" // cache key
+		},
+		removePlayerStmt {
+			"DELETE FROM players WHERE player_id = :id",
+			"removePlayer" // cache key
+		};
+
+	void PlayerManager::prepareStatements(tntdb::Connection& conn)
 	{
-		return player.getID().length() == 8;
+		for (auto&& statement : {addPlayerStmt, removePlayerStmt})
+			prepareCached(conn, statement);
+
+		getPlayersColors().prepareStatements(conn);
+	}
+
+	DimensionCache& PlayerManager::getPlayersColors()
+	{
+		static DimensionCache s_playersColors("players_colors", "players_color_id", "players_color_str");
+		return s_playersColors;
+	}
+
+	bool PlayerManager::playerIDValid(const string& playerID)
+	{
+		return playerID.length() == 8;
 	}
 
 	int PlayerManager::getPlayersColorID(PlayersColor color)
 	{
-		auto colorStr = PlayersColorToStr(color);
+		std::string colorStr(PlayersColorToStr(color));
 
-		try
+		if (auto id = getPlayersColors().getCachedID(colorStr))
+			return *id;
+
+		// looking it up here would block the game loop on the database
+		if (m_writeQueue)
+			throw logic_error("The players_color " + colorStr + " isn't cached, load getPlayersColors() first");
+
+		int id;
+		withConnection([&](tntdb::Connection& conn) {
+			id = getPlayersColors().getID(conn, colorStr);
+		});
+
+		return id;
+	}
+
+	template<class Func>
+	void PlayerManager::withConnection(Func func)
+	{
+		if(!m_pool)
 		{
-			return m_conn.prepareCached(
-				"SELECT players_color_id "
-				"FROM players_colors "
-				"WHERE players_color_str = :playersColorStr",
-				"getPlayersColor" // cache key
-			)
-			.set("playersColorStr", colorStr)
-			.selectValue()
-			.getInt();
+			func(m_conn);
+			return;
 		}
-		catch(tntdb::NotFound&)
-		{
-			m_conn.prepareCached(
-				"INSERT INTO players_colors(players_color_str) "
-				"VALUES (:playersColorStr)",
-				"addPlayersColor" // cache key
-			)
-			.set("playersColorStr", colorStr)
-			.execute();
 
-			return m_conn.lastInsertId();
-		}
+		auto lease = m_pool->acquire();
+		func(*lease);
 	}
 
 	PlayerManager::PlayerManager(tntdb::Connection& conn)
 		: m_conn(conn)
 	{ }
 
+	PlayerManager::PlayerManager(ConnectionPool& pool)
+		: m_pool(&pool)
+	{ }
+
 	PlayerManager::PlayerManager()
-		: m_conn(tntdb::connectCached(DBConfig::glob().getMatchDataUrl()))
+		: PlayerManager(ConnectionPool::glob())
+	{ }
+
+	PlayerManager::PlayerManager(WriteBehindQueue& writeQueue)
+		: m_writeQueue(&writeQueue)
 	{ }
 
 
@@ -111,19 +145,58 @@ namespace cyvdb
 		return ret;
 	}*/
 
-	void PlayerManager::addPlayer(unique_ptr<cyvasse::Player> player, const string& matchID)
+	void PlayerManager::insertPlayer(tntdb::Connection& conn, const string& playerID, const string& matchID, int colorID)
 	{
-		if(!playerValid(*player))
-			throw invalid_argument("The given Player object is invalid");
-
-		m_conn.prepareCached(
-				"INSERT INTO players (player_id, match_id, color) "
-				"VALUES (:id, :matchID, :color)",
-				"addPlayer" // statement cache key
-			)
-			.set("id", player->getID())
+		prepareCached(conn, addPlayerStmt)
+			.set("id", playerID)
 			.set("matchID", matchID)
-			.set("color", getPlayersColorID(player->getColor()))
+			.set("color", colorID)
 			.execute();
 	}
+
+	void PlayerManager::addPlayer(unique_ptr<cyvasse::Player> player, const string& matchID)
+	{
+		addPlayer(player->getID(), player->getColor(), matchID);
+	}
+
+	void PlayerManager::addPlayer(const string& playerID, PlayersColor color, const string& matchID)
+	{
+		if(!playerIDValid(playerID))
+			throw invalid_argument("The given player is invalid");
+
+		// looked up before the insert, and on the calling thread for the write
+		// queue: a new ID is only cached once it is committed (see DimensionCache)
+		auto colorID = getPlayersColorID(color);
+
+		if(!m_writeQueue)
+		{
+			withConnection([&](tntdb::Connection& conn) {
+				insertPlayer(conn, playerID, matchID, colorID);
+			});
+			return;
+		}
+
+		m_writeQueue->push([playerID, matchID, colorID](tntdb::Connection& conn) {
+			insertPlayer(conn, playerID, matchID, colorID);
+		});
+	}
+
+	void PlayerManager::removePlayer(const string& playerID)
+	{
+		if(!m_writeQueue)
+		{
+			withConnection([&](tntdb::Connection& conn) {
+				prepareCached(conn, removePlayerStmt)
+					.set("id", playerID)
+					.execute();
+			});
+			return;
+		}
+
+		m_writeQueue->push([playerID](tntdb::Connection& conn) {
+			prepareCached(conn, removePlayerStmt)
+				.set("id", playerID)
+				.execute();
+		});
+	}
 }
@@ -0,0 +1,219 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvdb/write_behind_queue.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <tntdb/connect.h>
+#include <tntdb/transaction.h>
+#include <cyvdb/config.hpp>
+
+using namespace std;
+
+namespace cyvdb
+{
+	static void runInTransaction(tntdb::Connection& conn, const function<void()>& func)
+	{
+		tntdb::Transaction transaction(conn);
+		func();
+		transaction.commit();
+	}
+
+	WriteBehindQueue::WriteBehindQueue(tntdb::Connection conn, size_t capacity,
+		size_t maxBatchSize, chrono::milliseconds maxBatchDelay)
+		: WriteBehindQueue(move(conn), runInTransaction, capacity, maxBatchSize, maxBatchDelay)
+	{ }
+
+	WriteBehindQueue::WriteBehindQueue(tntdb::Connection conn, TransactionRunner runTransaction,
+		size_t capacity, size_t maxBatchSize, chrono::milliseconds maxBatchDelay)
+		: m_conn(move(conn))
+		, m_runTransaction(move(runTransaction))
+		, m_capacity(capacity)
+		, m_maxBatchSize(max<size_t>(maxBatchSize, 1))
+		, m_maxBatchDelay(maxBatchDelay)
+		, m_thread(&WriteBehindQueue::run, this)
+	{ }
+
+	// not connectCached(): the connection is used from another thread
+	WriteBehindQueue::WriteBehindQueue()
+		: WriteBehindQueue(tntdb::connect(DBConfig::glob().getMatchDataUrl()))
+	{ }
+
+	WriteBehindQueue::~WriteBehindQueue()
+	{
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+
+		m_pushed.notify_one();
+		m_thread.join();
+	}
+
+	bool WriteBehindQueue::tryPush(Operation operation)
+	{
+		{
+			lock_guard<mutex> lock(m_mutex);
+
+			if (m_stopping)
+				throw logic_error("WriteBehindQueue::push() called while stopping");
+			if (m_queue.size() >= m_capacity)
+				return false;
+
+			m_queue.push_back({move(operation), chrono::steady_clock::now()});
+			m_pushedCount++;
+
+			// the writer only waits for an empty queue or for a full batch
+			if (m_queue.size() != 1 && m_queue.size() != m_maxBatchSize)
+				return true;
+		}
+
+		m_pushed.notify_one();
+		return true;
+	}
+
+	void WriteBehindQueue::push(Operation operation)
+	{
+		if (!tryPush(move(operation)))
+			throw WriteQueueFull();
+	}
+
+	void WriteBehindQueue::flush()
+	{
+		unique_lock<mutex> lock(m_mutex);
+
+		auto target = m_pushedCount;
+		if (m_writtenCount >= target)
+			return;
+
+		m_flushWaiters++;
+		m_pushed.notify_one();
+
+		m_written.wait(lock, [&] { return m_writtenCount >= target; });
+		m_flushWaiters--;
+	}
+
+	void WriteBehindQueue::run()
+	{
+		vector<Operation> batch;
+		batch.reserve(m_maxBatchSize);
+
+		unique_lock<mutex> lock(m_mutex);
+
+		for (;;)
+		{
+			m_pushed.wait(lock, [&] { return m_stopping || !m_queue.empty(); });
+			if (m_queue.empty())
+				return; // stopping and everything is written
+
+			// give the batch time to fill up, unless someone waits for it
+			m_pushed.wait_until(lock, m_queue.front().queued + m_maxBatchDelay, [&] {
+				return m_stopping || m_flushWaiters > 0 || m_queue.size() >= m_maxBatchSize;
+			});
+
+			auto end = m_queue.begin() + static_cast<ptrdiff_t>(min(m_queue.size(), m_maxBatchSize));
+			for (auto it = m_queue.begin(); it != end; ++it)
+				batch.push_back(move(it->operation));
+			m_queue.erase(m_queue.begin(), end);
+
+			lock.unlock();
+			auto failed = write(batch);
+			lock.lock();
+
+			m_writtenCount += batch.size();
+			m_failedCount += failed;
+			batch.clear();
+
+			m_written.notify_all();
+		}
+	}
+
+	size_t WriteBehindQueue::write(vector<Operation>& batch)
+	{
+		// only touched by the writer thread, no lock needed
+		auto report = [this](const exception& e) {
+			if (m_errorHandler)
+				m_errorHandler(e);
+		};
+
+		try
+		{
+			m_runTransaction(m_conn, [&] {
+				for (auto&& operation : batch)
+					operation(m_conn);
+			});
+
+			lock_guard<mutex> lock(m_mutex);
+			m_transactionCount++;
+			return 0;
+		}
+		catch (exception& e)
+		{
+			// rolled back by m_runTransaction
+			if (batch.size() == 1)
+			{
+				report(e);
+				return 1;
+			}
+		}
+
+		// find out which operations failed
+		size_t failed = 0;
+		for (auto&& operation : batch)
+		{
+			try
+			{
+				m_runTransaction(m_conn, [&] { operation(m_conn); });
+
+				lock_guard<mutex> lock(m_mutex);
+				m_transactionCount++;
+			}
+			catch (exception& e)
+			{
+				report(e);
+				failed++;
+			}
+		}
+
+		return failed;
+	}
+
+	size_t WriteBehindQueue::getPendingCount() const
+	{
+		lock_guard<mutex> lock(m_mutex);
+		return m_pushedCount - m_writtenCount;
+	}
+
+	size_t WriteBehindQueue::getWrittenCount() const
+	{
+		lock_guard<mutex> lock(m_mutex);
+		return m_writtenCount;
+	}
+
+	size_t WriteBehindQueue::getFailedCount() const
+	{
+		lock_guard<mutex> lock(m_mutex);
+		return m_failedCount;
+	}
+
+	size_t WriteBehindQueue::getTransactionCount() const
+	{
+		lock_guard<mutex> lock(m_mutex);
+		return m_transactionCount;
+	}
+}
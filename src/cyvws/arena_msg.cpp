@@ -0,0 +1,315 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvws/arena_msg.hpp>
+
+#include <cstring>
+#include <cyvws/common.hpp>
+#include <cyvws/msg.hpp>
+#include <cyvws/notification.hpp>
+#include <cyvws/server_reply.hpp>
+
+using namespace std;
+
+namespace cyvws
+{
+	namespace arena
+	{
+		namespace
+		{
+			// Json::Value stores object members in a map, so the members
+			// have to be written in lexicographical order of their keys.
+			class Writer
+			{
+				private:
+					MsgArena& m_arena;
+					char* m_data;
+					size_t m_size = 0;
+					size_t m_capacity;
+
+					void grow(size_t minCapacity)
+					{
+						// the old buffer stays allocated until the arena is reset
+						auto capacity = max(minCapacity, m_capacity * 2);
+						auto data = static_cast<char*>(m_arena.allocate(capacity, 1));
+
+						memcpy(data, m_data, m_size);
+						m_data = data;
+						m_capacity = capacity;
+					}
+
+					void appendHex16(unsigned val)
+					{
+						static const char hexDigits[] = "0123456789abcdef";
+
+						char buf[6] = {'\\', 'u',
+							hexDigits[(val >> 12) & 0xf], hexDigits[(val >> 8) & 0xf],
+							hexDigits[(val >> 4) & 0xf], hexDigits[val & 0xf]};
+						append(string_view(buf, sizeof(buf)));
+					}
+
+					// same decoding (including the handling of invalid
+					// sequences) as jsoncpp's writer uses
+					static unsigned decodeUtf8(const char*& it, const char* end)
+					{
+						constexpr unsigned replacementChar = 0xfffd;
+
+						auto byte = [&](ptrdiff_t i) { return static_cast<unsigned>(static_cast<unsigned char>(it[i])); };
+						unsigned first = byte(0);
+
+						if (first < 0x80)
+							return first;
+
+						if (first < 0xe0)
+						{
+							if (end - it < 2)
+								return replacementChar;
+
+							unsigned cp = ((first & 0x1f) << 6) | (byte(1) & 0x3f);
+							it += 1;
+							return cp < 0x80 ? replacementChar : cp;
+						}
+
+						if (first < 0xf0)
+						{
+							if (end - it < 3)
+								return replacementChar;
+
+							unsigned cp = ((first & 0x0f) << 12) | ((byte(1) & 0x3f) << 6) | (byte(2) & 0x3f);
+							it += 2;
+							return (cp < 0x800 || (cp >= 0xd800 && cp <= 0xdfff)) ? replacementChar : cp;
+						}
+
+						if (first < 0xf8)
+						{
+							if (end - it < 4)
+								return replacementChar;
+
+							unsigned cp = ((first & 0x07) << 18) | ((byte(1) & 0x3f) << 12)
+								| ((byte(2) & 0x3f) << 6) | (byte(3) & 0x3f);
+							it += 3;
+							return cp < 0x10000 ? replacementChar : cp;
+						}
+
+						return replacementChar;
+					}
+
+				public:
+					explicit Writer(MsgArena& arena, size_t capacity = 128)
+						: m_arena(arena)
+						, m_data(static_cast<char*>(arena.allocate(capacity, 1)))
+						, m_capacity(capacity)
+					{ }
+
+					Writer& append(string_view str)
+					{
+						if (m_size + str.size() > m_capacity)
+							grow(m_size + str.size());
+
+						memcpy(m_data + m_size, str.data(), str.size());
+						m_size += str.size();
+						return *this;
+					}
+
+					Writer& append(char c)
+					{ return append(string_view(&c, 1)); }
+
+					Writer& appendUInt(unsigned val)
+					{
+						char buf[10];
+						char* pos = buf + sizeof(buf);
+
+						do
+						{
+							*--pos = static_cast<char>('0' + val % 10);
+							val /= 10;
+						}
+						while (val);
+
+						return append(string_view(pos, buf + sizeof(buf) - pos));
+					}
+
+					Writer& appendBool(bool val)
+					{ return append(val ? "true" : "false"); }
+
+					// escapes like jsoncpp does by default, i.e. everything
+					// outside of printable ASCII becomes a \u sequence
+					Writer& appendQuoted(string_view str)
+					{
+						append('"');
+
+						const char* end = str.data() + str.size();
+						for (const char* it = str.data(); it != end; ++it)
+						{
+							switch (*it)
+							{
+								case '"':  append("\\\""); break;
+								case '\\': append("\\\\"); break;
+								case '\b': append("\\b"); break;
+								case '\f': append("\\f"); break;
+								case '\n': append("\\n"); break;
+								case '\r': append("\\r"); break;
+								case '\t': append("\\t"); break;
+								default:
+								{
+									unsigned cp = decodeUtf8(it, end);
+
+									if (cp < 0x20)
+										appendHex16(cp);
+									else if (cp < 0x80)
+										append(static_cast<char>(cp));
+									else if (cp < 0x10000)
+										appendHex16(cp);
+									else
+									{
+										cp -= 0x10000;
+										appendHex16(0xd800 + (cp >> 10));
+										appendHex16(0xdc00 + (cp & 0x3ff));
+									}
+								}
+							}
+						}
+
+						return append('"');
+					}
+
+					// "key": - no escaping, keys are protocol constants
+					Writer& key(string_view key, bool first = false)
+					{
+						if (!first)
+							append(',');
+
+						return append('"').append(key).append("\":");
+					}
+
+					string_view str() const
+					{ return string_view(m_data, m_size); }
+			};
+
+			// {"msgID":...,"msgType":"serverReply","replyData":
+			Writer beginServerReply(MsgArena& arena, unsigned msgID)
+			{
+				Writer writer(arena);
+				writer.append('{').key(MSG_ID, true).appendUInt(msgID)
+					.key(MSG_TYPE).appendQuoted(MsgType::SERVER_REPLY)
+					.key(REPLY_DATA).append('{');
+
+				return writer;
+			}
+
+			// {"msgType":"notification","notificationData":
+			Writer beginNotification(MsgArena& arena)
+			{
+				Writer writer(arena);
+				writer.append('{').key(MSG_TYPE, true).appendQuoted(MsgType::NOTIFICATION)
+					.key(NOTIFICATION_DATA).append('{');
+
+				return writer;
+			}
+		}
+
+		string_view gameMsgAck(MsgArena& arena, unsigned msgID)
+		{
+			Writer writer(arena, 48);
+			writer.append('{').key(MSG_ID, true).appendUInt(msgID)
+				.key(MSG_TYPE).appendQuoted(MsgType::GAME_MSG_ACK).append('}');
+
+			return writer.str();
+		}
+
+		string_view gameMsgErr(MsgArena& arena, unsigned msgID, string_view error)
+		{
+			Writer writer(arena);
+			writer.append('{').key(MSG_ERROR, true).appendQuoted(error)
+				.key(MSG_ID).appendUInt(msgID)
+				.key(MSG_TYPE).appendQuoted(MsgType::GAME_MSG_ERR).append('}');
+
+			return writer.str();
+		}
+
+		string_view requestSuccess(MsgArena& arena, unsigned msgID)
+		{
+			auto writer = beginServerReply(arena, msgID);
+			writer.key(SUCCESS, true).appendBool(true).append("}}");
+
+			return writer.str();
+		}
+
+		string_view requestErr(MsgArena& arena, unsigned msgID, string_view error, string_view errDetails)
+		{
+			auto writer = beginServerReply(arena, msgID);
+
+			// json::requestErr() leaves out empty details
+			if (!errDetails.empty())
+				writer.key(ERR_DETAILS, true).appendQuoted(errDetails).key(ERR_MSG);
+			else
+				writer.key(ERR_MSG, true);
+
+			writer.appendQuoted(error).key(SUCCESS).appendBool(false).append("}}");
+
+			return writer.str();
+		}
+
+		string_view createGameSuccess(MsgArena& arena, unsigned msgID, string_view matchID, string_view playerID)
+		{
+			auto writer = beginServerReply(arena, msgID);
+			writer.key(MATCH_ID, true).appendQuoted(matchID)
+				.key(PLAYER_ID).appendQuoted(playerID)
+				.key(SUCCESS).appendBool(true).append("}}");
+
+			return writer.str();
+		}
+
+		string_view commErr(MsgArena& arena, string_view errMsg)
+		{
+			auto writer = beginNotification(arena);
+			writer.key(ERR_MSG, true).appendQuoted(errMsg)
+				.key(TYPE).appendQuoted(NotificationType::COMM_ERROR).append("}}");
+
+			return writer.str();
+		}
+
+		string_view userJoined(MsgArena& arena, string_view username, bool registered, string_view /* role */)
+		{
+			// like json::userJoined(), the role isn't sent yet
+			auto writer = beginNotification(arena);
+			writer.key(REGISTERED, true).appendBool(registered)
+				.key(TYPE).appendQuoted(NotificationType::USER_JOINED)
+				.key(USERNAME).appendQuoted(username).append("}}");
+
+			return writer.str();
+		}
+
+		string_view userLeft(MsgArena& arena, string_view username)
+		{
+			auto writer = beginNotification(arena);
+			writer.key(TYPE, true).appendQuoted(NotificationType::USER_LEFT)
+				.key(USERNAME).appendQuoted(username).append("}}");
+
+			return writer.str();
+		}
+
+		string_view usernameUpdate(MsgArena& arena, string_view oldUsername, string_view newUsername)
+		{
+			auto writer = beginNotification(arena);
+			writer.key(NEW_USERNAME, true).appendQuoted(newUsername)
+				.key(OLD_USERNAME).appendQuoted(oldUsername)
+				.key(TYPE).appendQuoted(NotificationType::USERNAME_UPDATE).append("}}");
+
+			return writer.str();
+		}
+	}
+}
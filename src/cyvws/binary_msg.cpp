@@ -0,0 +1,395 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvws/binary_msg.hpp>
+
+#include <cyvasse/hexagon.hpp>
+#include <cyvws/init_comm.hpp>
+
+namespace cyvws
+{
+	namespace binary
+	{
+		using namespace std;
+		using namespace cyvasse;
+
+		typedef BinaryMsgError Error;
+
+		namespace
+		{
+			class Encoder
+			{
+				private:
+					string m_buf;
+
+				public:
+					Encoder(MsgTypeCode type)
+					{
+						m_buf.reserve(16);
+						m_buf += static_cast<char>(type);
+					}
+
+					Encoder& varint(uint32_t val)
+					{
+						while (val >= 0x80)
+						{
+							m_buf += static_cast<char>((val & 0x7f) | 0x80);
+							val >>= 7;
+						}
+
+						m_buf += static_cast<char>(val);
+						return *this;
+					}
+
+					Encoder& byte(uint8_t val)
+					{
+						m_buf += static_cast<char>(val);
+						return *this;
+					}
+
+					Encoder& str(const string& val)
+					{
+						varint(val.size());
+						m_buf += val;
+						return *this;
+					}
+
+					Encoder& action(GameMsgActionCode val)
+					{ return byte(static_cast<uint8_t>(val)); }
+
+					Encoder& pieceType(PieceType val)
+					{ return byte(static_cast<uint8_t>(val)); }
+
+					Encoder& coord(HexCoordinate<6> val)
+					{ return byte(Hexagon<6>::getIndex(val)); }
+
+					string get()
+					{ return std::move(m_buf); }
+			};
+
+			class Decoder
+			{
+				private:
+					string_view m_buf;
+					size_t m_pos = 0;
+
+				public:
+					explicit Decoder(string_view buf)
+						: m_buf(buf)
+					{ }
+
+					bool atEnd() const
+					{ return m_pos == m_buf.size(); }
+
+					string_view rest()
+					{
+						auto ret = m_buf.substr(m_pos);
+						m_pos = m_buf.size();
+						return ret;
+					}
+
+					Error byte(uint8_t& val)
+					{
+						if (atEnd())
+							return Error::TRUNCATED;
+
+						val = static_cast<uint8_t>(m_buf[m_pos++]);
+						return Error::NONE;
+					}
+
+					Error varint(uint32_t& val)
+					{
+						val = 0;
+
+						for (unsigned shift = 0; shift < 35; shift += 7)
+						{
+							uint8_t b;
+							if (byte(b) != Error::NONE)
+								return Error::TRUNCATED;
+
+							if (shift == 28 && b > 0x0f)
+								return Error::INVALID_VARINT;
+
+							val |= uint32_t(b & 0x7f) << shift;
+							if (!(b & 0x80))
+								return Error::NONE;
+						}
+
+						return Error::INVALID_VARINT;
+					}
+
+					Error str(string_view& val)
+					{
+						uint32_t len;
+
+						auto err = varint(len);
+						if (err != Error::NONE)
+							return err;
+
+						if (m_buf.size() - m_pos < len)
+							return Error::TRUNCATED;
+
+						val = m_buf.substr(m_pos, len);
+						m_pos += len;
+						return Error::NONE;
+					}
+
+					Error pieceType(PieceType& val)
+					{
+						uint8_t b;
+
+						auto err = byte(b);
+						if (err != Error::NONE)
+							return err;
+
+						if (b >= pieceTypeCount)
+							return Error::INVALID_PIECE_TYPE;
+
+						val = static_cast<PieceType>(b);
+						return Error::NONE;
+					}
+
+					Error coord(HexCoordinate<6>& val)
+					{
+						uint8_t b;
+
+						auto err = byte(b);
+						if (err != Error::NONE)
+							return err;
+
+						if (b >= Hexagon<6>::tileCount)
+							return Error::INVALID_COORDINATE;
+
+						val = Hexagon<6>::getCoordinate(b);
+						return Error::NONE;
+					}
+			};
+
+			Error decodeGameMsg(Decoder& dec, BinaryMsg& msg)
+			{
+				uint8_t action;
+
+				auto err = dec.byte(action);
+				if (err != Error::NONE)
+					return err;
+
+				if (action > static_cast<uint8_t>(GameMsgActionCode::SET_OPENING_ARRAY))
+					return Error::INVALID_ACTION;
+
+				msg.action = static_cast<GameMsgActionCode>(action);
+
+				// placeholder values, overwritten by the decoder
+				constexpr HexCoordinate<6> center(5, 5);
+
+				switch (msg.action)
+				{
+					case GameMsgActionCode::MOVE:
+					{
+						PieceMovement mv {PieceType::MOUNTAINS, center, center};
+
+						err = dec.pieceType(mv.pieceType);
+						if (err == Error::NONE) err = dec.coord(mv.oldPos);
+						if (err == Error::NONE) err = dec.coord(mv.newPos);
+
+						msg.movement = mv;
+						return err;
+					}
+					case GameMsgActionCode::MOVE_CAPTURE:
+					{
+						MoveCapture mc {PieceType::MOUNTAINS, center, center, PieceType::MOUNTAINS, center};
+
+						err = dec.pieceType(mc.atkPT);
+						if (err == Error::NONE) err = dec.coord(mc.oldPos);
+						if (err == Error::NONE) err = dec.coord(mc.newPos);
+						if (err == Error::NONE) err = dec.pieceType(mc.defPT);
+						if (err == Error::NONE) err = dec.coord(mc.defPiecePos);
+
+						msg.moveCapture = mc;
+						return err;
+					}
+					case GameMsgActionCode::PROMOTE:
+					{
+						Promotion pr {PieceType::MOUNTAINS, PieceType::MOUNTAINS};
+
+						err = dec.pieceType(pr.origType);
+						if (err == Error::NONE) err = dec.pieceType(pr.newType);
+
+						msg.promotion = pr;
+						return err;
+					}
+					case GameMsgActionCode::SET_OPENING_ARRAY:
+					{
+						uint8_t typeCount;
+
+						err = dec.byte(typeCount);
+						for (uint8_t i = 0; i < typeCount && err == Error::NONE; i++)
+						{
+							PieceType type;
+							uint8_t coordCount;
+
+							err = dec.pieceType(type);
+							if (err == Error::NONE) err = dec.byte(coordCount);
+							if (err != Error::NONE)
+								break;
+
+							auto& coords = msg.pieceMap[type];
+							for (uint8_t j = 0; j < coordCount && err == Error::NONE; j++)
+							{
+								auto coord = center;
+
+								err = dec.coord(coord);
+								coords.insert(coord);
+							}
+						}
+
+						return err;
+					}
+					default:
+						return Error::NONE;
+				}
+			}
+		}
+
+		bool requestsBinaryProtocol(const string& protocolVersion)
+		{
+			string_view suffix(BINARY_PROTOCOL_SUFFIX);
+
+			return protocolVersion.size() > suffix.size() &&
+				protocolVersion.compare(protocolVersion.size() - suffix.size(), suffix.size(),
+				                        suffix.data(), suffix.size()) == 0;
+		}
+
+		string replyProtocolVersion(const string& serverVersion, const string& requestedVersion)
+		{
+			if (requestsBinaryProtocol(requestedVersion))
+				return serverVersion + BINARY_PROTOCOL_SUFFIX;
+
+			return serverVersion;
+		}
+
+		string jsonMsg(const string& msg)
+		{
+			return Encoder(MsgTypeCode::JSON).get() + msg;
+		}
+
+		string chatMsg(unsigned msgID, const string& user, const string& content)
+		{ return Encoder(MsgTypeCode::CHAT_MSG).varint(msgID).str(user).str(content).get(); }
+
+		string chatMsgAck(unsigned msgID)
+		{ return Encoder(MsgTypeCode::CHAT_MSG_ACK).varint(msgID).get(); }
+
+		string gameMsgSetOpeningArray(unsigned msgID, const PieceMap& map)
+		{
+			Encoder enc(MsgTypeCode::GAME_MSG);
+			enc.varint(msgID).action(GameMsgActionCode::SET_OPENING_ARRAY).byte(map.size());
+
+			for (const auto& it : map)
+			{
+				enc.pieceType(it.first).byte(it.second.size());
+
+				for (auto coord : it.second)
+					enc.coord(coord);
+			}
+
+			return enc.get();
+		}
+
+		string gameMsgSetIsReady(unsigned msgID)
+		{ return Encoder(MsgTypeCode::GAME_MSG).varint(msgID).action(GameMsgActionCode::SET_IS_READY).get(); }
+
+		string gameMsgMove(unsigned msgID, PieceType pieceType, HexCoordinate<6> oldPos, HexCoordinate<6> newPos)
+		{
+			return Encoder(MsgTypeCode::GAME_MSG).varint(msgID).action(GameMsgActionCode::MOVE)
+				.pieceType(pieceType).coord(oldPos).coord(newPos).get();
+		}
+
+		string gameMsgMoveCapture(unsigned msgID, PieceType atkPT, HexCoordinate<6> oldPos, HexCoordinate<6> newPos,
+		                          PieceType defPT, HexCoordinate<6> defPiecePos)
+		{
+			return Encoder(MsgTypeCode::GAME_MSG).varint(msgID).action(GameMsgActionCode::MOVE_CAPTURE)
+				.pieceType(atkPT).coord(oldPos).coord(newPos).pieceType(defPT).coord(defPiecePos).get();
+		}
+
+		string gameMsgPromote(unsigned msgID, PieceType origType, PieceType newType)
+		{
+			return Encoder(MsgTypeCode::GAME_MSG).varint(msgID).action(GameMsgActionCode::PROMOTE)
+				.pieceType(origType).pieceType(newType).get();
+		}
+
+		string gameMsgEndTurn(unsigned msgID)
+		{ return Encoder(MsgTypeCode::GAME_MSG).varint(msgID).action(GameMsgActionCode::END_TURN).get(); }
+
+		string gameMsgResign(unsigned msgID)
+		{ return Encoder(MsgTypeCode::GAME_MSG).varint(msgID).action(GameMsgActionCode::RESIGN).get(); }
+
+		string gameMsgAck(unsigned msgID)
+		{ return Encoder(MsgTypeCode::GAME_MSG_ACK).varint(msgID).get(); }
+
+		string gameMsgErr(unsigned msgID, const string& error)
+		{ return Encoder(MsgTypeCode::GAME_MSG_ERR).varint(msgID).str(error).get(); }
+
+		BinaryMsgError decode(string_view buf, BinaryMsg& msg)
+		{
+			Decoder dec(buf);
+			msg = BinaryMsg();
+
+			uint8_t type;
+			auto err = dec.byte(type);
+			if (err != Error::NONE)
+				return err;
+
+			if (type > static_cast<uint8_t>(MsgTypeCode::GAME_MSG_ERR))
+				return Error::INVALID_MSG_TYPE;
+
+			msg.type = static_cast<MsgTypeCode>(type);
+
+			if (msg.type == MsgTypeCode::JSON)
+			{
+				msg.text = dec.rest();
+				return Error::NONE;
+			}
+
+			uint32_t msgID;
+			err = dec.varint(msgID);
+			if (err != Error::NONE)
+				return err;
+
+			msg.msgID = msgID;
+
+			switch (msg.type)
+			{
+				case MsgTypeCode::CHAT_MSG:
+					err = dec.str(msg.user);
+					if (err == Error::NONE)
+						err = dec.str(msg.text);
+					break;
+				case MsgTypeCode::GAME_MSG:
+					err = decodeGameMsg(dec, msg);
+					break;
+				case MsgTypeCode::GAME_MSG_ERR:
+					err = dec.str(msg.text);
+					break;
+				default:
+					break;
+			}
+
+			if (err == Error::NONE && !dec.atEnd())
+				return Error::TRAILING_DATA;
+
+			return err;
+		}
+	}
+}
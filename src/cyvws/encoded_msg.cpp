@@ -0,0 +1,66 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvws/encoded_msg.hpp>
+
+#include <cstdint>
+#include <json/writer.h>
+
+namespace cyvws
+{
+	using namespace std;
+
+	EncodedMsg::EncodedMsg(MsgEncoding encoding, string_view payload, bool withFrame)
+		: m_frameOffset(maxFrameHeaderSize)
+		, m_encoding(encoding)
+	{
+		// the header is written right-aligned into the reserved
+		// space, so header and payload end up contiguous
+		string buf(maxFrameHeaderSize, '\0');
+		buf.reserve(maxFrameHeaderSize + payload.size());
+		buf.append(payload.data(), payload.size());
+
+		if (withFrame)
+		{
+			uint64_t len = payload.size();
+			size_t lenBytes = len < 126 ? 0 : len <= 0xffff ? 2 : 8;
+
+			m_frameOffset = maxFrameHeaderSize - 2 - lenBytes;
+
+			// FIN bit set, opcode 1 (text) or 2 (binary)
+			buf[m_frameOffset] = static_cast<char>(0x80 | (encoding == MsgEncoding::JSON ? 0x1 : 0x2));
+			buf[m_frameOffset + 1] = static_cast<char>(lenBytes == 0 ? len : lenBytes == 2 ? 126 : 127);
+
+			// extended payload length in network byte order
+			for (size_t i = 0; i < lenBytes; i++)
+				buf[maxFrameHeaderSize - 1 - i] = static_cast<char>((len >> (8 * i)) & 0xff);
+		}
+
+		m_buf = make_shared<const string>(move(buf));
+	}
+
+	EncodedMsg EncodedMsg::fromJson(const Json::Value& val, bool withFrame)
+	{
+		static const Json::StreamWriterBuilder builder = [] {
+			Json::StreamWriterBuilder ret;
+			ret["indentation"] = "";
+
+			return ret;
+		}();
+
+		return EncodedMsg(MsgEncoding::JSON, Json::writeString(builder, val), withFrame);
+	}
+}
@@ -0,0 +1,549 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvws/game_msg_parser.hpp>
+
+#include <limits>
+#include <cyvws/game_msg.hpp>
+#include <cyvws/msg.hpp>
+#include <cyvws/common.hpp>
+
+namespace cyvws
+{
+	namespace parser
+	{
+		using namespace std;
+		using namespace cyvasse;
+
+		typedef GameMsgParseError Error;
+
+		namespace
+		{
+			constexpr unsigned maxDepth = 32;
+
+			class Cursor
+			{
+				private:
+					string_view m_buf;
+					size_t m_pos = 0;
+
+				public:
+					explicit Cursor(string_view buf)
+						: m_buf(buf)
+					{ }
+
+					void skipWhitespace()
+					{
+						while (m_pos < m_buf.size() && (m_buf[m_pos] == ' ' || m_buf[m_pos] == '\t' ||
+						                                m_buf[m_pos] == '\n' || m_buf[m_pos] == '\r'))
+							m_pos++;
+					}
+
+					// returns '\0' at the end of the buffer
+					char peek()
+					{
+						skipWhitespace();
+						return m_pos < m_buf.size() ? m_buf[m_pos] : '\0';
+					}
+
+					bool consume(char c)
+					{
+						if (peek() != c)
+							return false;
+
+						m_pos++;
+						return true;
+					}
+
+					bool atEnd()
+					{ return peek() == '\0'; }
+
+					Error readString(string_view& str);
+					Error readInt(int& val);
+					Error skipValue(unsigned depth = 0);
+
+					// read any value and return its unparsed text
+					Error readRaw(string_view& raw)
+					{
+						auto begin = (skipWhitespace(), m_pos);
+
+						auto err = skipValue();
+						if (err == Error::NONE)
+							raw = m_buf.substr(begin, m_pos - begin);
+
+						return err;
+					}
+
+					template <class Func>
+					Error readObject(Func&& memberFunc, unsigned depth = 0);
+					template <class Func>
+					Error readArray(Func&& elemFunc, unsigned depth = 0);
+			};
+
+			Error Cursor::readString(string_view& str)
+			{
+				auto c = peek();
+				if (c != '"')
+					return c == '\0' ? Error::SYNTAX_ERROR : Error::UNEXPECTED_TYPE;
+
+				auto begin = ++m_pos;
+
+				while (m_pos < m_buf.size())
+				{
+					c = m_buf[m_pos];
+
+					if (c == '"')
+					{
+						str = m_buf.substr(begin, m_pos - begin);
+						m_pos++;
+						return Error::NONE;
+					}
+					else if (c == '\\')
+						m_pos += 2; // the escaped character is only checked by being skipped
+					else if (static_cast<unsigned char>(c) < 0x20)
+						return Error::SYNTAX_ERROR;
+					else
+						m_pos++;
+				}
+
+				return Error::SYNTAX_ERROR;
+			}
+
+			Error Cursor::readInt(int& val)
+			{
+				auto c = peek();
+				if (c != '-' && (c < '0' || c > '9'))
+					return Error::UNEXPECTED_TYPE;
+
+				bool negative = consume('-');
+				if (m_pos == m_buf.size() || m_buf[m_pos] < '0' || m_buf[m_pos] > '9')
+					return Error::SYNTAX_ERROR;
+
+				long long res = 0;
+				while (m_pos < m_buf.size() && m_buf[m_pos] >= '0' && m_buf[m_pos] <= '9')
+				{
+					res = res * 10 + (m_buf[m_pos++] - '0');
+					if (res > numeric_limits<int>::max())
+						return Error::INVALID_MSG_ID;
+				}
+
+				if (m_pos < m_buf.size() && (m_buf[m_pos] == '.' || m_buf[m_pos] == 'e' || m_buf[m_pos] == 'E'))
+					return Error::INVALID_MSG_ID;
+
+				val = static_cast<int>(negative ? -res : res);
+				return Error::NONE;
+			}
+
+			Error Cursor::skipValue(unsigned depth)
+			{
+				auto skipLiteral = [this](const char* lit) {
+					auto len = char_traits<char>::length(lit);
+					if (m_buf.substr(m_pos, len) != lit)
+						return Error::SYNTAX_ERROR;
+
+					m_pos += len;
+					return Error::NONE;
+				};
+
+				auto skipDigits = [this] {
+					auto begin = m_pos;
+					while (m_pos < m_buf.size() && m_buf[m_pos] >= '0' && m_buf[m_pos] <= '9')
+						m_pos++;
+
+					return m_pos != begin;
+				};
+
+				string_view str;
+
+				switch (peek())
+				{
+					case '{':
+						return readObject([this, depth](string_view) { return skipValue(depth + 1); }, depth);
+					case '[':
+						return readArray([this, depth] { return skipValue(depth + 1); }, depth);
+					case '"':
+						return readString(str);
+					case 't':
+						return skipLiteral("true");
+					case 'f':
+						return skipLiteral("false");
+					case 'n':
+						return skipLiteral("null");
+					case '-':
+					case '0': case '1': case '2': case '3': case '4':
+					case '5': case '6': case '7': case '8': case '9':
+						consume('-');
+						if (!skipDigits())
+							return Error::SYNTAX_ERROR;
+
+						if (m_pos < m_buf.size() && m_buf[m_pos] == '.')
+						{
+							m_pos++;
+							if (!skipDigits())
+								return Error::SYNTAX_ERROR;
+						}
+
+						if (m_pos < m_buf.size() && (m_buf[m_pos] == 'e' || m_buf[m_pos] == 'E'))
+						{
+							m_pos++;
+							if (m_pos < m_buf.size() && (m_buf[m_pos] == '+' || m_buf[m_pos] == '-'))
+								m_pos++;
+
+							if (!skipDigits())
+								return Error::SYNTAX_ERROR;
+						}
+
+						return Error::NONE;
+					default:
+						return Error::SYNTAX_ERROR;
+				}
+			}
+
+			template <class Func>
+			Error Cursor::readObject(Func&& memberFunc, unsigned depth)
+			{
+				if (depth >= maxDepth)
+					return Error::NESTING_TOO_DEEP;
+
+				auto c = peek();
+				if (c != '{')
+					return c == '\0' ? Error::SYNTAX_ERROR : Error::UNEXPECTED_TYPE;
+
+				m_pos++;
+				if (consume('}'))
+					return Error::NONE;
+
+				do
+				{
+					string_view key;
+
+					auto err = readString(key);
+					if (err != Error::NONE)
+						return Error::SYNTAX_ERROR;
+
+					if (!consume(':'))
+						return Error::SYNTAX_ERROR;
+
+					err = memberFunc(key);
+					if (err != Error::NONE)
+						return err;
+				}
+				while (consume(','));
+
+				return consume('}') ? Error::NONE : Error::SYNTAX_ERROR;
+			}
+
+			template <class Func>
+			Error Cursor::readArray(Func&& elemFunc, unsigned depth)
+			{
+				if (depth >= maxDepth)
+					return Error::NESTING_TOO_DEEP;
+
+				auto c = peek();
+				if (c != '[')
+					return c == '\0' ? Error::SYNTAX_ERROR : Error::UNEXPECTED_TYPE;
+
+				m_pos++;
+				if (consume(']'))
+					return Error::NONE;
+
+				do
+				{
+					auto err = elemFunc();
+					if (err != Error::NONE)
+						return err;
+				}
+				while (consume(','));
+
+				return consume(']') ? Error::NONE : Error::SYNTAX_ERROR;
+			}
+
+			Error matchPieceType(string_view str, PieceType& type)
+			{
+				auto res = tryStrToPieceType(str);
+				if (!res)
+					return Error::INVALID_PIECE_TYPE;
+
+				type = *res;
+				return Error::NONE;
+			}
+
+			Error readPieceType(Cursor& cursor, PieceType& type)
+			{
+				string_view str;
+
+				auto err = cursor.readString(str);
+				if (err != Error::NONE)
+					return err;
+
+				return matchPieceType(str, type);
+			}
+
+			Error readCoordinate(Cursor& cursor, HexCoordinate<6>& coord)
+			{
+				string_view str;
+
+				auto err = cursor.readString(str);
+				if (err != Error::NONE)
+					return err;
+
+				auto res = HexCoordinate<6>::tryParse(str);
+				if (!res)
+					return Error::INVALID_COORDINATE;
+
+				coord = *res;
+				return Error::NONE;
+			}
+
+			Error checkEnd(Cursor& cursor, Error err)
+			{
+				if (err == Error::NONE && !cursor.atEnd())
+					return Error::SYNTAX_ERROR;
+
+				return err;
+			}
+
+			Error readPieceMovement(Cursor& cursor, PieceType& pieceType, HexCoordinate<6>& oldPos,
+			                        HexCoordinate<6>& newPos, unsigned depth = 0)
+			{
+				bool hasPieceType = false, hasOldPos = false, hasNewPos = false;
+
+				auto err = cursor.readObject([&](string_view key) {
+					if (key == PIECE_TYPE)
+					{
+						hasPieceType = true;
+						return readPieceType(cursor, pieceType);
+					}
+					else if (key == OLD_POS)
+					{
+						hasOldPos = true;
+						return readCoordinate(cursor, oldPos);
+					}
+					else if (key == NEW_POS)
+					{
+						hasNewPos = true;
+						return readCoordinate(cursor, newPos);
+					}
+					else
+						return cursor.skipValue(depth + 1);
+				}, depth);
+
+				if (err == Error::NONE && !(hasPieceType && hasOldPos && hasNewPos))
+					return Error::MISSING_MEMBER;
+
+				return err;
+			}
+
+			/* Read the param of setOpeningArray, an object with piece types as
+			   keys and arrays of coordinates as values. typeFunc is called for
+			   every key, posFunc for every coordinate.
+			 */
+			template <class TypeFunc, class PosFunc>
+			Error readPieceMap(Cursor& cursor, TypeFunc&& typeFunc, PosFunc&& posFunc)
+			{
+				return cursor.readObject([&](string_view key) {
+					PieceType type;
+
+					auto err = matchPieceType(key, type);
+					if (err != Error::NONE)
+						return err;
+
+					typeFunc(type);
+
+					// json::pieceMap() accepts null as an empty list
+					if (cursor.peek() == 'n')
+						return cursor.skipValue(1);
+
+					return cursor.readArray([&] {
+						HexCoordinate<6> coord(5, 5);
+
+						auto err = readCoordinate(cursor, coord);
+						if (err != Error::NONE)
+							return err;
+
+						return posFunc(type, coord);
+					}, 1);
+				});
+			}
+		}
+
+		GameMsgParseError parseGameMsg(string_view msg, GameMsgView& view)
+		{
+			Cursor cursor(msg);
+			bool hasMsgType = false, hasMsgData = false, hasAction = false;
+
+			view = GameMsgView();
+
+			auto err = cursor.readObject([&](string_view key) {
+				if (key == MSG_TYPE)
+				{
+					hasMsgType = true;
+
+					string_view msgType;
+					auto err = cursor.readString(msgType);
+					if (err == Error::NONE && msgType != MsgType::GAME_MSG)
+						return Error::WRONG_MSG_TYPE;
+
+					return err;
+				}
+				else if (key == MSG_ID)
+				{
+					int msgID;
+
+					auto err = cursor.readInt(msgID);
+					if (err == Error::NONE)
+						view.msgID = msgID;
+
+					return err;
+				}
+				else if (key == MSG_DATA)
+				{
+					hasMsgData = true;
+
+					return cursor.readObject([&](string_view key) {
+						if (key == ACTION)
+						{
+							hasAction = true;
+							return cursor.readString(view.action);
+						}
+						else if (key == PARAM)
+							return cursor.readRaw(view.param);
+						else
+							return cursor.skipValue(2);
+					}, 1);
+				}
+				else
+					return cursor.skipValue(1);
+			});
+
+			if (err == Error::NONE && !(hasMsgType && hasMsgData && hasAction))
+				return Error::MISSING_MEMBER;
+
+			view.actionCode = findGameMsgAction(view.action);
+			return checkEnd(cursor, err);
+		}
+
+		GameMsgParseError parseMovement(string_view param, PieceMovement& movement)
+		{
+			Cursor cursor(param);
+			return checkEnd(cursor, readPieceMovement(cursor, movement.pieceType, movement.oldPos, movement.newPos));
+		}
+
+		GameMsgParseError parseMoveCapture(string_view param, MoveCapture& moveCapture)
+		{
+			Cursor cursor(param);
+			bool hasAtkPiece = false, hasDefPiece = false;
+
+			auto err = cursor.readObject([&](string_view key) {
+				if (key == ATK_PIECE)
+				{
+					hasAtkPiece = true;
+					return readPieceMovement(cursor, moveCapture.atkPT, moveCapture.oldPos, moveCapture.newPos, 1);
+				}
+				else if (key == DEF_PIECE)
+				{
+					hasDefPiece = true;
+					bool hasPieceType = false, hasPos = false;
+
+					auto err = cursor.readObject([&](string_view key) {
+						if (key == PIECE_TYPE)
+						{
+							hasPieceType = true;
+							return readPieceType(cursor, moveCapture.defPT);
+						}
+						else if (key == POS)
+						{
+							hasPos = true;
+							return readCoordinate(cursor, moveCapture.defPiecePos);
+						}
+						else
+							return cursor.skipValue(2);
+					}, 1);
+
+					if (err == Error::NONE && !(hasPieceType && hasPos))
+						return Error::MISSING_MEMBER;
+
+					return err;
+				}
+				else
+					return cursor.skipValue(1);
+			});
+
+			if (err == Error::NONE && !(hasAtkPiece && hasDefPiece))
+				return Error::MISSING_MEMBER;
+
+			return checkEnd(cursor, err);
+		}
+
+		GameMsgParseError parsePromotion(string_view param, Promotion& promotion)
+		{
+			Cursor cursor(param);
+			bool hasOrigType = false, hasNewType = false;
+
+			auto err = cursor.readObject([&](string_view key) {
+				if (key == ORIG_TYPE)
+				{
+					hasOrigType = true;
+					return readPieceType(cursor, promotion.origType);
+				}
+				else if (key == NEW_TYPE)
+				{
+					hasNewType = true;
+					return readPieceType(cursor, promotion.newType);
+				}
+				else
+					return cursor.skipValue(1);
+			});
+
+			if (err == Error::NONE && !(hasOrigType && hasNewType))
+				return Error::MISSING_MEMBER;
+
+			return checkEnd(cursor, err);
+		}
+
+		GameMsgParseError parsePiecePositions(string_view param, PiecePosition* positions,
+		                                      size_t maxCount, size_t& count)
+		{
+			Cursor cursor(param);
+			count = 0;
+
+			auto err = readPieceMap(cursor, [](PieceType) { }, [&](PieceType type, HexCoordinate<6> coord) {
+				if (count == maxCount)
+					return Error::TOO_MANY_PIECES;
+
+				positions[count++] = {type, coord};
+				return Error::NONE;
+			});
+
+			return checkEnd(cursor, err);
+		}
+
+		GameMsgParseError parsePieceMap(string_view param, PieceMap& map)
+		{
+			Cursor cursor(param);
+
+			auto err = readPieceMap(cursor,
+				[&](PieceType type) { map[type]; },
+				[&](PieceType type, HexCoordinate<6> coord) {
+					map[type].insert(coord);
+					return Error::NONE;
+				}
+			);
+
+			return checkEnd(cursor, err);
+		}
+	}
+}
@@ -0,0 +1,218 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvws/game_msg_writer.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cyvasse/hexagon.hpp>
+
+namespace cyvws
+{
+	using namespace std;
+	using namespace cyvasse;
+
+	// Json::Value stores object members in a map, so the writer has to
+	// emit keys in lexicographical order to produce the same output.
+
+	namespace
+	{
+		typedef array<string, Hexagon<6>::tileCount> CoordStrArray;
+		typedef array<string, pieceTypeCount> PieceTypeStrArray;
+
+		// quoted coordinate strings, indexed by Hexagon<6>::getIndex()
+		const CoordStrArray& getCoordStrings()
+		{
+			static const CoordStrArray coordStrings = [] {
+				CoordStrArray ret;
+
+				for (uint16_t i = 0; i < Hexagon<6>::tileCount; i++)
+					ret[i] = '"' + Hexagon<6>::getCoordinate(i).toString() + '"';
+
+				return ret;
+			}();
+
+			return coordStrings;
+		}
+
+		// quoted piece type strings, indexed by the PieceType value
+		const PieceTypeStrArray& getPieceTypeStrings()
+		{
+			static const PieceTypeStrArray pieceTypeStrings = [] {
+				PieceTypeStrArray ret;
+
+				for (size_t i = 0; i < pieceTypeCount; i++)
+					ret[i] = '"' + string(PieceTypeToStr(static_cast<PieceType>(i))) + '"';
+
+				return ret;
+			}();
+
+			return pieceTypeStrings;
+		}
+
+		// piece types sorted by their string representation
+		const array<PieceType, pieceTypeCount>& getSortedPieceTypes()
+		{
+			static const array<PieceType, pieceTypeCount> sortedPieceTypes = [] {
+				array<PieceType, pieceTypeCount> ret;
+
+				for (size_t i = 0; i < pieceTypeCount; i++)
+					ret[i] = static_cast<PieceType>(i);
+
+				sort(ret.begin(), ret.end(), [](PieceType a, PieceType b) {
+					return PieceTypeToStr(a) < PieceTypeToStr(b);
+				});
+
+				return ret;
+			}();
+
+			return sortedPieceTypes;
+		}
+	}
+
+	GameMsgWriter::GameMsgWriter(size_t reserve)
+	{
+		m_buffer.reserve(reserve);
+	}
+
+	void GameMsgWriter::begin(const char* action)
+	{
+		m_buffer.clear();
+		m_buffer += "{\"msgData\":{\"action\":\"";
+		m_buffer += action;
+		m_buffer += '"';
+	}
+
+	void GameMsgWriter::end()
+	{
+		m_buffer += "},\"msgType\":\"gameMsg\"}";
+	}
+
+	void GameMsgWriter::appendCoord(HexCoordinate<6> coord)
+	{
+		m_buffer += getCoordStrings()[Hexagon<6>::getIndex(coord)];
+	}
+
+	void GameMsgWriter::appendPieceType(PieceType type)
+	{
+		m_buffer += getPieceTypeStrings().at(static_cast<size_t>(type));
+	}
+
+	const string& GameMsgWriter::setOpeningArray(const PieceMap& map)
+	{
+		begin("setOpeningArray");
+
+		// json::gameMsg() omits a null param
+		if (!map.empty())
+		{
+			m_buffer += ",\"param\":{";
+
+			bool first = true;
+			for (auto type : getSortedPieceTypes())
+			{
+				auto it = map.find(type);
+				if (it == map.end())
+					continue;
+
+				if (!first)
+					m_buffer += ',';
+
+				first = false;
+
+				appendPieceType(type);
+				m_buffer += ':';
+
+				// json::pieceMap() leaves the member null if there are no coordinates
+				if (it->second.empty())
+				{
+					m_buffer += "null";
+					continue;
+				}
+
+				m_buffer += '[';
+
+				bool firstCoord = true;
+				for (auto coord : it->second)
+				{
+					if (!firstCoord)
+						m_buffer += ',';
+
+					firstCoord = false;
+					appendCoord(coord);
+				}
+
+				m_buffer += ']';
+			}
+
+			m_buffer += '}';
+		}
+
+		end();
+		return m_buffer;
+	}
+
+	const string& GameMsgWriter::setIsReady()
+	{
+		begin("setIsReady");
+		end();
+		return m_buffer;
+	}
+
+	const string& GameMsgWriter::move(PieceType pieceType, HexCoordinate<6> oldPos, HexCoordinate<6> newPos)
+	{
+		begin("move");
+		m_buffer += ",\"param\":{\"newPos\":";
+		appendCoord(newPos);
+		m_buffer += ",\"oldPos\":";
+		appendCoord(oldPos);
+		m_buffer += ",\"pieceType\":";
+		appendPieceType(pieceType);
+		m_buffer += '}';
+		end();
+		return m_buffer;
+	}
+
+	const string& GameMsgWriter::moveCapture(PieceType atkPT, HexCoordinate<6> oldPos, HexCoordinate<6> newPos,
+	                                         PieceType defPT, HexCoordinate<6> defPiecePos)
+	{
+		begin("moveCapture");
+		m_buffer += ",\"param\":{\"atkPiece\":{\"newPos\":";
+		appendCoord(newPos);
+		m_buffer += ",\"oldPos\":";
+		appendCoord(oldPos);
+		m_buffer += ",\"pieceType\":";
+		appendPieceType(atkPT);
+		m_buffer += "},\"defPiece\":{\"pieceType\":";
+		appendPieceType(defPT);
+		m_buffer += ",\"pos\":";
+		appendCoord(defPiecePos);
+		m_buffer += "}}";
+		end();
+		return m_buffer;
+	}
+
+	const string& GameMsgWriter::promote(PieceType origType, PieceType newType)
+	{
+		begin("promote");
+		m_buffer += ",\"param\":{\"newType\":";
+		appendPieceType(newType);
+		m_buffer += ",\"origType\":";
+		appendPieceType(origType);
+		m_buffer += '}';
+		end();
+		return m_buffer;
+	}
+}
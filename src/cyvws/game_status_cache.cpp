@@ -0,0 +1,68 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvws/game_status_cache.hpp>
+
+#include <cassert>
+#include <json/value.h>
+#include <cyvasse/match.hpp>
+#include <cyvws/json_server_reply.hpp>
+#include <cyvws/server_reply.hpp>
+
+using namespace std;
+
+namespace cyvws
+{
+	shared_ptr<const string> GameStatusCache::get()
+	{
+		if (!m_gameStatus || m_version != m_match.getVersion())
+		{
+			auto encoded = EncodedMsg::fromJson(json::gameStatus(m_match));
+
+			m_gameStatus = make_shared<const string>(encoded.getPayload());
+			m_version = m_match.getVersion();
+			m_rebuildCount++;
+		}
+
+		return m_gameStatus;
+	}
+
+	EncodedMsg GameStatusCache::joinGameReply(unsigned msgID, const Json::Value& replyData, bool withFrame)
+	{
+		assert(!replyData.isMember(GAME_STATUS));
+
+		auto gameStatus = get();
+		auto reply = EncodedMsg::fromJson(json::serverReply(msgID, replyData));
+		string str(reply.getPayload());
+
+		// the members of a message are written in alphabetical order, so the
+		// compact serialization ends with the closing braces of replyData and
+		// the message. the cached gameStatus is spliced in before the first.
+		// if the writer ever does something else, build the reply normally.
+		if (str.size() < 2 || str.compare(str.size() - 2, 2, "}}") != 0)
+		{
+			Json::Value fullReplyData(replyData);
+			fullReplyData[GAME_STATUS] = json::gameStatus(m_match);
+
+			return EncodedMsg::fromJson(json::serverReply(msgID, fullReplyData), withFrame);
+		}
+
+		string member = string(replyData.empty() ? "" : ",") + "\"" + GAME_STATUS + "\":" + *gameStatus;
+		str.insert(str.size() - 2, member);
+
+		return EncodedMsg(MsgEncoding::JSON, str, withFrame);
+	}
+}
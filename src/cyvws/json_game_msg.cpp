@@ -25,11 +25,19 @@ namespace cyvws
 {
 	namespace json
 	{
+		namespace
+		{
+			// enum and coordinate strings are null-terminated and static,
+			// so Json::StaticString can refer to them without copying
+			Json::StaticString toJson(string_view str)
+			{ return Json::StaticString(str.data()); }
+		}
+
 		Json::Value piecePosition(PieceType pieceType, HexCoordinate<6> pos)
 		{
 			Json::Value data;
-			data[PIECE_TYPE] = PieceTypeToStr(pieceType);
-			data[POS]        = pos.toString();
+			data[PIECE_TYPE] = toJson(PieceTypeToStr(pieceType));
+			data[POS]        = toJson(pos.toStringView());
 
 			return data;
 		}
@@ -53,9 +61,9 @@ namespace cyvws
 		Json::Value movement(PieceType pieceType, HexCoordinate<6> oldPos, HexCoordinate<6> newPos)
 		{
 			Json::Value data;
-			data[PIECE_TYPE] = PieceTypeToStr(pieceType);
-			data[OLD_POS]    = oldPos.toString();
-			data[NEW_POS]    = newPos.toString();
+			data[PIECE_TYPE] = toJson(PieceTypeToStr(pieceType));
+			data[OLD_POS]    = toJson(oldPos.toStringView());
+			data[NEW_POS]    = toJson(newPos.toStringView());
 
 			return data;
 		}
@@ -73,11 +81,11 @@ namespace cyvws
 		                        PieceType defPT, HexCoordinate<6> defPiecePos)
 		{
 			Json::Value data;
-			data[ATK_PIECE][PIECE_TYPE] = PieceTypeToStr(atkPT);
-			data[ATK_PIECE][OLD_POS]    = oldPos.toString();
-			data[ATK_PIECE][NEW_POS]    = newPos.toString();
-			data[DEF_PIECE][PIECE_TYPE] = PieceTypeToStr(defPT);
-			data[DEF_PIECE][POS]        = defPiecePos.toString();
+			data[ATK_PIECE][PIECE_TYPE] = toJson(PieceTypeToStr(atkPT));
+			data[ATK_PIECE][OLD_POS]    = toJson(oldPos.toStringView());
+			data[ATK_PIECE][NEW_POS]    = toJson(newPos.toStringView());
+			data[DEF_PIECE][PIECE_TYPE] = toJson(PieceTypeToStr(defPT));
+			data[DEF_PIECE][POS]        = toJson(defPiecePos.toStringView());
 
 			return data;
 		}
@@ -99,10 +107,10 @@ namespace cyvws
 
 			for (const auto& it : map)
 			{
-				auto& pieceTypeArr = val[PieceTypeToStr(it.first)];
+				auto& pieceTypeArr = val[toJson(PieceTypeToStr(it.first))];
 
 				for (const auto& coord : it.second)
-					pieceTypeArr.append(coord.toString());
+					pieceTypeArr.append(toJson(coord.toStringView()));
 			}
 
 			return val;
@@ -126,8 +134,8 @@ namespace cyvws
 		Json::Value promotion(PieceType origType, PieceType newType)
 		{
 			Json::Value data;
-			data[ORIG_TYPE] = PieceTypeToStr(origType);
-			data[NEW_TYPE]  = PieceTypeToStr(newType);
+			data[ORIG_TYPE] = toJson(PieceTypeToStr(origType));
+			data[NEW_TYPE]  = toJson(PieceTypeToStr(newType));
 
 			return data;
 		}
@@ -167,5 +175,24 @@ namespace cyvws
 
 		Json::Value gameMsgPromote(PieceType origType, PieceType newType)
 		{ return gameMsg(GameMsgAction::PROMOTE, promotion(origType, newType)); }
+
+		Json::Value gameMsgAck(unsigned msgID)
+		{
+			Json::Value msg;
+			msg[MSG_TYPE] = MsgType::GAME_MSG_ACK;
+			msg[MSG_ID]   = msgID;
+
+			return msg;
+		}
+
+		Json::Value gameMsgErr(unsigned msgID, const string& error)
+		{
+			Json::Value msg;
+			msg[MSG_TYPE]  = MsgType::GAME_MSG_ERR;
+			msg[MSG_ID]    = msgID;
+			msg[MSG_ERROR] = error;
+
+			return msg;
+		}
 	}
 }
@@ -36,6 +36,18 @@ namespace cyvws
 			return val;
 		}
 
+		Json::Value notificationBatch(const vector<Json::Value>& notificationDatas)
+		{
+			Json::Value data;
+			data[TYPE] = NotificationType::BATCH;
+
+			auto& notifications = data[NOTIFICATIONS] = Json::Value(Json::arrayValue);
+			for (auto&& notificationData : notificationDatas)
+				notifications.append(notificationData);
+
+			return notification(data);
+		}
+
 		Json::Value commErr(const string& errMsg)
 		{
 			Json::Value data;
@@ -45,25 +57,71 @@ namespace cyvws
 			return notification(data);
 		}
 
-		Json::Value listUpdate(const string& listName, const GamesListMap& curList)
+		GamesListMap gamesListContent(const Json::Value& content)
 		{
-			Json::Value data;
-			data[TYPE]      = NotificationType::LIST_UPDATE;
-			data[LIST_NAME] = listName;
+			GamesListMap games;
+			for (auto&& gameVal : content)
+			{
+				games.emplace(gameVal[MATCH_ID].asString(), GamesListMappedType {
+					gameVal[TITLE].asString(),
+					cyvasse::StrToPlayersColor(gameVal[PLAY_AS].asString())
+				});
+			}
+
+			return games;
+		}
 
-			auto& listContent = data[LIST_CONTENT] = Json::Value(Json::arrayValue);
-			for (auto&& game : curList)
+		static Json::Value gamesListContent(const GamesListMap& games)
+		{
+			Json::Value content(Json::arrayValue);
+			for (auto&& game : games)
 			{
 				Json::Value gameVal;
 				gameVal[MATCH_ID] = game.first;
 				gameVal[TITLE]    = game.second.title;
 				//gameVal[RULE_SET]
-				gameVal[PLAY_AS]  = PlayersColorToStr(game.second.playAs);
+				gameVal[PLAY_AS]  = string(PlayersColorToStr(game.second.playAs));
 				//gameVal[EXTRA_RULES]
 
-				listContent.append(gameVal);
+				content.append(gameVal);
 			}
 
+			return content;
+		}
+
+		Json::Value listUpdate(const string& listName, const GamesListMap& curList)
+		{
+			Json::Value data;
+			data[TYPE]         = NotificationType::LIST_UPDATE;
+			data[LIST_NAME]    = listName;
+			data[LIST_CONTENT] = gamesListContent(curList);
+
+			return notification(data);
+		}
+
+		Json::Value listUpdate(const string& listName, const GamesListMap& curList, unsigned version)
+		{
+			auto val = listUpdate(listName, curList);
+			val[NOTIFICATION_DATA][LIST_VERSION] = version;
+
+			return val;
+		}
+
+		Json::Value listDelta(const string& listName, unsigned baseVersion, unsigned version,
+			const GamesListMap& added, const GamesListMap& modified, const vector<string>& removed)
+		{
+			Json::Value data;
+			data[TYPE]         = NotificationType::LIST_DELTA;
+			data[LIST_NAME]    = listName;
+			data[BASE_VERSION] = baseVersion;
+			data[LIST_VERSION] = version;
+			data[ADDED]        = gamesListContent(added);
+			data[MODIFIED]     = gamesListContent(modified);
+
+			auto& removedVal = data[REMOVED] = Json::Value(Json::arrayValue);
+			for (auto&& matchID : removed)
+				removedVal.append(matchID);
+
 			return notification(data);
 		}
 
@@ -16,10 +16,16 @@
 
 #include <cyvws/json_server_reply.hpp>
 
+#include <array>
+#include <cyvasse/match.hpp>
 #include <cyvws/common.hpp>
+#include <cyvws/init_comm.hpp>
+#include <cyvws/json_game_msg.hpp>
 #include <cyvws/msg.hpp>
 #include <cyvws/server_reply.hpp>
 
+using namespace cyvasse;
+
 namespace cyvws
 {
 	namespace json
@@ -54,6 +60,15 @@ namespace cyvws
 			return json::serverReply(msgID, replyData);
 		}
 
+		Json::Value initCommSuccess(unsigned msgID, const std::string& protocolVersion)
+		{
+			Json::Value replyData;
+			replyData[SUCCESS]          = true;
+			replyData[PROTOCOL_VERSION] = protocolVersion;
+
+			return json::serverReply(msgID, replyData);
+		}
+
 		Json::Value createGameSuccess(unsigned msgID, const std::string& matchID, const std::string& playerID)
 		{
 			Json::Value replyData;
@@ -63,5 +78,25 @@ namespace cyvws
 
 			return json::serverReply(msgID, replyData);
 		}
+
+		Json::Value gameStatus(const Match& match)
+		{
+			Json::Value status;
+			status[SETUP] = match.inSetup();
+
+			// the setup of both players is secret until both are done
+			if (match.inSetup())
+				return status;
+
+			std::array<CoordPieceMap, 2> pieces;
+			for (auto&& it : match.getActivePieces())
+				pieces[it.second->getColor()].insert(it);
+
+			auto& positions = status[PIECE_POSITIONS];
+			for (auto color : {PlayersColor::WHITE, PlayersColor::BLACK})
+				positions[std::string(PlayersColorToStr(color))] = pieceMap(pieces[color]);
+
+			return status;
+		}
 	}
 }
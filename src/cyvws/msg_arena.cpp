@@ -0,0 +1,90 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvws/msg_arena.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+namespace cyvws
+{
+	MsgArena::MsgArena(size_t blockSize)
+		: m_blockSize(blockSize)
+	{
+		m_blocks.reserve(4);
+	}
+
+	void MsgArena::addBlock(size_t minSize)
+	{
+		size_t size = max(minSize, m_blocks.empty() ? m_blockSize : m_blocks.back().size * 2);
+
+		m_blocks.push_back({unique_ptr<char[]>(new char[size]), size});
+		m_blockAllocCount++;
+
+		m_pos = m_blocks.back().data.get();
+		m_end = m_pos + size;
+	}
+
+	void* MsgArena::allocate(size_t size, size_t align)
+	{
+		auto alignPos = [align](char* pos) {
+			auto addr = reinterpret_cast<uintptr_t>(pos);
+			return reinterpret_cast<char*>((addr + align - 1) & ~(uintptr_t(align) - 1));
+		};
+
+		char* ptr = m_pos ? alignPos(m_pos) : nullptr;
+		if (!ptr || ptr + size > m_end)
+		{
+			// new[] returns memory suitable for any fundamental alignment
+			addBlock(size + align);
+			ptr = alignPos(m_pos);
+		}
+
+		m_pos = ptr + size;
+		m_bytesUsed += size;
+
+		return ptr;
+	}
+
+	void MsgArena::reset()
+	{
+		if (m_blocks.size() > 1)
+		{
+			size_t size = getCapacity();
+
+			m_blocks.clear();
+			addBlock(size);
+		}
+		else if (!m_blocks.empty())
+		{
+			m_pos = m_blocks.front().data.get();
+			m_end = m_pos + m_blocks.front().size;
+		}
+
+		m_bytesUsed = 0;
+	}
+
+	size_t MsgArena::getCapacity() const
+	{
+		size_t capacity = 0;
+		for (auto&& block : m_blocks)
+			capacity += block.size;
+
+		return capacity;
+	}
+}
@@ -0,0 +1,330 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvws/msg_compression.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <json/value.h>
+#include <json/writer.h>
+#include <zlib.h>
+#include <cyvasse/hexagon.hpp>
+#include <cyvasse/piece_type.hpp>
+#include <cyvws/game_msg.hpp>
+#include <cyvws/json_game_msg.hpp>
+#include <cyvws/json_notification.hpp>
+#include <cyvws/json_server_reply.hpp>
+#include <cyvws/msg.hpp>
+
+using namespace std;
+using namespace cyvasse;
+
+namespace cyvws
+{
+	namespace
+	{
+		// the empty stored block a sync flush ends with
+		const unsigned char syncFlushTail[] = {0x00, 0x00, 0xff, 0xff};
+
+		bool isStructural(char c)
+		{ return strchr("{}[]:,\"", c) != nullptr && c != '\0'; }
+
+		// between two characters of which at least one is structural JSON
+		bool isTokenBoundary(const string& str, size_t pos)
+		{
+			return pos == 0 || pos == str.size() || isStructural(str[pos - 1]) || isStructural(str[pos]);
+		}
+
+		vector<string> defaultSamples()
+		{
+			Json::StreamWriterBuilder builder;
+			builder["indentation"] = "";
+
+			vector<Json::Value> msgs;
+			unsigned msgID = 1;
+
+			// game messages as sent by clients (with msgID) and relayed by the server (without)
+			auto addGameMsg = [&](Json::Value msg) {
+				msgs.push_back(msg);
+				msg[MSG_ID] = msgID++;
+				msgs.push_back(move(msg));
+			};
+
+			PieceMap openingArray;
+			for (size_t i = 0; i < pieceTypeCount; i++)
+			{
+				auto type = static_cast<PieceType>(i);
+				auto oldPos = Hexagon<6>::getCoordinate(static_cast<uint16_t>(i * 7));
+				auto newPos = Hexagon<6>::getCoordinate(static_cast<uint16_t>(i * 7 + 1));
+				auto defType = static_cast<PieceType>((i + 1) % pieceTypeCount);
+
+				addGameMsg(json::gameMsgMove(type, oldPos, newPos));
+				addGameMsg(json::gameMsgMoveCapture(type, oldPos, newPos, defType, newPos));
+				addGameMsg(json::gameMsgPromote(type, defType));
+
+				openingArray[type].insert(oldPos);
+				openingArray[type].insert(newPos);
+			}
+
+			addGameMsg(json::gameMsgSetOpeningArray(openingArray));
+			addGameMsg(json::gameMsgSetIsReady());
+			addGameMsg(json::gameMsg(GameMsgAction::END_TURN, Json::Value()));
+			addGameMsg(json::gameMsg(GameMsgAction::RESIGN, Json::Value()));
+
+			for (unsigned i = 0; i < 4; i++)
+			{
+				msgs.push_back(json::gameMsgAck(msgID));
+				msgs.push_back(json::gameMsgErr(msgID, "invalidMove"));
+				msgs.push_back(json::requestSuccess(msgID));
+				msgs.push_back(json::requestErr(msgID, "gameNotFound"));
+				msgs.push_back(json::createGameSuccess(msgID, "NHVy", "a3f9Qk"));
+				msgs.push_back(json::userJoined("Guest " + to_string(msgID), i % 2, "player"));
+				msgs.push_back(json::userLeft("Guest " + to_string(msgID)));
+				msgs.push_back(json::usernameUpdate("Guest " + to_string(msgID), "jPlatte"));
+				msgID++;
+			}
+
+			GamesListMap games {
+				{"NHVy", {"Test user X", PlayersColor::BLACK}},
+				{"vnUM", {"jPlatte", PlayersColor::WHITE}}
+			};
+
+			msgs.push_back(json::listUpdate(GamesList::OPEN_RANDOM_GAMES, games, 12));
+			msgs.push_back(json::listUpdate(GamesList::RUNNING_PUBLIC_GAMES, games, 3));
+			msgs.push_back(json::listDelta(GamesList::OPEN_RANDOM_GAMES, 12, 13, games, {}, {"pQ3x"}));
+
+			vector<string> samples;
+			for (auto&& msg : msgs)
+				samples.push_back(Json::writeString(builder, msg));
+
+			return samples;
+		}
+	}
+
+	string trainDictionary(const vector<string>& samples, size_t maxSize)
+	{
+		constexpr size_t minLength = 4;
+		constexpr size_t maxLength = 64;
+
+		unordered_map<string, unsigned> counts;
+		for (auto&& sample : samples)
+		{
+			for (size_t begin = 0; begin < sample.size(); begin++)
+			{
+				if (!isTokenBoundary(sample, begin))
+					continue;
+
+				for (size_t end = begin + minLength; end <= min(sample.size(), begin + maxLength); end++)
+				{
+					if (isTokenBoundary(sample, end))
+						counts[sample.substr(begin, end - begin)]++;
+				}
+			}
+		}
+
+		// a match costs about three bytes, whatever is longer is saved
+		vector<pair<size_t, string>> candidates;
+		for (auto&& it : counts)
+		{
+			if (it.second > 1)
+				candidates.emplace_back(it.second * (it.first.size() - 3), it.first);
+		}
+
+		sort(candidates.begin(), candidates.end(), [](const pair<size_t, string>& a, const pair<size_t, string>& b) {
+			return a.first != b.first ? a.first > b.first : a.second < b.second;
+		});
+
+		vector<string> selected;
+		size_t size = 0;
+
+		for (auto&& candidate : candidates)
+		{
+			const auto& str = candidate.second;
+			if (size + str.size() > maxSize)
+				continue;
+
+			if (any_of(selected.begin(), selected.end(), [&](const string& s) { return s.find(str) != string::npos; }))
+				continue;
+
+			selected.push_back(str);
+			size += str.size();
+		}
+
+		// the most valuable strings go to the end, closest to the data
+		string dictionary;
+		dictionary.reserve(size);
+
+		for (auto it = selected.rbegin(); it != selected.rend(); ++it)
+			dictionary += *it;
+
+		return dictionary;
+	}
+
+	const string& defaultDictionary()
+	{
+		static const string dictionary = [] {
+			constexpr size_t maxSize = 4096;
+
+			// every coordinate occurs only a few times in the samples, but
+			// is in most game messages, so they all go at the start
+			string coords;
+			for (uint16_t i = 0; i < Hexagon<6>::tileCount; i++)
+				coords += '"' + Hexagon<6>::getCoordinate(i).toString() + '"';
+
+			return coords + trainDictionary(defaultSamples(), maxSize - coords.size());
+		}();
+
+		return dictionary;
+	}
+
+	uint32_t getDictionaryID(string_view dictionary)
+	{
+		auto adler = adler32(0, Z_NULL, 0);
+		return static_cast<uint32_t>(adler32(adler, reinterpret_cast<const Bytef*>(dictionary.data()),
+			static_cast<uInt>(dictionary.size())));
+	}
+
+	MsgDeflater::MsgDeflater(string_view dictionary, bool contextTakeover, int level)
+		: m_stream(new z_stream_s())
+		, m_dictionary(dictionary)
+		, m_buffer(1024, '\0')
+		, m_contextTakeover(contextTakeover)
+	{
+		// negative window bits: raw deflate data without zlib header
+		if (deflateInit2(m_stream.get(), level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+			throw runtime_error("deflateInit2() failed");
+
+		if (!m_dictionary.empty())
+			deflateSetDictionary(m_stream.get(), reinterpret_cast<const Bytef*>(m_dictionary.data()),
+				static_cast<uInt>(m_dictionary.size()));
+	}
+
+	MsgDeflater::~MsgDeflater()
+	{
+		deflateEnd(m_stream.get());
+	}
+
+	string_view MsgDeflater::compress(string_view msg)
+	{
+		auto stream = m_stream.get();
+
+		if (!m_contextTakeover)
+		{
+			deflateReset(stream);
+
+			if (!m_dictionary.empty())
+				deflateSetDictionary(stream, reinterpret_cast<const Bytef*>(m_dictionary.data()),
+					static_cast<uInt>(m_dictionary.size()));
+		}
+
+		stream->next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(msg.data()));
+		stream->avail_in = static_cast<uInt>(msg.size());
+
+		size_t size = 0;
+		do
+		{
+			if (size == m_buffer.size())
+				m_buffer.resize(m_buffer.size() * 2);
+
+			stream->next_out  = reinterpret_cast<Bytef*>(&m_buffer[size]);
+			stream->avail_out = static_cast<uInt>(m_buffer.size() - size);
+
+			deflate(stream, Z_SYNC_FLUSH);
+			size = m_buffer.size() - stream->avail_out;
+		}
+		while (stream->avail_out == 0);
+
+		// the receiver appends the tail again
+		return string_view(m_buffer.data(), size - sizeof(syncFlushTail));
+	}
+
+	MsgInflater::MsgInflater(string_view dictionary, bool contextTakeover, size_t maxMsgSize)
+		: m_stream(new z_stream_s())
+		, m_dictionary(dictionary)
+		, m_buffer(min<size_t>(1024, maxMsgSize + 1), '\0')
+		, m_maxMsgSize(maxMsgSize)
+		, m_contextTakeover(contextTakeover)
+	{
+		if (inflateInit2(m_stream.get(), -15) != Z_OK)
+			throw runtime_error("inflateInit2() failed");
+
+		// raw inflate takes the dictionary right away instead of asking for it
+		if (!m_dictionary.empty())
+			inflateSetDictionary(m_stream.get(), reinterpret_cast<const Bytef*>(m_dictionary.data()),
+				static_cast<uInt>(m_dictionary.size()));
+	}
+
+	MsgInflater::~MsgInflater()
+	{
+		inflateEnd(m_stream.get());
+	}
+
+	void MsgInflater::resetStream()
+	{
+		inflateReset(m_stream.get());
+
+		if (!m_dictionary.empty())
+			inflateSetDictionary(m_stream.get(), reinterpret_cast<const Bytef*>(m_dictionary.data()),
+				static_cast<uInt>(m_dictionary.size()));
+	}
+
+	optional<string_view> MsgInflater::decompress(string_view data)
+	{
+		auto stream = m_stream.get();
+
+		if (!m_contextTakeover)
+			resetStream();
+
+		size_t size = 0;
+
+		auto inflateData = [&](const void* in, size_t inSize) {
+			stream->next_in  = reinterpret_cast<Bytef*>(const_cast<void*>(in));
+			stream->avail_in = static_cast<uInt>(inSize);
+
+			do
+			{
+				if (size == m_buffer.size())
+				{
+					if (size > m_maxMsgSize)
+						return false;
+
+					m_buffer.resize(min(m_buffer.size() * 2, m_maxMsgSize + 1));
+				}
+
+				stream->next_out  = reinterpret_cast<Bytef*>(&m_buffer[size]);
+				stream->avail_out = static_cast<uInt>(m_buffer.size() - size);
+
+				int res = inflate(stream, Z_SYNC_FLUSH);
+				size = m_buffer.size() - stream->avail_out;
+
+				// data and tail are one sync-flushed block sequence, a final block isn't sent
+				if (res != Z_OK && !(res == Z_BUF_ERROR && stream->avail_in == 0))
+					return false;
+			}
+			while (stream->avail_in > 0 || stream->avail_out == 0);
+
+			return size <= m_maxMsgSize;
+		};
+
+		if (!inflateData(data.data(), data.size()) || !inflateData(syncFlushTail, sizeof(syncFlushTail)))
+			return nullopt;
+
+		return string_view(m_buffer.data(), size);
+	}
+}
@@ -0,0 +1,556 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvws/msg_validator.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <json/reader.h>
+#include <json/value.h>
+#include <cyvasse/hexcoordinate.hpp>
+#include <cyvasse/piece_type.hpp>
+#include <cyvasse/players_color.hpp>
+#include <cyvws/msg.hpp>
+#include <cyvws/notification.hpp>
+
+using namespace std;
+using namespace cyvasse;
+
+namespace cyvws
+{
+	// Everything a client sends to the server, see ws-msg-examples
+	static const char inboundDescription[] = R"([
+		{
+			"msgType": "chatMsg",
+			"msgID": "<uint>",
+			"msgData": { "content": "<string>" }
+		},
+		{
+			"msgType": "gameMsg",
+			"msgID": "<uint>",
+			"msgData": { "action": "endTurn" }
+		},
+		{
+			"msgType": "gameMsg",
+			"msgID": "<uint>",
+			"msgData": {
+				"action": "move",
+				"param": { "pieceType": "<pieceType>", "oldPos": "<coord>", "newPos": "<coord>" }
+			}
+		},
+		{
+			"msgType": "gameMsg",
+			"msgID": "<uint>",
+			"msgData": {
+				"action": "moveCapture",
+				"param": {
+					"atkPiece": { "pieceType": "<pieceType>", "oldPos": "<coord>", "newPos": "<coord>" },
+					"defPiece": { "pieceType": "<pieceType>", "pos": "<coord>" }
+				}
+			}
+		},
+		{
+			"msgType": "gameMsg",
+			"msgID": "<uint>",
+			"msgData": {
+				"action": "promote",
+				"param": { "origType": "<pieceType>", "newType": "<pieceType>" }
+			}
+		},
+		{
+			"msgType": "gameMsg",
+			"msgID": "<uint>",
+			"msgData": { "action": "resign" }
+		},
+		{
+			"msgType": "gameMsg",
+			"msgID": "<uint>",
+			"msgData": { "action": "setIsReady" }
+		},
+		{
+			"msgType": "gameMsg",
+			"msgID": "<uint>",
+			"msgData": {
+				"action": "setOpeningArray",
+				"param": { "<pieceType>": [ "<coord>" ] }
+			}
+		},
+		{
+			"msgType": "serverRequest",
+			"msgID": "<uint>",
+			"requestData": {
+				"action": "createGame",
+				"param": {
+					"ruleSet": "<string>",
+					"color": "<color>",
+					"random": "<bool>",
+					"public": "<bool>",
+					"?extraRules": [ "<string>" ],
+					"?userInfo": { "userName": "<string>", "sessionToken": "<string>" }
+				}
+			}
+		},
+		{
+			"msgType": "serverRequest",
+			"msgID": "<uint>",
+			"requestData": {
+				"action": "initComm",
+				"param": { "protocolVersion": "<string>" }
+			}
+		},
+		{
+			"msgType": "serverRequest",
+			"msgID": "<uint>",
+			"requestData": {
+				"action": "joinGame",
+				"param": { "matchID": "<string>" }
+			}
+		},
+		{
+			"msgType": "serverRequest",
+			"msgID": "<uint>",
+			"requestData": {
+				"action": "setUsername",
+				"param": "<string>"
+			}
+		},
+		{
+			"msgType": "serverRequest",
+			"msgID": "<uint>",
+			"requestData": {
+				"action": "subscrGameListUpdates",
+				"param": { "ruleSet": "<string>", "lists": [ "<gamesList>" ] }
+			}
+		},
+		{
+			"msgType": "serverRequest",
+			"msgID": "<uint>",
+			"requestData": {
+				"action": "unsubscrGameListUpdates",
+				"param": { "ruleSet": "<string>", "lists": [ "<gamesList>" ] }
+			}
+		}
+	])";
+
+	static string_view getStringView(const Json::Value& val)
+	{
+		const char* begin;
+		const char* end;
+		val.getString(&begin, &end);
+
+		return string_view(begin, static_cast<size_t>(end - begin));
+	}
+
+	string MsgValidationResult::toString() const
+	{
+		string errStr(MsgValidationErrorToStr(error));
+		return path.empty() ? errStr : path + ": " + errStr;
+	}
+
+	MsgValidator::MsgValidator(const Json::Value& description)
+	{
+		if (!description.isArray())
+			throw invalid_argument("MsgValidator: the description has to be an array of message schemas");
+
+		map<string, vector<size_t>> roots;
+		for (auto&& msgDescription : description)
+		{
+			auto root = compile(msgDescription);
+
+			const auto& node = m_nodes[root];
+			auto it = find_if(node.members.begin(), node.members.end(),
+				[](const Member& member) { return member.key == MSG_TYPE; });
+
+			if (node.type != NodeType::OBJECT || it == node.members.end() || m_nodes[it->node].type != NodeType::LITERAL)
+				throw invalid_argument("MsgValidator: every message schema needs a constant msgType");
+
+			roots[m_nodes[it->node].literal].push_back(root);
+		}
+
+		for (auto&& it : roots)
+		{
+			auto& schemas = m_msgTypes[it.first];
+
+			if (it.second.size() == 1)
+				schemas.variants.emplace(string(), it.second.front());
+			else
+				findDiscriminator(schemas, it.second);
+		}
+	}
+
+	size_t MsgValidator::compile(const Json::Value& description)
+	{
+		static const map<string, NodeType> typeNames {
+			{"<any>", NodeType::ANY},
+			{"<bool>", NodeType::BOOL},
+			{"<uint>", NodeType::UINT},
+			{"<string>", NodeType::STRING},
+			{"<coord>", NodeType::COORD},
+			{"<pieceType>", NodeType::PIECE_TYPE},
+			{"<color>", NodeType::COLOR},
+			{"<gamesList>", NodeType::GAMES_LIST}
+		};
+
+		// children are compiled first, m_nodes may be reallocated meanwhile
+		Node node;
+
+		if (description.isString())
+		{
+			auto str = description.asString();
+
+			if (str.size() > 1 && str.front() == '<' && str.back() == '>')
+			{
+				auto it = typeNames.find(str);
+				if (it == typeNames.end())
+					throw invalid_argument("MsgValidator: unknown type " + str);
+
+				node.type = it->second;
+			}
+			else
+			{
+				node.type = NodeType::LITERAL;
+				node.literal = move(str);
+			}
+		}
+		else if (description.isArray())
+		{
+			if (description.size() != 1)
+				throw invalid_argument("MsgValidator: array schemas need exactly one element");
+
+			node.type = NodeType::ARRAY;
+			node.element = compile(description[0]);
+		}
+		else if (description.isObject())
+		{
+			auto keys = description.getMemberNames();
+
+			if (keys.size() == 1 && keys.front().front() == '<')
+			{
+				auto it = typeNames.find(keys.front());
+				if (it == typeNames.end() || it->second == NodeType::ANY)
+					throw invalid_argument("MsgValidator: invalid map key type " + keys.front());
+
+				node.type = NodeType::MAP;
+				node.keyType = it->second;
+				node.element = compile(description[keys.front()]);
+			}
+			else
+			{
+				node.type = NodeType::OBJECT;
+
+				for (auto&& key : keys)
+				{
+					bool optional = !key.empty() && key.front() == '?';
+					auto child = compile(description[key]);
+
+					node.members.push_back({optional ? key.substr(1) : key, optional, child});
+				}
+			}
+		}
+		else
+			throw invalid_argument("MsgValidator: schema values have to be strings, arrays or objects");
+
+		m_nodes.push_back(move(node));
+		return m_nodes.size() - 1;
+	}
+
+	void MsgValidator::findDiscriminator(MsgTypeSchemas& schemas, const vector<size_t>& roots)
+	{
+		typedef vector<pair<vector<string>, string>> LiteralList;
+
+		// the constant strings of required members, with their path
+		function<void(size_t, vector<string>&, LiteralList&)> collectLiterals =
+			[&](size_t index, vector<string>& path, LiteralList& literals) {
+				const auto& node = m_nodes[index];
+
+				if (node.type == NodeType::LITERAL)
+					literals.emplace_back(path, node.literal);
+				else if (node.type == NodeType::OBJECT)
+				{
+					for (auto&& member : node.members)
+					{
+						if (member.optional || (path.empty() && member.key == MSG_TYPE))
+							continue;
+
+						path.push_back(member.key);
+						collectLiterals(member.node, path, literals);
+						path.pop_back();
+					}
+				}
+			};
+
+		vector<LiteralList> literals(roots.size());
+		for (size_t i = 0; i < roots.size(); i++)
+		{
+			vector<string> path;
+			collectLiterals(roots[i], path, literals[i]);
+		}
+
+		for (auto&& candidate : literals.front())
+		{
+			map<string, size_t> variants;
+
+			for (size_t i = 0; i < roots.size(); i++)
+			{
+				auto it = find_if(literals[i].begin(), literals[i].end(),
+					[&](const LiteralList::value_type& literal) { return literal.first == candidate.first; });
+
+				if (it == literals[i].end() || !variants.emplace(it->second, roots[i]).second)
+					break;
+			}
+
+			if (variants.size() == roots.size())
+			{
+				schemas.discriminator = candidate.first;
+				schemas.variants = move(variants);
+				return;
+			}
+		}
+
+		throw invalid_argument("MsgValidator: no constant member tells the schemas of a msgType apart");
+	}
+
+	bool MsgValidator::checkString(NodeType type, string_view str)
+	{
+		switch (type)
+		{
+			case NodeType::STRING:     return true;
+			case NodeType::COORD:      return bool(HexCoordinate<6>::tryParse(str));
+			case NodeType::PIECE_TYPE: return bool(tryStrToPieceType(str));
+			case NodeType::COLOR:      return bool(tryStrToPlayersColor(str));
+			case NodeType::GAMES_LIST:
+				return str == GamesList::OPEN_RANDOM_GAMES || str == GamesList::RUNNING_PUBLIC_GAMES;
+			default:
+				return false;
+		}
+	}
+
+	bool MsgValidator::check(size_t index, const Json::Value& val, MsgValidationResult& res, vector<string>& path) const
+	{
+		const auto& node = m_nodes[index];
+
+		auto fail = [&](MsgValidationError error) {
+			res.error = error;
+			return false;
+		};
+
+		switch (node.type)
+		{
+			case NodeType::ANY:
+				return true;
+			case NodeType::BOOL:
+				return val.isBool() || fail(MsgValidationError::UNEXPECTED_TYPE);
+			case NodeType::UINT:
+				return val.isUInt() || fail(MsgValidationError::UNEXPECTED_TYPE);
+			case NodeType::LITERAL:
+				if (!val.isString())
+					return fail(MsgValidationError::UNEXPECTED_TYPE);
+
+				return getStringView(val) == node.literal || fail(MsgValidationError::UNEXPECTED_VALUE);
+			case NodeType::STRING:
+			case NodeType::COORD:
+			case NodeType::PIECE_TYPE:
+			case NodeType::COLOR:
+			case NodeType::GAMES_LIST:
+				if (!val.isString())
+					return fail(MsgValidationError::UNEXPECTED_TYPE);
+
+				return checkString(node.type, getStringView(val)) || fail(MsgValidationError::INVALID_VALUE);
+			case NodeType::OBJECT:
+				if (!val.isObject())
+					return fail(MsgValidationError::UNEXPECTED_TYPE);
+
+				for (auto&& member : node.members)
+				{
+					auto child = val.find(member.key.data(), member.key.data() + member.key.size());
+
+					if (!child)
+					{
+						if (member.optional)
+							continue;
+
+						path.push_back(member.key);
+						return fail(MsgValidationError::MISSING_MEMBER);
+					}
+
+					if (!check(member.node, *child, res, path))
+					{
+						path.push_back(member.key);
+						return false;
+					}
+				}
+
+				return true;
+			case NodeType::ARRAY:
+				if (!val.isArray())
+					return fail(MsgValidationError::UNEXPECTED_TYPE);
+
+				for (Json::ArrayIndex i = 0; i < val.size(); i++)
+				{
+					if (!check(node.element, val[i], res, path))
+					{
+						path.push_back('[' + to_string(i) + ']');
+						return false;
+					}
+				}
+
+				return true;
+			case NodeType::MAP:
+				if (!val.isObject())
+					return fail(MsgValidationError::UNEXPECTED_TYPE);
+
+				for (auto it = val.begin(); it != val.end(); ++it)
+				{
+					const char* end;
+					const char* begin = it.memberName(&end);
+					string_view key(begin, static_cast<size_t>(end - begin));
+
+					if (!checkString(node.keyType, key))
+					{
+						path.emplace_back(key);
+						return fail(MsgValidationError::INVALID_VALUE);
+					}
+
+					// json::pieceMap() writes null for piece types without coordinates
+					if (!it->isNull() && !check(node.element, *it, res, path))
+					{
+						path.emplace_back(key);
+						return false;
+					}
+				}
+
+				return true;
+		}
+
+		return true;
+	}
+
+	MsgValidationResult MsgValidator::validate(const Json::Value& msg) const
+	{
+		MsgValidationResult res;
+		vector<string> path;
+
+		auto joinPath = [&] {
+			// the segments were added from the inside out
+			for (auto it = path.rbegin(); it != path.rend(); ++it)
+			{
+				if (!res.path.empty() && it->front() != '[')
+					res.path += '.';
+
+				res.path += *it;
+			}
+
+			return res;
+		};
+
+		if (!msg.isObject())
+		{
+			res.error = MsgValidationError::UNEXPECTED_TYPE;
+			return res;
+		}
+
+		path.push_back(MSG_TYPE);
+
+		auto msgType = msg.find(MSG_TYPE, MSG_TYPE + sizeof(MSG_TYPE) - 1);
+		if (!msgType)
+		{
+			res.error = MsgValidationError::MISSING_MEMBER;
+			return joinPath();
+		}
+
+		if (!msgType->isString())
+		{
+			res.error = MsgValidationError::UNEXPECTED_TYPE;
+			return joinPath();
+		}
+
+		auto schemasIt = m_msgTypes.find(msgType->asString());
+		if (schemasIt == m_msgTypes.end())
+		{
+			res.error = MsgValidationError::UNKNOWN_MSG_TYPE;
+			return joinPath();
+		}
+
+		path.clear();
+
+		const auto& schemas = schemasIt->second;
+		auto root = schemas.variants.begin()->second;
+
+		if (!schemas.discriminator.empty())
+		{
+			const Json::Value* val = &msg;
+
+			for (auto&& key : schemas.discriminator)
+			{
+				if (!val->isObject())
+				{
+					res.error = MsgValidationError::UNEXPECTED_TYPE;
+					return joinPath();
+				}
+
+				path.insert(path.begin(), key);
+
+				val = val->find(key.data(), key.data() + key.size());
+				if (!val)
+				{
+					res.error = MsgValidationError::MISSING_MEMBER;
+					return joinPath();
+				}
+			}
+
+			if (!val->isString())
+			{
+				res.error = MsgValidationError::UNEXPECTED_TYPE;
+				return joinPath();
+			}
+
+			auto variantIt = schemas.variants.find(val->asString());
+			if (variantIt == schemas.variants.end())
+			{
+				res.error = MsgValidationError::UNKNOWN_VARIANT;
+				return joinPath();
+			}
+
+			root = variantIt->second;
+			path.clear();
+		}
+
+		if (!check(root, msg, res, path))
+			return joinPath();
+
+		return res;
+	}
+
+	const MsgValidator& MsgValidator::inbound()
+	{
+		static const MsgValidator validator = [] {
+			Json::Value description;
+			string errs;
+			istringstream stream(inboundDescription);
+
+			if (!Json::parseFromStream(Json::CharReaderBuilder(), stream, &description, &errs))
+				throw logic_error("MsgValidator: invalid inbound description: " + errs);
+
+			return MsgValidator(description);
+		}();
+
+		return validator;
+	}
+}
@@ -0,0 +1,236 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvws/notification_coalescer.hpp>
+
+#include <string>
+#include <cyvws/common.hpp>
+#include <cyvws/json_notification.hpp>
+#include <cyvws/msg.hpp>
+#include <cyvws/notification.hpp>
+
+using namespace std;
+
+namespace cyvws
+{
+	// helpers for the arrays of games in listUpdate and listDelta notifications
+
+	static Json::Value* findGame(Json::Value& games, const Json::Value& matchID)
+	{
+		for (auto& game : games)
+		{
+			if (game[MATCH_ID] == matchID)
+				return &game;
+		}
+
+		return nullptr;
+	}
+
+	static bool eraseGame(Json::Value& games, const Json::Value& matchID)
+	{
+		Json::Value remaining(Json::arrayValue);
+		bool found = false;
+
+		for (auto&& game : games)
+		{
+			// the removed array of listDelta only contains the matchIDs
+			if ((game.isObject() ? game[MATCH_ID] : game) == matchID)
+				found = true;
+			else
+				remaining.append(game);
+		}
+
+		games = remaining;
+		return found;
+	}
+
+	static void setGame(Json::Value& games, const Json::Value& game)
+	{
+		if (auto existing = findGame(games, game[MATCH_ID]))
+			*existing = game;
+		else
+			games.append(game);
+	}
+
+	// delta is applied on top of base, which has to be a listDelta at delta's base version
+	static void mergeListDelta(Json::Value& base, const Json::Value& delta)
+	{
+		for (auto&& game : delta[ADDED])
+		{
+			// removed and added again, so it was there before base
+			if (eraseGame(base[REMOVED], game[MATCH_ID]))
+				setGame(base[MODIFIED], game);
+			else
+				setGame(base[ADDED], game);
+		}
+
+		for (auto&& game : delta[MODIFIED])
+		{
+			if (auto added = findGame(base[ADDED], game[MATCH_ID]))
+				*added = game;
+			else
+				setGame(base[MODIFIED], game);
+		}
+
+		for (auto&& matchID : delta[REMOVED])
+		{
+			// added and removed within the batch, so the subscriber never needs to know
+			if (!eraseGame(base[ADDED], matchID))
+			{
+				eraseGame(base[MODIFIED], matchID);
+				base[REMOVED].append(matchID);
+			}
+		}
+
+		base[LIST_VERSION] = delta[LIST_VERSION];
+	}
+
+	// base is a listUpdate at delta's base version
+	static void applyListDelta(Json::Value& base, const Json::Value& delta)
+	{
+		auto& content = base[LIST_CONTENT];
+
+		for (auto&& matchID : delta[REMOVED])
+			eraseGame(content, matchID);
+		for (auto&& game : delta[ADDED])
+			setGame(content, game);
+		for (auto&& game : delta[MODIFIED])
+			setGame(content, game);
+
+		base[LIST_VERSION] = delta[LIST_VERSION];
+	}
+
+	static bool isListNotification(const Json::Value& notificationData, const Json::Value& listName)
+	{
+		return (notificationData[TYPE] == NotificationType::LIST_UPDATE || notificationData[TYPE] == NotificationType::LIST_DELTA)
+			&& notificationData[LIST_NAME] == listName;
+	}
+
+	Json::Value* NotificationBatch::findLast(const char* type, const char* key, const Json::Value& value)
+	{
+		for (auto it = m_notifications.rbegin(); it != m_notifications.rend(); ++it)
+		{
+			// read through a const reference, operator[] would add missing keys otherwise
+			const Json::Value& notificationData = *it;
+			if (notificationData[TYPE] == type && notificationData[key] == value)
+				return &*it;
+		}
+
+		return nullptr;
+	}
+
+	void NotificationBatch::drop(Json::Value& notificationData)
+	{
+		notificationData = Json::Value();
+		m_size--;
+	}
+
+	void NotificationBatch::add(const Json::Value& msg)
+	{
+		m_received++;
+
+		auto data = msg[NOTIFICATION_DATA];
+		auto type = data[TYPE].asString();
+
+		if (type == NotificationType::USER_LEFT)
+		{
+			// userJoined, usernameUpdate and userLeft would be merged to
+			// userJoined and userLeft by now, so this also cancels those
+			if (auto joined = findLast(NotificationType::USER_JOINED, USERNAME, data[USERNAME]))
+			{
+				drop(*joined);
+				return;
+			}
+
+			// the subscriber only knows the old name
+			if (auto renamed = findLast(NotificationType::USERNAME_UPDATE, NEW_USERNAME, data[USERNAME]))
+			{
+				data[USERNAME] = (*renamed)[OLD_USERNAME];
+				drop(*renamed);
+			}
+		}
+		else if (type == NotificationType::USERNAME_UPDATE)
+		{
+			if (auto joined = findLast(NotificationType::USER_JOINED, USERNAME, data[OLD_USERNAME]))
+			{
+				(*joined)[USERNAME] = data[NEW_USERNAME];
+				return;
+			}
+
+			if (auto renamed = findLast(NotificationType::USERNAME_UPDATE, NEW_USERNAME, data[OLD_USERNAME]))
+			{
+				(*renamed)[NEW_USERNAME] = data[NEW_USERNAME];
+
+				// renamed back to the original name
+				if ((*renamed)[OLD_USERNAME] == (*renamed)[NEW_USERNAME])
+					drop(*renamed);
+
+				return;
+			}
+		}
+		else if (type == NotificationType::LIST_UPDATE)
+		{
+			// a full list makes all earlier changes to it irrelevant
+			for (auto& notificationData : m_notifications)
+			{
+				if (isListNotification(notificationData, data[LIST_NAME]))
+					drop(notificationData);
+			}
+		}
+		else if (type == NotificationType::LIST_DELTA)
+		{
+			Json::Value* last = nullptr;
+			for (auto it = m_notifications.rbegin(); it != m_notifications.rend() && !last; ++it)
+			{
+				if (isListNotification(*it, data[LIST_NAME]))
+					last = &*it;
+			}
+
+			// if the versions don't line up the delta is passed through,
+			// the subscriber will notice and request the list again.
+			// isMember() first, operator[] would add a null version
+			if (last && last->isMember(LIST_VERSION) && (*last)[LIST_VERSION] == data[BASE_VERSION])
+			{
+				if ((*last)[TYPE] == NotificationType::LIST_UPDATE)
+					applyListDelta(*last, data);
+				else
+					mergeListDelta(*last, data);
+
+				return;
+			}
+		}
+
+		m_notifications.push_back(move(data));
+		m_size++;
+	}
+
+	Json::Value NotificationBatch::toMsg() const
+	{
+		vector<Json::Value> notificationDatas;
+		for (auto&& notificationData : m_notifications)
+		{
+			if (!notificationData.isNull())
+				notificationDatas.push_back(notificationData);
+		}
+
+		if (notificationDatas.empty())
+			return Json::Value();
+		if (notificationDatas.size() == 1)
+			return json::notification(notificationDatas.front());
+
+		return json::notificationBatch(notificationDatas);
+	}
+}
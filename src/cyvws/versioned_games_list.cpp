@@ -0,0 +1,158 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cyvws/versioned_games_list.hpp>
+
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <json/value.h>
+#include <cyvws/common.hpp>
+#include <cyvws/json_notification.hpp>
+
+using namespace std;
+using namespace cyvasse;
+
+namespace cyvws
+{
+	VersionedGamesList::VersionedGamesList(string listName, size_t historySize)
+		: m_listName(move(listName))
+		, m_historySize(historySize)
+	{ }
+
+	Json::Value VersionedGamesList::recordChange(ChangeKind kind, const string& matchID)
+	{
+		unsigned baseVersion = m_version++;
+
+		m_history.push_back({m_version, kind, matchID});
+		while (m_history.size() > m_historySize)
+			m_history.pop_front();
+
+		GamesListMap added, modified;
+		vector<string> removed;
+
+		switch (kind)
+		{
+			case ChangeKind::ADDED:    added.emplace(matchID, m_games.at(matchID)); break;
+			case ChangeKind::MODIFIED: modified.emplace(matchID, m_games.at(matchID)); break;
+			case ChangeKind::REMOVED:  removed.push_back(matchID); break;
+		}
+
+		return json::listDelta(m_listName, baseVersion, m_version, added, modified, removed);
+	}
+
+	Json::Value VersionedGamesList::add(const string& matchID, GamesListMappedType game)
+	{
+		if (!m_games.emplace(matchID, move(game)).second)
+			throw invalid_argument("Match " + matchID + " is already in " + m_listName);
+
+		return recordChange(ChangeKind::ADDED, matchID);
+	}
+
+	Json::Value VersionedGamesList::modify(const string& matchID, GamesListMappedType game)
+	{
+		auto it = m_games.find(matchID);
+		if (it == m_games.end())
+			throw invalid_argument("Match " + matchID + " is not in " + m_listName);
+
+		it->second = move(game);
+		return recordChange(ChangeKind::MODIFIED, matchID);
+	}
+
+	Json::Value VersionedGamesList::remove(const string& matchID)
+	{
+		if (!m_games.erase(matchID))
+			throw invalid_argument("Match " + matchID + " is not in " + m_listName);
+
+		return recordChange(ChangeKind::REMOVED, matchID);
+	}
+
+	Json::Value VersionedGamesList::getSnapshot() const
+	{
+		return json::listUpdate(m_listName, m_games, m_version);
+	}
+
+	Json::Value VersionedGamesList::getUpdate(unsigned knownVersion) const
+	{
+		if (knownVersion == m_version)
+			return Json::Value();
+
+		// the history has to contain every change after knownVersion
+		if (knownVersion > m_version || m_history.empty() || m_history.front().version > knownVersion + 1)
+			return getSnapshot();
+
+		// whether the match was in the list at knownVersion, determined by its first later change
+		map<string, bool> existedBefore;
+		for (auto&& change : m_history)
+		{
+			if (change.version > knownVersion)
+				existedBefore.emplace(change.matchID, change.kind != ChangeKind::ADDED);
+		}
+
+		GamesListMap added, modified;
+		vector<string> removed;
+
+		for (auto&& it : existedBefore)
+		{
+			auto gameIt = m_games.find(it.first);
+			bool existsNow = gameIt != m_games.end();
+
+			if (existsNow)
+				(it.second ? modified : added).insert(*gameIt);
+			else if (it.second)
+				removed.push_back(it.first);
+		}
+
+		return json::listDelta(m_listName, knownVersion, m_version, added, modified, removed);
+	}
+
+	bool VersionedGamesList::apply(const Json::Value& notificationData)
+	{
+		if (notificationData[LIST_NAME].asString() != m_listName)
+			return false;
+
+		auto type = notificationData[TYPE].asString();
+
+		if (type == NotificationType::LIST_UPDATE)
+		{
+			m_games = json::gamesListContent(notificationData[LIST_CONTENT]);
+			m_version = notificationData[LIST_VERSION].asUInt();
+			m_history.clear();
+
+			return true;
+		}
+
+		if (type != NotificationType::LIST_DELTA || notificationData[BASE_VERSION].asUInt() != m_version)
+			return false;
+
+		// parse everything first so a malformed delta doesn't leave a half-updated list
+		auto added    = json::gamesListContent(notificationData[ADDED]);
+		auto modified = json::gamesListContent(notificationData[MODIFIED]);
+
+		for (auto&& game : added)
+			m_games.insert_or_assign(game.first, game.second);
+		for (auto&& game : modified)
+			m_games.insert_or_assign(game.first, game.second);
+		for (auto&& matchID : notificationData[REMOVED])
+			m_games.erase(matchID.asString());
+
+		m_version = notificationData[LIST_VERSION].asUInt();
+		m_history.clear();
+
+		return true;
+	}
+}
@@ -0,0 +1,512 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Replays every game of a game archive (see cyvasse/game_archive.hpp)
+   through the cyvasse rules on all cores. Reports the games with illegal
+   moves or malformed records, the throughput and some aggregate stats.
+
+   Every thread owns a range of record indices and takes small chunks from
+   its front. A thread whose range is empty steals the back half of the
+   largest remaining range of another thread, so a few long games don't
+   leave the other cores idle at the end.
+
+   Usage: archive_validator <archive> [threads]
+          archive_validator --generate <archive> <games> [seed]
+
+   The second form writes an archive of random games, e.g. for measuring
+   the throughput before real archives exist.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cyvasse/fortress.hpp>
+#include <cyvasse/game_archive.hpp>
+#include <cyvasse/game_record.hpp>
+#include <cyvasse/hexagon.hpp>
+#include <cyvasse/match.hpp>
+#include <cyvasse/move_generator.hpp>
+#include <cyvasse/player.hpp>
+#include <cyvasse/terrain.hpp>
+
+using namespace std;
+using namespace cyvasse;
+
+// record indices [begin, end) of one thread, packed into one word so
+// the owner and thieves can both update it with a single CAS
+class alignas(64) WorkRange
+{
+	private:
+		atomic<uint64_t> m_bounds{0};
+
+		static uint64_t pack(uint32_t begin, uint32_t end)
+		{ return uint64_t(begin) << 32 | end; }
+
+		static uint32_t getBegin(uint64_t bounds)
+		{ return uint32_t(bounds >> 32); }
+
+		static uint32_t getEnd(uint64_t bounds)
+		{ return uint32_t(bounds); }
+
+	public:
+		uint32_t remaining() const
+		{
+			auto bounds = m_bounds.load(memory_order_relaxed);
+			return getEnd(bounds) - getBegin(bounds);
+		}
+
+		// only called by the owner while the range is empty, which
+		// thieves never modify
+		void set(uint32_t begin, uint32_t end)
+		{ m_bounds.store(pack(begin, end), memory_order_release); }
+
+		// called by the owner
+		bool popFront(uint32_t maxCount, uint32_t& begin, uint32_t& end)
+		{
+			auto bounds = m_bounds.load(memory_order_acquire);
+
+			do
+			{
+				begin = getBegin(bounds);
+				end = min(getEnd(bounds), begin + maxCount);
+
+				if (begin == end)
+					return false;
+			}
+			while (!m_bounds.compare_exchange_weak(bounds, pack(end, getEnd(bounds)), memory_order_acq_rel));
+
+			return true;
+		}
+
+		// called by thieves
+		bool stealBack(uint32_t& begin, uint32_t& end)
+		{
+			auto bounds = m_bounds.load(memory_order_acquire);
+
+			do
+			{
+				auto count = getEnd(bounds) - getBegin(bounds);
+				if (!count)
+					return false;
+
+				end = getEnd(bounds);
+				begin = end - (count + 1) / 2;
+			}
+			while (!m_bounds.compare_exchange_weak(bounds, pack(getBegin(bounds), begin), memory_order_acq_rel));
+
+			return true;
+		}
+};
+
+struct Problem
+{
+	size_t game;
+	size_t event; // 0 for malformed headers
+	string what;
+};
+
+struct Stats
+{
+	size_t games = 0;
+	size_t events = 0;
+	size_t steals = 0;
+
+	array<size_t, pieceTypeCount> captures {};
+	size_t promotions = 0;
+	array<size_t, 2> wins {};
+	size_t unfinished = 0;
+
+	vector<Problem> illegal;
+	vector<Problem> malformed;
+
+	void add(const Stats& other)
+	{
+		games += other.games;
+		events += other.events;
+		steals += other.steals;
+
+		for (size_t i = 0; i < pieceTypeCount; i++)
+			captures[i] += other.captures[i];
+
+		promotions += other.promotions;
+		wins[0] += other.wins[0];
+		wins[1] += other.wins[1];
+		unfinished += other.unfinished;
+
+		illegal.insert(illegal.end(), other.illegal.begin(), other.illegal.end());
+		malformed.insert(malformed.end(), other.malformed.begin(), other.malformed.end());
+	}
+};
+
+static string describe(const GameRecordEvent& event)
+{
+	switch (event.kind)
+	{
+		case GameRecordEventKind::MOVE:
+			return "move " + event.from.toString() + " -> " + event.to.toString();
+		case GameRecordEventKind::CAPTURE:
+			return "capture " + event.from.toString() + " -> " + event.to.toString()
+				+ " (" + string(PieceTypeToStr(event.pieceType)) + ")";
+		case GameRecordEventKind::PROMOTION:
+			return "promotion to " + string(PieceTypeToStr(event.pieceType)) + " on " + event.to.toString();
+		case GameRecordEventKind::END:
+			return "end";
+	}
+
+	return {};
+}
+
+static void validateGame(string_view record, size_t game, Stats& stats)
+{
+	size_t eventNum = 0;
+
+	try
+	{
+		GameRecordReader reader(record);
+		const auto& header = reader.getHeader();
+
+		Match match(header.matchID, header.random, header._public);
+		reader.setUp(match);
+
+		bool ended = false;
+		while (auto event = reader.next())
+		{
+			eventNum++;
+
+			if (!reader.apply(match, *event))
+			{
+				stats.illegal.push_back({game, eventNum, describe(*event)});
+				return;
+			}
+
+			switch (event->kind)
+			{
+				case GameRecordEventKind::CAPTURE:
+					stats.captures[static_cast<size_t>(event->pieceType)]++;
+					break;
+				case GameRecordEventKind::PROMOTION:
+					stats.promotions++;
+					break;
+				case GameRecordEventKind::END:
+					stats.wins[event->winner]++;
+					ended = true;
+					break;
+				default:
+					break;
+			}
+		}
+
+		if (reader.getPos() != record.size())
+			throw GameRecordError("trailing data after the end of the game");
+
+		if (!ended)
+			stats.unfinished++;
+
+		stats.events += eventNum;
+	}
+	catch (exception& e)
+	{
+		stats.malformed.push_back({game, eventNum, e.what()});
+	}
+}
+
+static void runThread(const GameArchive& archive, vector<WorkRange>& ranges, size_t self, Stats& stats)
+{
+	static constexpr uint32_t chunkSize = 16;
+
+	auto& own = ranges[self];
+
+	for (;;)
+	{
+		uint32_t begin, end;
+
+		while (own.popFront(chunkSize, begin, end))
+		{
+			for (auto i = begin; i < end; i++)
+				validateGame(archive.getRecord(i), i, stats);
+
+			stats.games += end - begin;
+		}
+
+		// steal from the thread with the most work left
+		size_t victim = self;
+		uint32_t maxRemaining = 0;
+
+		for (size_t i = 0; i < ranges.size(); i++)
+		{
+			auto remaining = ranges[i].remaining();
+			if (i != self && remaining > maxRemaining)
+			{
+				victim = i;
+				maxRemaining = remaining;
+			}
+		}
+
+		if (victim == self || !ranges[victim].stealBack(begin, end))
+		{
+			if (victim == self)
+				return;
+
+			continue;
+		}
+
+		stats.steals++;
+		own.set(begin, end);
+	}
+}
+
+static int validate(const string& path, unsigned threadCount)
+{
+	GameArchive archive(path);
+
+	if (archive.size() > UINT32_MAX)
+	{
+		fprintf(stderr, "Archives with more than 2^32 games are not supported\n");
+		return 1;
+	}
+
+	threadCount = max(1u, min<unsigned>(threadCount, max<size_t>(archive.size(), 1)));
+
+	vector<WorkRange> ranges(threadCount);
+	for (unsigned i = 0; i < threadCount; i++)
+		ranges[i].set(archive.size() * i / threadCount, archive.size() * (i + 1) / threadCount);
+
+	vector<Stats> threadStats(threadCount);
+	vector<thread> threads;
+
+	auto begin = chrono::steady_clock::now();
+
+	for (unsigned i = 0; i < threadCount; i++)
+		threads.emplace_back(runThread, cref(archive), ref(ranges), i, ref(threadStats[i]));
+
+	for (auto& thread : threads)
+		thread.join();
+
+	chrono::duration<double> duration = chrono::steady_clock::now() - begin;
+
+	Stats stats;
+	for (const auto& it : threadStats)
+		stats.add(it);
+
+	auto byGame = [](const Problem& a, const Problem& b) { return a.game < b.game; };
+	sort(stats.illegal.begin(), stats.illegal.end(), byGame);
+	sort(stats.malformed.begin(), stats.malformed.end(), byGame);
+
+	printf("%zu games, %zu events, %.1f MB in %.3f s on %u threads (%zu steals)\n",
+		stats.games, stats.events, archive.getByteSize() / 1e6, duration.count(), threadCount, stats.steals);
+	printf("%.0f games/s, %.0f events/s\n\n", stats.games / duration.count(), stats.events / duration.count());
+
+	printf("captured pieces:\n");
+	for (size_t i = 0; i < pieceTypeCount; i++)
+		printf("  %-12s %zu\n", string(PieceTypeToStr(static_cast<PieceType>(i))).c_str(), stats.captures[i]);
+
+	printf("\npromotions %zu, won by white %zu, won by black %zu, unfinished %zu\n\n",
+		stats.promotions, stats.wins[PlayersColor::WHITE], stats.wins[PlayersColor::BLACK], stats.unfinished);
+
+	// only list the first few problems, they tend to come in masses
+	static constexpr size_t maxListed = 20;
+
+	printf("games with illegal moves: %zu\n", stats.illegal.size());
+	for (size_t i = 0; i < min(stats.illegal.size(), maxListed); i++)
+	{
+		const auto& problem = stats.illegal[i];
+		printf("  game %zu, event %zu: %s\n", problem.game, problem.event, problem.what.c_str());
+	}
+
+	printf("malformed records: %zu\n", stats.malformed.size());
+	for (size_t i = 0; i < min(stats.malformed.size(), maxListed); i++)
+	{
+		const auto& problem = stats.malformed[i];
+		printf("  game %zu, event %zu: %s\n", problem.game, problem.event, problem.what.c_str());
+	}
+
+	return (stats.illegal.empty() && stats.malformed.empty()) ? 0 : 2;
+}
+
+// forwards all board changes to a GameRecordWriter
+class RecordingMatch : public Match
+{
+	public:
+		GameRecordWriter writer;
+
+		explicit RecordingMatch(const string& id)
+			: Match(id)
+			, writer(*this)
+		{ }
+
+		void removeFromBoard(const Piece& piece) override
+		{
+			writer.removeFromBoard(piece);
+			Match::removeFromBoard(piece);
+		}
+
+		void pieceMoved(const Piece& piece, optional<HexCoordinate<6>> oldCoord) override
+		{ writer.pieceMoved(piece, oldCoord); }
+
+		void piecePromoted(const Piece& piece, PieceType origType) override
+		{ writer.piecePromoted(piece, origType); }
+
+		void endGame(PlayersColor winner) override
+		{ writer.endGame(winner); }
+};
+
+// fills the first rows of white's side, black's opening is the mirror image
+static array<OpeningArray, 2> makeOpenings()
+{
+	static const pair<PieceType, int> pieces[] = {
+		{PieceType::KING, 1}, {PieceType::RABBLE, 6}, {PieceType::CROSSBOWS, 2},
+		{PieceType::SPEARS, 2}, {PieceType::LIGHT_HORSE, 2}, {PieceType::TREBUCHET, 2},
+		{PieceType::ELEPHANT, 2}, {PieceType::HEAVY_HORSE, 2}, {PieceType::DRAGON, 1},
+		{PieceType::MOUNTAINS, 6}
+	};
+
+	// row by row, from the center column outwards
+	vector<HexCoordinate<6>> tiles(Hexagon<6>::allCoordinates.begin(), Hexagon<6>::allCoordinates.end());
+	stable_sort(tiles.begin(), tiles.end(), [](HexCoordinate<6> a, HexCoordinate<6> b) {
+		return make_pair(a.y(), abs(a.x() + a.y() / 2 - 7)) < make_pair(b.y(), abs(b.x() + b.y() / 2 - 7));
+	});
+
+	array<OpeningArray, 2> ret;
+	auto tileIt = tiles.begin();
+
+	for (const auto& it : pieces)
+	{
+		for (auto i = 0; i < it.second; i++, ++tileIt)
+		{
+			ret[PlayersColor::WHITE][it.first].insert(*tileIt);
+			ret[PlayersColor::BLACK][it.first].emplace(10 - tileIt->x(), 10 - tileIt->y());
+		}
+	}
+
+	return ret;
+}
+
+static string generateGame(const array<OpeningArray, 2>& openings, size_t game, mt19937& rng)
+{
+	static constexpr unsigned maxPlies = 300;
+
+	RecordingMatch match("generated" + to_string(game));
+
+	for (auto color : allPlayersColors)
+	{
+		const auto& opening = openings[color];
+
+		match.setPlayer(color, unique_ptr<Player>(new Player(match, color,
+			unique_ptr<Fortress>(new Fortress(color, *opening.at(PieceType::KING).begin()))
+		)));
+
+		for (const auto& it : opening)
+		{
+			for (auto coord : it.second)
+			{
+				auto piece = make_shared<Piece>(color, it.first, nullopt, match);
+				match.getPlayer(color).getInactivePieces().emplace(it.first, piece);
+				match.addToBoard(it.first, color, coord);
+
+				if (auto terrainType = piece->getSetupTerrain())
+					match.getTerrain().emplace(coord, make_shared<Terrain>(*terrainType, coord));
+			}
+		}
+	}
+
+	match.setupDone();
+	match.getBearingTable().init();
+	match.writer.start("default");
+
+	auto color = PlayersColor::WHITE;
+
+	for (unsigned ply = 0; ply < maxPlies && !match.writer.isEnded(); ply++)
+	{
+		vector<Move> moves;
+		for (const auto& move : MoveGenerator(match, color))
+			if (move.kind != MoveKind::PROMOTION) // done by Player::onTurnEnd()
+				moves.push_back(move);
+
+		shuffle(moves.begin(), moves.end(), rng);
+
+		// prefer captures half of the time, so games actually end
+		if (rng() % 2)
+			stable_partition(moves.begin(), moves.end(), [](const Move& move) { return move.kind == MoveKind::CAPTURE; });
+
+		bool moved = false;
+		for (const auto& move : moves)
+		{
+			if (match.getPieceAt(move.oldPos)->get().moveTo(move.newPos, false))
+			{
+				moved = true;
+				break;
+			}
+		}
+
+		if (!moved)
+		{
+			match.endGame(!color);
+			break;
+		}
+
+		match.getPlayer(color).onTurnEnd();
+		color = !color;
+	}
+
+	return match.writer.getRecord();
+}
+
+static int generate(const string& path, size_t count, unsigned seed)
+{
+	auto openings = makeOpenings();
+	mt19937 rng(seed);
+
+	GameArchiveWriter writer(path);
+	for (size_t i = 0; i < count; i++)
+		writer.add(generateGame(openings, i, rng));
+
+	writer.finish();
+	printf("wrote %zu games to %s\n", count, path.c_str());
+
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	try
+	{
+		if (argc >= 4 && string(argv[1]) == "--generate")
+			return generate(argv[2], strtoul(argv[3], nullptr, 10), argc > 4 ? strtoul(argv[4], nullptr, 10) : 1);
+
+		if (argc >= 2 && argv[1][0] != '-')
+			return validate(argv[1], argc > 2 ? strtoul(argv[2], nullptr, 10) : thread::hardware_concurrency());
+	}
+	catch (exception& e)
+	{
+		fprintf(stderr, "%s\n", e.what());
+		return 1;
+	}
+
+	fprintf(stderr,
+		"Usage: %s <archive> [threads]\n"
+		"       %s --generate <archive> <games> [seed]\n", argv[0], argv[0]);
+	return 1;
+}
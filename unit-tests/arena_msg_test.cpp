@@ -0,0 +1,92 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "arena_msg_test.hpp"
+
+#include <string>
+#include <json/writer.h>
+#include <cyvws/arena_msg.hpp>
+#include <cyvws/json_game_msg.hpp>
+#include <cyvws/json_notification.hpp>
+#include <cyvws/json_server_reply.hpp>
+
+using namespace std;
+using namespace cyvws;
+
+static string toString(const Json::Value& val)
+{
+	Json::StreamWriterBuilder builder;
+	builder["indentation"] = "";
+
+	return Json::writeString(builder, val);
+}
+
+void ArenaMsgTest::testMatchesJson()
+{
+	MsgArena arena(64);
+
+	// control characters, non-ASCII, a character outside of the BMP and invalid UTF-8
+	const string odd = "\"a\\b\"\n\t\x01/\x7f \xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80\xff\xc3";
+
+	CPPUNIT_ASSERT_EQUAL(toString(json::gameMsgAck(3)), string(arena::gameMsgAck(arena, 3)));
+	CPPUNIT_ASSERT_EQUAL(toString(json::gameMsgErr(4, odd)), string(arena::gameMsgErr(arena, 4, odd)));
+
+	CPPUNIT_ASSERT_EQUAL(toString(json::requestSuccess(0)), string(arena::requestSuccess(arena, 0)));
+	CPPUNIT_ASSERT_EQUAL(toString(json::requestErr(12, "gameFull")), string(arena::requestErr(arena, 12, "gameFull")));
+	CPPUNIT_ASSERT_EQUAL(toString(json::requestErr(4294967295u, "gameFull", odd)),
+		string(arena::requestErr(arena, 4294967295u, "gameFull", odd)));
+	CPPUNIT_ASSERT_EQUAL(toString(json::createGameSuccess(5, "NHVy", "a3f9")),
+		string(arena::createGameSuccess(arena, 5, "NHVy", "a3f9")));
+
+	CPPUNIT_ASSERT_EQUAL(toString(json::commErr(odd)), string(arena::commErr(arena, odd)));
+	CPPUNIT_ASSERT_EQUAL(toString(json::userJoined(odd, true, "player")),
+		string(arena::userJoined(arena, odd, true, "player")));
+	CPPUNIT_ASSERT_EQUAL(toString(json::userLeft("jPlatte")), string(arena::userLeft(arena, "jPlatte")));
+	CPPUNIT_ASSERT_EQUAL(toString(json::usernameUpdate("Guest 1", odd)),
+		string(arena::usernameUpdate(arena, "Guest 1", odd)));
+}
+
+void ArenaMsgTest::testArenaReuse()
+{
+	MsgArena arena(64);
+	const string longName(300, 'x');
+
+	for (unsigned i = 0; i < 3; i++)
+	{
+		arena::gameMsgAck(arena, i);
+		arena::userJoined(arena, longName, false, "spectator");
+		CPPUNIT_ASSERT(arena.getBytesUsed() > longName.size());
+
+		arena.reset();
+		CPPUNIT_ASSERT_EQUAL(size_t(0), arena.getBytesUsed());
+	}
+
+	// the blocks were merged on the first reset
+	auto allocCount = arena.getBlockAllocCount();
+	for (unsigned i = 0; i < 100; i++)
+	{
+		arena::gameMsgAck(arena, i);
+		arena::userJoined(arena, longName, false, "spectator");
+		arena.reset();
+	}
+
+	CPPUNIT_ASSERT_EQUAL(allocCount, arena.getBlockAllocCount());
+
+	// allocations are aligned
+	auto ptr = arena.allocate(3, 1);
+	CPPUNIT_ASSERT(ptr);
+	CPPUNIT_ASSERT_EQUAL(uintptr_t(0), reinterpret_cast<uintptr_t>(arena.allocate(8, 8)) % 8);
+}
@@ -0,0 +1,138 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "binary_msg_test.hpp"
+
+#include <cyvws/binary_msg.hpp>
+#include <cyvws/game_msg_writer.hpp>
+#include <cyvws/init_comm.hpp>
+#include <cyvws/json_server_reply.hpp>
+#include <cyvws/server_reply.hpp>
+
+using namespace std;
+using namespace cyvasse;
+using namespace cyvws;
+
+void BinaryMsgTest::testGameMsgRoundTrip()
+{
+	BinaryMsg msg;
+	GameMsgWriter writer;
+
+	auto encoded = binary::gameMsgMove(6, PieceType::LIGHT_HORSE, HexCoordinate<6>("C4"), HexCoordinate<6>("D5"));
+	CPPUNIT_ASSERT_EQUAL(size_t(6), encoded.size());
+	CPPUNIT_ASSERT(encoded.size() * 10 < writer.move(PieceType::LIGHT_HORSE, HexCoordinate<6>("C4"),
+	                                                 HexCoordinate<6>("D5")).size());
+
+	CPPUNIT_ASSERT(binary::decode(encoded, msg) == BinaryMsgError::NONE);
+	CPPUNIT_ASSERT(msg.type == MsgTypeCode::GAME_MSG);
+	CPPUNIT_ASSERT_EQUAL(6u, msg.msgID);
+	CPPUNIT_ASSERT(msg.action == GameMsgActionCode::MOVE);
+	CPPUNIT_ASSERT(msg.movement);
+	CPPUNIT_ASSERT(msg.movement->pieceType == PieceType::LIGHT_HORSE);
+	CPPUNIT_ASSERT(msg.movement->oldPos == HexCoordinate<6>("C4"));
+	CPPUNIT_ASSERT(msg.movement->newPos == HexCoordinate<6>("D5"));
+
+	encoded = binary::gameMsgMoveCapture(300, PieceType::DRAGON, HexCoordinate<6>("G4"), HexCoordinate<6>("E8"),
+	                                     PieceType::SPEARS, HexCoordinate<6>("E8"));
+	CPPUNIT_ASSERT(binary::decode(encoded, msg) == BinaryMsgError::NONE);
+	CPPUNIT_ASSERT_EQUAL(300u, msg.msgID);
+	CPPUNIT_ASSERT(msg.action == GameMsgActionCode::MOVE_CAPTURE);
+	CPPUNIT_ASSERT(msg.moveCapture);
+	CPPUNIT_ASSERT(msg.moveCapture->atkPT == PieceType::DRAGON);
+	CPPUNIT_ASSERT(msg.moveCapture->oldPos == HexCoordinate<6>("G4"));
+	CPPUNIT_ASSERT(msg.moveCapture->newPos == HexCoordinate<6>("E8"));
+	CPPUNIT_ASSERT(msg.moveCapture->defPT == PieceType::SPEARS);
+	CPPUNIT_ASSERT(msg.moveCapture->defPiecePos == HexCoordinate<6>("E8"));
+
+	encoded = binary::gameMsgPromote(8, PieceType::CROSSBOWS, PieceType::TREBUCHET);
+	CPPUNIT_ASSERT(binary::decode(encoded, msg) == BinaryMsgError::NONE);
+	CPPUNIT_ASSERT(msg.promotion);
+	CPPUNIT_ASSERT(msg.promotion->origType == PieceType::CROSSBOWS);
+	CPPUNIT_ASSERT(msg.promotion->newType == PieceType::TREBUCHET);
+
+	PieceMap pieceMap;
+	pieceMap[PieceType::KING].emplace("H2");
+	pieceMap[PieceType::RABBLE].emplace("G2");
+	pieceMap[PieceType::RABBLE].emplace("G3");
+	pieceMap[PieceType::DRAGON];
+
+	encoded = binary::gameMsgSetOpeningArray(5, pieceMap);
+	CPPUNIT_ASSERT(binary::decode(encoded, msg) == BinaryMsgError::NONE);
+	CPPUNIT_ASSERT(msg.action == GameMsgActionCode::SET_OPENING_ARRAY);
+	CPPUNIT_ASSERT(msg.pieceMap == pieceMap);
+
+	CPPUNIT_ASSERT(binary::decode(binary::gameMsgResign(25), msg) == BinaryMsgError::NONE);
+	CPPUNIT_ASSERT(msg.action == GameMsgActionCode::RESIGN);
+	CPPUNIT_ASSERT(GameMsgActionCodeToStr(msg.action) == GameMsgAction::RESIGN);
+}
+
+void BinaryMsgTest::testOtherMsgs()
+{
+	BinaryMsg msg;
+
+	auto encoded = binary::chatMsg(6, "jPlatte", "Hey!");
+	CPPUNIT_ASSERT(binary::decode(encoded, msg) == BinaryMsgError::NONE);
+	CPPUNIT_ASSERT(msg.type == MsgTypeCode::CHAT_MSG);
+	CPPUNIT_ASSERT(msg.user == "jPlatte");
+	CPPUNIT_ASSERT(msg.text == "Hey!");
+
+	encoded = binary::gameMsgErr(3, "invalidOpeningArray");
+	CPPUNIT_ASSERT(binary::decode(encoded, msg) == BinaryMsgError::NONE);
+	CPPUNIT_ASSERT(msg.type == MsgTypeCode::GAME_MSG_ERR);
+	CPPUNIT_ASSERT_EQUAL(3u, msg.msgID);
+	CPPUNIT_ASSERT(msg.text == "invalidOpeningArray");
+
+	encoded = binary::jsonMsg("{\"msgType\":\"notification\"}");
+	CPPUNIT_ASSERT(binary::decode(encoded, msg) == BinaryMsgError::NONE);
+	CPPUNIT_ASSERT(msg.type == MsgTypeCode::JSON);
+	CPPUNIT_ASSERT(msg.text == "{\"msgType\":\"notification\"}");
+
+	CPPUNIT_ASSERT(binary::requestsBinaryProtocol("1.0+bin"));
+	CPPUNIT_ASSERT(!binary::requestsBinaryProtocol("1.0"));
+	CPPUNIT_ASSERT(!binary::requestsBinaryProtocol("+bin"));
+
+	// the server only confirms the binary encoding if it was requested
+	auto reply = json::initCommSuccess(1, binary::replyProtocolVersion("1.0", "1.0+bin"));
+	CPPUNIT_ASSERT(binary::requestsBinaryProtocol(reply[REPLY_DATA][PROTOCOL_VERSION].asString()));
+	CPPUNIT_ASSERT_EQUAL(string("1.0"), binary::replyProtocolVersion("1.0", "1.0"));
+}
+
+void BinaryMsgTest::testMalformed()
+{
+	BinaryMsg msg;
+
+	auto encoded = binary::gameMsgMove(6, PieceType::KING, HexCoordinate<6>("F2"), HexCoordinate<6>("F3"));
+
+	CPPUNIT_ASSERT(binary::decode("", msg) == BinaryMsgError::TRUNCATED);
+	CPPUNIT_ASSERT(binary::decode(encoded.substr(0, encoded.size() - 1), msg) == BinaryMsgError::TRUNCATED);
+	CPPUNIT_ASSERT(binary::decode(encoded + '\0', msg) == BinaryMsgError::TRAILING_DATA);
+	CPPUNIT_ASSERT(binary::decode(string(1, '\x42'), msg) == BinaryMsgError::INVALID_MSG_TYPE);
+
+	encoded[2] = 0x42;
+	CPPUNIT_ASSERT(binary::decode(encoded, msg) == BinaryMsgError::INVALID_ACTION);
+
+	encoded[2] = static_cast<char>(GameMsgActionCode::MOVE);
+	encoded[3] = 10;
+	CPPUNIT_ASSERT(binary::decode(encoded, msg) == BinaryMsgError::INVALID_PIECE_TYPE);
+
+	encoded[3] = 0;
+	encoded[4] = 91;
+	CPPUNIT_ASSERT(binary::decode(encoded, msg) == BinaryMsgError::INVALID_COORDINATE);
+
+	CPPUNIT_ASSERT(binary::decode(binary::gameMsgAck(0) + "\xff\xff\xff\xff\xff", msg) == BinaryMsgError::TRAILING_DATA);
+	CPPUNIT_ASSERT(binary::decode(string(1, '\x04') + "\xff\xff\xff\xff\x7f", msg) == BinaryMsgError::INVALID_VARINT);
+	CPPUNIT_ASSERT(binary::decode(binary::chatMsg(1, "a", "bcd").substr(0, 5), msg) == BinaryMsgError::TRUNCATED);
+}
@@ -0,0 +1,38 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BINARY_MSG_TEST_HPP_
+#define _BINARY_MSG_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class BinaryMsgTest : public CppUnit::TestFixture
+{
+	public:
+		void testGameMsgRoundTrip();
+		void testOtherMsgs();
+		void testMalformed();
+
+	CPPUNIT_TEST_SUITE(BinaryMsgTest);
+		CPPUNIT_TEST(testGameMsgRoundTrip);
+		CPPUNIT_TEST(testOtherMsgs);
+		CPPUNIT_TEST(testMalformed);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+#endif // _BINARY_MSG_TEST_HPP_
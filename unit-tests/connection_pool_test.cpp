@@ -0,0 +1,190 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "connection_pool_test.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <cyvdb/connection_pool.hpp>
+
+using namespace std;
+using namespace cyvdb;
+
+/* The connections handed out by these pools are never opened, the tests
+   tell them apart by their address, which is the same for every lease of
+   one pooled connection.
+ */
+struct ConnectCounter
+{
+	atomic<unsigned> connects {0};
+	atomic<unsigned> warmups {0};
+	atomic<bool> failConnect {false};
+
+	ConnectionPool::Connector getConnector()
+	{
+		return [this] {
+			if (failConnect)
+				throw runtime_error("connection refused");
+
+			connects++;
+			return tntdb::Connection();
+		};
+	}
+
+	ConnectionPool::Warmup getWarmup()
+	{
+		return [this](tntdb::Connection&) { warmups++; };
+	}
+};
+
+void ConnectionPoolTest::testCheckout()
+{
+	ConnectCounter counter;
+	ConnectionPool pool(counter.getConnector(), 2, {counter.getWarmup()});
+
+	// everything is opened up front
+	CPPUNIT_ASSERT_EQUAL(size_t(2), pool.size());
+	CPPUNIT_ASSERT_EQUAL(2u, counter.connects.load());
+	CPPUNIT_ASSERT_EQUAL(2u, counter.warmups.load());
+
+	{
+		auto lease1 = pool.acquire();
+		auto lease2 = pool.acquire();
+		CPPUNIT_ASSERT(lease1 && lease2);
+		CPPUNIT_ASSERT(&*lease1 != &*lease2);
+
+		CPPUNIT_ASSERT(!pool.tryAcquire(chrono::milliseconds(10)));
+
+		// moving a lease doesn't release the connection
+		auto moved = move(lease1);
+		CPPUNIT_ASSERT(!lease1);
+		CPPUNIT_ASSERT(!pool.tryAcquire(chrono::milliseconds(0)));
+
+		moved.release();
+		CPPUNIT_ASSERT(pool.tryAcquire(chrono::milliseconds(0)));
+	}
+
+	auto metrics = pool.getMetrics();
+	CPPUNIT_ASSERT_EQUAL(size_t(3), metrics.checkouts);
+	CPPUNIT_ASSERT_EQUAL(size_t(0), metrics.waits);
+	CPPUNIT_ASSERT_EQUAL(size_t(0), metrics.reconnects);
+	CPPUNIT_ASSERT_EQUAL(2u, counter.connects.load());
+}
+
+void ConnectionPoolTest::testWait()
+{
+	ConnectCounter counter;
+	ConnectionPool pool(counter.getConnector(), 1);
+
+	auto lease = pool.acquire();
+	auto conn = &*lease;
+
+	promise<void> waiting;
+	auto waiter = async(launch::async, [&] {
+		waiting.set_value();
+		auto otherLease = pool.acquire();
+		return &*otherLease;
+	});
+
+	waiting.get_future().wait();
+	this_thread::sleep_for(chrono::milliseconds(20));
+	CPPUNIT_ASSERT(waiter.wait_for(chrono::seconds(0)) == future_status::timeout);
+
+	lease.release();
+	CPPUNIT_ASSERT(waiter.get() == conn);
+
+	auto metrics = pool.getMetrics();
+	CPPUNIT_ASSERT_EQUAL(size_t(2), metrics.checkouts);
+	CPPUNIT_ASSERT_EQUAL(size_t(1), metrics.waits);
+	CPPUNIT_ASSERT(metrics.maxWait >= chrono::milliseconds(10));
+	CPPUNIT_ASSERT(metrics.maxCheckout >= chrono::milliseconds(20));
+	CPPUNIT_ASSERT(metrics.totalCheckout >= metrics.maxCheckout);
+}
+
+void ConnectionPoolTest::testAffinity()
+{
+	ConnectCounter counter;
+	ConnectionPool pool(counter.getConnector(), 3);
+
+	tntdb::Connection* own;
+
+	{
+		promise<void> held, done;
+		auto doneFuture = done.get_future();
+
+		auto other = async(launch::async, [&] {
+			auto lease = pool.acquire();
+			held.set_value();
+			doneFuture.wait();
+		});
+
+		held.get_future().wait();
+
+		// not the first connection, the other thread has that one
+		auto lease = pool.acquire();
+		own = &*lease;
+
+		done.set_value();
+		other.get();
+	}
+
+	// the first connection is free again, but this thread had another one
+	{
+		auto lease = pool.acquire();
+		CPPUNIT_ASSERT(&*lease == own);
+
+		auto metrics = pool.getMetrics();
+		CPPUNIT_ASSERT_EQUAL(size_t(3), metrics.checkouts);
+		CPPUNIT_ASSERT_EQUAL(size_t(1), metrics.affinityHits);
+
+		// while its own connection is in use, a thread takes any free one
+		auto otherLease = pool.acquire();
+		CPPUNIT_ASSERT(otherLease);
+		CPPUNIT_ASSERT(&*otherLease != own);
+	}
+
+	CPPUNIT_ASSERT_EQUAL(size_t(1), pool.getMetrics().affinityHits);
+}
+
+void ConnectionPoolTest::testDiscard()
+{
+	ConnectCounter counter;
+	ConnectionPool pool(counter.getConnector(), 1, {counter.getWarmup()});
+
+	pool.acquire().discard();
+
+	// reconnected and warmed up again by the next checkout
+	auto lease = pool.acquire();
+	CPPUNIT_ASSERT(lease);
+	CPPUNIT_ASSERT_EQUAL(2u, counter.connects.load());
+	CPPUNIT_ASSERT_EQUAL(2u, counter.warmups.load());
+	CPPUNIT_ASSERT_EQUAL(size_t(1), pool.getMetrics().reconnects);
+
+	// if reconnecting fails, the connection stays broken and isn't lost
+	lease.discard();
+	lease.release();
+
+	counter.failConnect = true;
+	CPPUNIT_ASSERT_THROW(pool.acquire(), runtime_error);
+
+	counter.failConnect = false;
+	CPPUNIT_ASSERT(pool.tryAcquire(chrono::milliseconds(100)));
+	CPPUNIT_ASSERT_EQUAL(3u, counter.connects.load());
+	CPPUNIT_ASSERT_EQUAL(size_t(3), pool.getMetrics().reconnects);
+}
@@ -0,0 +1,69 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "encoded_msg_test.hpp"
+
+#include <vector>
+#include <json/writer.h>
+#include <cyvws/binary_msg.hpp>
+#include <cyvws/encoded_msg.hpp>
+#include <cyvws/json_notification.hpp>
+
+using namespace std;
+using namespace cyvws;
+
+void EncodedMsgTest::testSharing()
+{
+	auto val = json::userJoined("jPlatte", true, "player");
+
+	Json::StreamWriterBuilder builder;
+	builder["indentation"] = "";
+
+	auto msg = EncodedMsg::fromJson(val);
+	CPPUNIT_ASSERT(msg.getEncoding() == MsgEncoding::JSON);
+	CPPUNIT_ASSERT(msg.getPayload() == Json::writeString(builder, val));
+	CPPUNIT_ASSERT(!msg.hasFrame());
+	CPPUNIT_ASSERT(msg.getFrame().empty());
+
+	// handing the message to many connections doesn't copy it
+	vector<EncodedMsg> queues(100, msg);
+	CPPUNIT_ASSERT_EQUAL(101L, msg.getUseCount());
+	for (const auto& queued : queues)
+		CPPUNIT_ASSERT(queued.getPayload().data() == msg.getPayload().data());
+
+	queues.clear();
+	CPPUNIT_ASSERT_EQUAL(1L, msg.getUseCount());
+}
+
+void EncodedMsgTest::testFraming()
+{
+	auto ack = binary::gameMsgAck(3);
+	EncodedMsg small(MsgEncoding::BINARY, ack, true);
+
+	CPPUNIT_ASSERT(small.hasFrame());
+	CPPUNIT_ASSERT(small.getFrame() == "\x82" + string(1, char(ack.size())) + ack);
+	CPPUNIT_ASSERT(small.getPayload() == ack);
+
+	string payload(300, 'x');
+	EncodedMsg medium(MsgEncoding::JSON, payload, true);
+	CPPUNIT_ASSERT(medium.getFrame() == string("\x81\x7e\x01\x2c", 4) + payload);
+
+	payload.assign(0x10203, 'y');
+	EncodedMsg large(MsgEncoding::JSON, payload, true);
+	CPPUNIT_ASSERT(large.getFrame().substr(0, 10) == string("\x81\x7f\0\0\0\0\0\x01\x02\x03", 10));
+	CPPUNIT_ASSERT(large.getFrame().substr(10) == payload);
+	CPPUNIT_ASSERT(large.getPayload().data() == large.getFrame().data() + 10);
+}
@@ -0,0 +1,97 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "game_archive_test.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <unistd.h>
+#include <cyvasse/game_archive.hpp>
+
+using namespace std;
+using namespace cyvasse;
+
+void GameArchiveTest::setUp()
+{
+	char path[] = "/tmp/cyvasse-archive-test-XXXXXX";
+
+	int fd = mkstemp(path);
+	CPPUNIT_ASSERT(fd != -1);
+	close(fd);
+
+	m_path = path;
+}
+
+void GameArchiveTest::tearDown()
+{
+	remove(m_path.c_str());
+}
+
+void GameArchiveTest::testRoundTrip()
+{
+	// the archive doesn't look into the records
+	const vector<string> records {"first", "", string("\0\x80\xff", 3), string(1000, 'x')};
+
+	{
+		GameArchiveWriter writer(m_path);
+		for (const auto& record : records)
+			writer.add(record);
+
+		CPPUNIT_ASSERT_EQUAL(records.size(), writer.size());
+		writer.finish();
+	}
+
+	GameArchive archive(m_path);
+	CPPUNIT_ASSERT_EQUAL(records.size(), archive.size());
+
+	for (size_t i = 0; i < records.size(); i++)
+		CPPUNIT_ASSERT_EQUAL(records[i], string(archive.getRecord(i)));
+
+	{
+		// finished by the destructor
+		GameArchiveWriter writer(m_path);
+	}
+
+	CPPUNIT_ASSERT_EQUAL(size_t(0), GameArchive(m_path).size());
+}
+
+void GameArchiveTest::testInvalidArchives()
+{
+	CPPUNIT_ASSERT_THROW(GameArchive("/nonexistent/archive"), runtime_error);
+
+	{
+		GameArchiveWriter writer(m_path);
+		writer.add("record");
+	}
+
+	string data;
+	{
+		ifstream file(m_path, ios::binary);
+		data.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+	}
+
+	auto check = [&](const string& modified) {
+		ofstream(m_path, ios::binary | ios::trunc) << modified;
+		CPPUNIT_ASSERT_THROW(GameArchive archive(m_path), runtime_error);
+	};
+
+	// truncated, index offset out of range, record offset out of range
+	check(data.substr(0, data.size() - 1));
+	check(string(data).replace(data.size() - 20, 1, 1, '\x7f'));
+	check(string(data).replace(data.size() - 28, 1, 1, '\x7f'));
+}
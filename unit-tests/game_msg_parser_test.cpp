@@ -0,0 +1,188 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "game_msg_parser_test.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <json/reader.h>
+#include <cyvws/common.hpp>
+#include <cyvws/game_msg.hpp>
+#include <cyvws/game_msg_parser.hpp>
+#include <cyvws/msg.hpp>
+#include <cyvws/server_request.hpp>
+
+using namespace std;
+using namespace cyvasse;
+using namespace cyvws;
+
+typedef GameMsgParseError Error;
+
+string GameMsgParserTest::readExample(const string& name)
+{
+	ifstream file(string(WS_MSG_EXAMPLES_DIR) + "/gameMsg/" + name + ".json");
+	if (!file)
+		throw runtime_error("couldn't open example " + name);
+
+	stringstream sstr;
+	sstr << file.rdbuf();
+	return sstr.str();
+}
+
+void GameMsgParserTest::testExamples()
+{
+	for (string name : {"endTurn", "move", "moveCapture", "promote", "resign", "setIsReady", "setOpeningArray"})
+	{
+		auto text = readExample(name);
+
+		Json::Value val;
+		istringstream(text) >> val;
+
+		GameMsgView view;
+		CPPUNIT_ASSERT(parser::parseGameMsg(text, view) == Error::NONE);
+		CPPUNIT_ASSERT(string(view.action) == val[MSG_DATA][ACTION].asString());
+		CPPUNIT_ASSERT(view.actionCode);
+		CPPUNIT_ASSERT(view.action == GameMsgActionCodeToStr(*view.actionCode));
+		CPPUNIT_ASSERT(view.msgID);
+		CPPUNIT_ASSERT_EQUAL(val[MSG_ID].asInt(), *view.msgID);
+		CPPUNIT_ASSERT_EQUAL(val[MSG_DATA].isMember(PARAM), !view.param.empty());
+
+		auto& param = val[MSG_DATA][PARAM];
+
+		if (view.actionCode == GameMsgActionCode::MOVE)
+		{
+			auto expected = json::movement(param);
+			PieceMovement movement = expected;
+			movement.pieceType = PieceType::MOUNTAINS;
+			movement.oldPos = movement.newPos = HexCoordinate<6>(5, 5);
+
+			CPPUNIT_ASSERT(parser::parseMovement(view.param, movement) == Error::NONE);
+			CPPUNIT_ASSERT(movement.pieceType == expected.pieceType);
+			CPPUNIT_ASSERT(movement.oldPos == expected.oldPos);
+			CPPUNIT_ASSERT(movement.newPos == expected.newPos);
+		}
+		else if (view.actionCode == GameMsgActionCode::MOVE_CAPTURE)
+		{
+			auto expected = json::moveCapture(param);
+			MoveCapture moveCapture = expected;
+			moveCapture.atkPT = moveCapture.defPT = PieceType::MOUNTAINS;
+			moveCapture.oldPos = moveCapture.newPos = moveCapture.defPiecePos = HexCoordinate<6>(5, 5);
+
+			CPPUNIT_ASSERT(parser::parseMoveCapture(view.param, moveCapture) == Error::NONE);
+			CPPUNIT_ASSERT(moveCapture.atkPT == expected.atkPT);
+			CPPUNIT_ASSERT(moveCapture.oldPos == expected.oldPos);
+			CPPUNIT_ASSERT(moveCapture.newPos == expected.newPos);
+			CPPUNIT_ASSERT(moveCapture.defPT == expected.defPT);
+			CPPUNIT_ASSERT(moveCapture.defPiecePos == expected.defPiecePos);
+		}
+		else if (view.actionCode == GameMsgActionCode::PROMOTE)
+		{
+			auto expected = json::promotion(param);
+			Promotion promotion {PieceType::MOUNTAINS, PieceType::MOUNTAINS};
+
+			CPPUNIT_ASSERT(parser::parsePromotion(view.param, promotion) == Error::NONE);
+			CPPUNIT_ASSERT(promotion.origType == expected.origType);
+			CPPUNIT_ASSERT(promotion.newType == expected.newType);
+		}
+		else if (view.actionCode == GameMsgActionCode::SET_OPENING_ARRAY)
+		{
+			PieceMap pieceMap;
+			CPPUNIT_ASSERT(parser::parsePieceMap(view.param, pieceMap) == Error::NONE);
+			CPPUNIT_ASSERT(pieceMap == json::pieceMap(param));
+		}
+	}
+}
+
+void GameMsgParserTest::testMalformed()
+{
+	GameMsgView view;
+
+	CPPUNIT_ASSERT(parser::parseGameMsg("", view) == Error::SYNTAX_ERROR);
+	CPPUNIT_ASSERT(parser::parseGameMsg("[]", view) == Error::UNEXPECTED_TYPE);
+	CPPUNIT_ASSERT(parser::parseGameMsg("{\"msgType\":\"gameMsg\",\"msgData\":{\"action\":\"resign\"}", view)
+		== Error::SYNTAX_ERROR);
+	CPPUNIT_ASSERT(parser::parseGameMsg("{\"msgType\":\"gameMsg\",\"msgData\":{\"action\":\"resign\"}} x", view)
+		== Error::SYNTAX_ERROR);
+	CPPUNIT_ASSERT(parser::parseGameMsg("{\"msgType\":\"chatMsg\",\"msgData\":{\"action\":\"resign\"}}", view)
+		== Error::WRONG_MSG_TYPE);
+	CPPUNIT_ASSERT(parser::parseGameMsg("{\"msgType\":\"gameMsg\",\"msgData\":{}}", view) == Error::MISSING_MEMBER);
+	CPPUNIT_ASSERT(parser::parseGameMsg("{\"msgType\":\"gameMsg\",\"msgID\":1.5,\"msgData\":{\"action\":\"resign\"}}", view)
+		== Error::INVALID_MSG_ID);
+	CPPUNIT_ASSERT(parser::parseGameMsg("{\"msgType\":\"gameMsg\",\"x\":" + string(100, '[') + string(100, ']') + "}", view)
+		== Error::NESTING_TOO_DEEP);
+
+	// unknown members are skipped
+	CPPUNIT_ASSERT(parser::parseGameMsg("{\"x\":[1,-2e3,true,null,{\"\\\"\":\"\"}],\"msgType\":\"gameMsg\","
+	                                    "\"msgData\":{\"action\":\"resign\"}}", view) == Error::NONE);
+	CPPUNIT_ASSERT(view.action == "resign");
+	CPPUNIT_ASSERT(!view.msgID);
+
+	CPPUNIT_ASSERT(parser::parseGameMsg("{\"msgType\":\"gameMsg\",\"msgData\":{\"action\":\"fly\"}}", view)
+		== Error::NONE);
+	CPPUNIT_ASSERT(!view.actionCode);
+
+	Promotion promotion {PieceType::MOUNTAINS, PieceType::MOUNTAINS};
+	CPPUNIT_ASSERT(parser::parsePromotion("{\"origType\":\"rabble\"}", promotion) == Error::MISSING_MEMBER);
+	CPPUNIT_ASSERT(parser::parsePromotion("{\"origType\":\"rabble\",\"newType\":\"queen\"}", promotion)
+		== Error::INVALID_PIECE_TYPE);
+	CPPUNIT_ASSERT(parser::parsePromotion("{\"origType\":\"rabble\",\"newType\":5}", promotion)
+		== Error::UNEXPECTED_TYPE);
+
+	PieceMovement movement {PieceType::KING, HexCoordinate<6>(5, 5), HexCoordinate<6>(5, 5)};
+	CPPUNIT_ASSERT(parser::parseMovement("{\"pieceType\":\"king\",\"oldPos\":\"A1\",\"newPos\":\"A6\"}", movement)
+		== Error::INVALID_COORDINATE);
+	CPPUNIT_ASSERT(parser::parseMovement("{\"pieceType\":\"king\",\"oldPos\":\"A6\",\"newPos\":\"A6x\"}", movement)
+		== Error::INVALID_COORDINATE);
+
+	PiecePosition positions[2] {
+		{PieceType::KING, HexCoordinate<6>(5, 5)},
+		{PieceType::KING, HexCoordinate<6>(5, 5)}
+	};
+	size_t count;
+	CPPUNIT_ASSERT(parser::parsePiecePositions("{\"king\":[\"F2\"],\"rabble\":[\"G2\",\"G3\"]}", positions, 2, count)
+		== Error::TOO_MANY_PIECES);
+	CPPUNIT_ASSERT(parser::parsePiecePositions("{\"king\":null,\"rabble\":[\"G2\",\"G3\"]}", positions, 2, count)
+		== Error::NONE);
+	CPPUNIT_ASSERT_EQUAL(size_t(2), count);
+	CPPUNIT_ASSERT(positions[1].pieceType == PieceType::RABBLE);
+	CPPUNIT_ASSERT(positions[1].pos == HexCoordinate<6>("G3"));
+}
+
+void GameMsgParserTest::testActionLookup()
+{
+	for (auto&& it : GameMsgActionCodeStrPairs)
+		CPPUNIT_ASSERT(findGameMsgAction(it.second) == it.first);
+
+	for (auto&& it : ServerRequestActionCodeStrPairs)
+		CPPUNIT_ASSERT(findServerRequestAction(it.second) == it.first);
+
+	static_assert(findGameMsgAction("moveCapture") == GameMsgActionCode::MOVE_CAPTURE,
+		"perfect hash lookup doesn't work at compile time");
+
+	CPPUNIT_ASSERT(!findGameMsgAction(""));
+	CPPUNIT_ASSERT(!findGameMsgAction("mov"));
+	CPPUNIT_ASSERT(!findGameMsgAction("moveX"));
+	CPPUNIT_ASSERT(!findServerRequestAction(GameMsgAction::MOVE));
+
+	// the other ENUM_STR tables work the same way
+	static_assert(PieceTypeToStr(PieceType::LIGHT_HORSE) == "light horse", "");
+	static_assert(StrToPlayersColor("black") == PlayersColor::BLACK, "");
+	static_assert(!tryStrToPieceType("queen"), "");
+
+	CPPUNIT_ASSERT_THROW(StrToPieceType("queen"), invalid_argument);
+	CPPUNIT_ASSERT_THROW(PieceTypeToStr(static_cast<PieceType>(42)), invalid_argument);
+}
@@ -0,0 +1,98 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "game_msg_writer_test.hpp"
+
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <json/reader.h>
+#include <json/writer.h>
+#include <cyvws/game_msg.hpp>
+#include <cyvws/game_msg_writer.hpp>
+#include <cyvws/msg.hpp>
+#include <cyvws/common.hpp>
+
+using namespace std;
+using namespace cyvasse;
+using namespace cyvws;
+
+Json::Value GameMsgWriterTest::readExample(const string& name)
+{
+	ifstream file(string(WS_MSG_EXAMPLES_DIR) + "/gameMsg/" + name + ".json");
+	if (!file)
+		throw runtime_error("couldn't open example " + name);
+
+	Json::Value val;
+	string errs;
+	if (!Json::parseFromStream(Json::CharReaderBuilder(), file, &val, &errs))
+		throw runtime_error("couldn't parse example " + name + ": " + errs);
+
+	return val;
+}
+
+string GameMsgWriterTest::write(const Json::Value& val)
+{
+	Json::StreamWriterBuilder builder;
+	builder["indentation"] = "";
+
+	return Json::writeString(builder, val);
+}
+
+void GameMsgWriterTest::testExamples()
+{
+	GameMsgWriter writer;
+
+	auto param = readExample("move")[MSG_DATA][PARAM];
+	auto mv = json::movement(param);
+	CPPUNIT_ASSERT_EQUAL(
+		write(json::gameMsgMove(mv.pieceType, mv.oldPos, mv.newPos)),
+		writer.move(mv.pieceType, mv.oldPos, mv.newPos)
+	);
+
+	param = readExample("moveCapture")[MSG_DATA][PARAM];
+	auto mc = json::moveCapture(param);
+	CPPUNIT_ASSERT_EQUAL(
+		write(json::gameMsgMoveCapture(mc.atkPT, mc.oldPos, mc.newPos, mc.defPT, mc.defPiecePos)),
+		writer.moveCapture(mc.atkPT, mc.oldPos, mc.newPos, mc.defPT, mc.defPiecePos)
+	);
+
+	param = readExample("promote")[MSG_DATA][PARAM];
+	auto pr = json::promotion(param);
+	CPPUNIT_ASSERT_EQUAL(
+		write(json::gameMsgPromote(pr.origType, pr.newType)),
+		writer.promote(pr.origType, pr.newType)
+	);
+
+	CPPUNIT_ASSERT_EQUAL(write(json::gameMsgSetIsReady()), writer.setIsReady());
+
+	param = readExample("setOpeningArray")[MSG_DATA][PARAM];
+	auto pieceMap = json::pieceMap(param);
+	CPPUNIT_ASSERT_EQUAL(write(json::gameMsgSetOpeningArray(pieceMap)), writer.setOpeningArray(pieceMap));
+}
+
+void GameMsgWriterTest::testPieceMapEdgeCases()
+{
+	GameMsgWriter writer;
+
+	PieceMap pieceMap;
+	CPPUNIT_ASSERT_EQUAL(write(json::gameMsgSetOpeningArray(pieceMap)), writer.setOpeningArray(pieceMap));
+
+	pieceMap[PieceType::KING];
+	pieceMap[PieceType::LIGHT_HORSE].emplace("C4");
+	pieceMap[PieceType::LIGHT_HORSE].emplace("K3");
+	CPPUNIT_ASSERT_EQUAL(write(json::gameMsgSetOpeningArray(pieceMap)), writer.setOpeningArray(pieceMap));
+}
@@ -0,0 +1,216 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "game_record_test.hpp"
+
+#include <vector>
+#include <cyvasse/fortress.hpp>
+#include <cyvasse/game_record.hpp>
+#include <cyvasse/hexagon.hpp>
+#include <cyvasse/player.hpp>
+
+using namespace std;
+
+// forwards all board changes to a GameRecordWriter
+class RecordingMatch : public Match
+{
+	public:
+		GameRecordWriter writer;
+
+		RecordingMatch()
+			: Match("RECTEST", false, true)
+			, writer(*this)
+		{ }
+
+		void removeFromBoard(const Piece& piece) override
+		{
+			writer.removeFromBoard(piece);
+			Match::removeFromBoard(piece);
+		}
+
+		void pieceMoved(const Piece& piece, optional<HexCoordinate<6>> oldCoord) override
+		{ writer.pieceMoved(piece, oldCoord); }
+
+		void piecePromoted(const Piece& piece, PieceType origType) override
+		{ writer.piecePromoted(piece, origType); }
+
+		void endGame(PlayersColor winner) override
+		{ writer.endGame(winner); }
+};
+
+static uint8_t index(const string& coord)
+{ return static_cast<uint8_t>(Hexagon<6>::getIndex(HexCoordinate<6>(coord))); }
+
+void GameRecordTest::setUp()
+{
+	m_match.reset(new RecordingMatch);
+
+	m_match->setPlayer(PlayersColor::WHITE, unique_ptr<Player>(new Player(*m_match, PlayersColor::WHITE,
+		unique_ptr<Fortress>(new Fortress(PlayersColor::WHITE, HexCoordinate<6>("F2"))))));
+	m_match->setPlayer(PlayersColor::BLACK, unique_ptr<Player>(new Player(*m_match, PlayersColor::BLACK,
+		unique_ptr<Fortress>(new Fortress(PlayersColor::BLACK, HexCoordinate<6>("F10"))))));
+
+	addPiece(PieceType::KING,     PlayersColor::WHITE, "F2");
+	addPiece(PieceType::ELEPHANT, PlayersColor::WHITE, "G3");
+	addPiece(PieceType::RABBLE,   PlayersColor::WHITE, "D5");
+	addPiece(PieceType::KING,     PlayersColor::BLACK, "F10");
+	addPiece(PieceType::DRAGON,   PlayersColor::BLACK, "F6");
+
+	m_match->setupDone();
+	m_match->getBearingTable().init();
+	getWriter().start("default");
+}
+
+void GameRecordTest::tearDown()
+{
+	m_match.reset();
+}
+
+GameRecordWriter& GameRecordTest::getWriter()
+{
+	return static_cast<RecordingMatch&>(*m_match).writer;
+}
+
+void GameRecordTest::addPiece(PieceType type, PlayersColor color, const string& coord)
+{
+	auto piece = make_shared<Piece>(color, type, nullopt, *m_match);
+	m_match->getPlayer(color).getInactivePieces().emplace(type, piece);
+	m_match->addToBoard(type, color, HexCoordinate<6>(coord));
+}
+
+bool GameRecordTest::move(const string& from, const string& to)
+{
+	bool ret = m_match->getPieceAt(HexCoordinate<6>(from))->get().moveTo(HexCoordinate<6>(to), false);
+	m_match->getBearingTable().update();
+
+	return ret;
+}
+
+void GameRecordTest::testRoundTrip()
+{
+	auto headerSize = getWriter().getRecord().size();
+
+	// the white king leaves the fortress and is taken by the black dragon,
+	// then a white elephant enters the fortress and is promoted to king
+	CPPUNIT_ASSERT(move("F2", "F3"));
+	CPPUNIT_ASSERT(move("F6", "F3"));
+	CPPUNIT_ASSERT(m_match->getPlayer(PlayersColor::WHITE).isKingTaken());
+	CPPUNIT_ASSERT(move("G3", "F2"));
+	m_match->getPlayer(PlayersColor::WHITE).onTurnEnd();
+	CPPUNIT_ASSERT(!m_match->getPlayer(PlayersColor::WHITE).isKingTaken());
+	CPPUNIT_ASSERT(move("F10", "F9"));
+	m_match->endGame(PlayersColor::BLACK);
+	m_match->endGame(PlayersColor::WHITE); // ignored
+
+	const auto& record = getWriter().getRecord();
+	CPPUNIT_ASSERT(getWriter().isEnded());
+	CPPUNIT_ASSERT_EQUAL(headerSize + 2 + 3 + 2 + 2 + 2 + 2, record.size());
+
+	GameRecordReader reader(record);
+	const auto& header = reader.getHeader();
+	CPPUNIT_ASSERT_EQUAL(string("RECTEST"), header.matchID);
+	CPPUNIT_ASSERT_EQUAL(string("default"), header.ruleSet);
+	CPPUNIT_ASSERT(!header.random);
+	CPPUNIT_ASSERT(header._public);
+	CPPUNIT_ASSERT_EQUAL(size_t(3), header.openings[PlayersColor::WHITE].size());
+	CPPUNIT_ASSERT(header.openings[PlayersColor::BLACK].at(PieceType::DRAGON).count(HexCoordinate<6>("F6")));
+
+	Match match(header.matchID, header.random, header._public);
+	reader.setUp(match);
+
+	vector<GameRecordEventKind> kinds;
+	while (auto event = reader.next())
+	{
+		kinds.push_back(event->kind);
+
+		if (event->kind == GameRecordEventKind::CAPTURE)
+			CPPUNIT_ASSERT(event->pieceType == PieceType::KING);
+		if (event->kind == GameRecordEventKind::END)
+			CPPUNIT_ASSERT(event->winner == PlayersColor::BLACK);
+
+		CPPUNIT_ASSERT(reader.apply(match, *event));
+	}
+
+	CPPUNIT_ASSERT(kinds == vector<GameRecordEventKind>({
+		GameRecordEventKind::MOVE,
+		GameRecordEventKind::CAPTURE,
+		GameRecordEventKind::MOVE,
+		GameRecordEventKind::PROMOTION,
+		GameRecordEventKind::MOVE,
+		GameRecordEventKind::END
+	}));
+	CPPUNIT_ASSERT_EQUAL(record.size(), reader.getPos());
+
+	// the replayed board is the same as the recorded one
+	CPPUNIT_ASSERT_EQUAL(m_match->getActivePieces().size(), match.getActivePieces().size());
+	for (const auto& it : m_match->getActivePieces())
+	{
+		auto piece = match.getPieceAt(it.first);
+		CPPUNIT_ASSERT(piece);
+		CPPUNIT_ASSERT(piece->get().getType() == it.second->getType());
+		CPPUNIT_ASSERT(piece->get().getColor() == it.second->getColor());
+	}
+}
+
+void GameRecordTest::testIllegalMoves()
+{
+	auto record = getWriter().getRecord();
+
+	// black dragon on white's turn, rabble moving two tiles,
+	// capture of a piece that isn't there, then a legal move
+	for (auto move : {string{char(index("F6")), char(index("F5"))},
+	                  string{char(index("D5")), char(index("D7"))},
+	                  string{char(index("G3")), char(index("H4") | 0x80), char(PieceType::RABBLE)},
+	                  string{char(index("D5")), char(index("D6"))}})
+		record += move;
+
+	GameRecordReader reader(record);
+
+	Match match(reader.getHeader().matchID);
+	reader.setUp(match);
+
+	for (auto expected : {false, false, false, true})
+	{
+		auto event = reader.next();
+		CPPUNIT_ASSERT(event);
+		CPPUNIT_ASSERT_EQUAL(expected, reader.apply(match, *event));
+	}
+
+	CPPUNIT_ASSERT(!reader.next());
+	CPPUNIT_ASSERT(reader.getTurn() == PlayersColor::BLACK);
+}
+
+void GameRecordTest::testMalformedRecords()
+{
+	const auto& record = getWriter().getRecord();
+
+	CPPUNIT_ASSERT_THROW(GameRecordReader("CYVX"), GameRecordError);
+	CPPUNIT_ASSERT_THROW(GameRecordReader(string_view(record).substr(0, record.size() - 1)), GameRecordError);
+
+	{
+		// move without target tile
+		auto truncated = record + char(index("D5"));
+		GameRecordReader reader(truncated);
+		CPPUNIT_ASSERT_THROW(reader.next(), GameRecordError);
+	}
+
+	{
+		// tile index out of range
+		auto invalid = record + string{char(index("D5")), char(Hexagon<6>::tileCount)};
+		GameRecordReader reader(invalid);
+		CPPUNIT_ASSERT_THROW(reader.next(), GameRecordError);
+	}
+}
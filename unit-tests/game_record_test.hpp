@@ -0,0 +1,55 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _GAME_RECORD_TEST_HPP_
+#define _GAME_RECORD_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+
+#include <memory>
+#include <string>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cyvasse/game_record.hpp>
+#include <cyvasse/match.hpp>
+
+using namespace cyvasse;
+
+class GameRecordTest : public CppUnit::TestFixture
+{
+	private:
+		std::unique_ptr<Match> m_match;
+
+		GameRecordWriter& getWriter();
+
+		void addPiece(PieceType, PlayersColor, const std::string& coord);
+		bool move(const std::string& from, const std::string& to);
+
+	public:
+		void setUp() override;
+		void tearDown() override;
+
+		void testRoundTrip();
+		void testIllegalMoves();
+		void testMalformedRecords();
+
+	CPPUNIT_TEST_SUITE(GameRecordTest);
+		CPPUNIT_TEST(testRoundTrip);
+		CPPUNIT_TEST(testIllegalMoves);
+		CPPUNIT_TEST(testMalformedRecords);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+#endif // _GAME_RECORD_TEST_HPP_
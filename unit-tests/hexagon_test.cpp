@@ -138,12 +138,34 @@ void HexagonTest::testCoordCompleteness()
 	);
 }
 
+void HexagonTest::testCoordIndex()
+{
+	uint16_t i = 0;
+
+	for (const auto& coord : Hexagon<6>::allCoordinates)
+	{
+		CPPUNIT_ASSERT_EQUAL(int(i), int(Hexagon<6>::getIndex(coord)));
+		CPPUNIT_ASSERT_EQUAL(coord, Hexagon<6>::getCoordinate(i));
+		i++;
+	}
+
+	CPPUNIT_ASSERT_EQUAL(int(Hexagon<6>::tileCount), int(i));
+
+	static_assert(Hexagon<6>::getIndex(HexCoordinate<6>(0, 5)) == 0, "");
+	static_assert(Hexagon<6>::getIndex(HexCoordinate<6>(10, 5)) == Hexagon<6>::tileCount - 1, "");
+}
+
 void HexagonTest::testCoordToString()
 {
 	CPPUNIT_ASSERT_EQUAL(h6Coords.size(), h6CoordStrings.size());
 
 	for (size_t i = 0; i < h6Coords.size(); i++)
+	{
 		CPPUNIT_ASSERT_EQUAL(h6Coords[i].toString(), h6CoordStrings[i]);
+		CPPUNIT_ASSERT(h6Coords[i].toStringView() == h6CoordStrings[i]);
+	}
+
+	static_assert(HexCoordinate<6>(10, 5).toStringView() == "K6", "");
 }
 
 void HexagonTest::testCoordFromString()
@@ -151,7 +173,15 @@ void HexagonTest::testCoordFromString()
 	CPPUNIT_ASSERT_EQUAL(h6Coords.size(), h6CoordStrings.size());
 
 	for (size_t i = 0; i < h6Coords.size(); i++)
+	{
 		CPPUNIT_ASSERT_EQUAL(HexCoordinate<6>(h6CoordStrings[i]), h6Coords[i]);
+		CPPUNIT_ASSERT(HexCoordinate<6>::tryParse(h6CoordStrings[i]) == h6Coords[i]);
+	}
+
+	for (auto str : {"", "F", "f6", "F0", "F06", "F6 ", " F6", "F+6", "A1", "K12", "F100", "\xff" "6"})
+		CPPUNIT_ASSERT(!HexCoordinate<6>::tryParse(str));
+
+	CPPUNIT_ASSERT_THROW(HexCoordinate<6>("F6x"), std::invalid_argument);
 }
 
 void HexagonTest::testDistanceOrthogonal()
@@ -38,6 +38,7 @@ class HexagonTest : public CppUnit::TestFixture
 		void testCoordValidity();
 		void testCoordEquality();
 		void testCoordCompleteness();
+		void testCoordIndex();
 
 		void testCoordToString();
 		void testCoordFromString();
@@ -53,6 +54,7 @@ class HexagonTest : public CppUnit::TestFixture
 		CPPUNIT_TEST(testCoordValidity);
 		CPPUNIT_TEST(testCoordEquality);
 		CPPUNIT_TEST(testCoordCompleteness);
+		CPPUNIT_TEST(testCoordIndex);
 
 		CPPUNIT_TEST(testCoordToString);
 		CPPUNIT_TEST(testCoordFromString);
@@ -15,12 +15,54 @@
  */
 
 #include <cppunit/ui/text/TestRunner.h>
+#include "arena_msg_test.hpp"
+#include "binary_msg_test.hpp"
+#include "connection_pool_test.hpp"
+#include "encoded_msg_test.hpp"
+#include "game_archive_test.hpp"
+#include "game_record_test.hpp"
+#include "game_msg_parser_test.hpp"
+#include "game_msg_writer_test.hpp"
 #include "hexagon_test.hpp"
+#include "match_registry_test.hpp"
+#include "match_test.hpp"
+#include "msg_compression_test.hpp"
+#include "msg_validator_test.hpp"
+#include "notification_coalescer_test.hpp"
+#include "transposition_table_test.hpp"
+#include "versioned_games_list_test.hpp"
+#include "write_behind_queue_test.hpp"
 
 int main()
 {
 	CppUnit::TextUi::TestRunner testRunner;
+	testRunner.addTest(ArenaMsgTest::suite());
+	testRunner.addTest(BinaryMsgTest::suite());
+#ifdef BUILD_CYVDB
+	testRunner.addTest(ConnectionPoolTest::suite());
+#endif
+	testRunner.addTest(EncodedMsgTest::suite());
+#ifdef HAVE_MMAP
+	testRunner.addTest(GameArchiveTest::suite());
+#endif
+	testRunner.addTest(GameRecordTest::suite());
+	testRunner.addTest(GameMsgParserTest::suite());
+	testRunner.addTest(GameMsgWriterTest::suite());
 	testRunner.addTest(HexagonTest::suite());
+#ifdef BUILD_CYVDB
+	testRunner.addTest(MatchRegistryTest::suite());
+#endif
+	testRunner.addTest(MatchTest::suite());
+#ifdef HAVE_ZLIB
+	testRunner.addTest(MsgCompressionTest::suite());
+#endif
+	testRunner.addTest(MsgValidatorTest::suite());
+	testRunner.addTest(NotificationCoalescerTest::suite());
+	testRunner.addTest(TranspositionTableTest::suite());
+	testRunner.addTest(VersionedGamesListTest::suite());
+#ifdef BUILD_CYVDB
+	testRunner.addTest(WriteBehindQueueTest::suite());
+#endif
 
 	testRunner.run();
 
@@ -0,0 +1,225 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "match_registry_test.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cyvdb/match_registry.hpp>
+
+using namespace std;
+using namespace cyvasse;
+using namespace cyvdb;
+
+/// MatchRegistry on top of a vector instead of the database
+class MemoryMatchRegistry : public MatchRegistry
+{
+	public:
+		/// The matches table, in creation order
+		vector<MatchInfo> rows;
+		bool failWrites = false;
+
+		MemoryMatchRegistry()
+			: MatchRegistry(nullptr)
+		{ }
+
+	private:
+		void checkWrite()
+		{
+			if (failWrites)
+				throw runtime_error("database unavailable");
+		}
+
+		MatchInfo& getRow(const string& matchID)
+		{
+			return *find_if(rows.begin(), rows.end(), [&](const MatchInfo& row) { return row.id == matchID; });
+		}
+
+	protected:
+		vector<MatchInfo> loadMatches() override
+		{ return rows; }
+
+		void insertMatch(const MatchInfo& match) override
+		{
+			checkWrite();
+			rows.push_back(match);
+		}
+
+		void deleteMatch(const MatchInfo& match) override
+		{
+			checkWrite();
+			rows.erase(find_if(rows.begin(), rows.end(), [&](const MatchInfo& row) { return row.id == match.id; }));
+		}
+
+		void insertPlayer(const string& matchID, PlayersColor color, const string& playerID) override
+		{
+			checkWrite();
+			getRow(matchID).playerIDs[color] = playerID;
+		}
+
+		void deletePlayer(const string& playerID) override
+		{
+			checkWrite();
+			for (auto& row : rows)
+				for (auto& id : row.playerIDs)
+					if (id == playerID)
+						id.clear();
+		}
+};
+
+static MatchInfo makeMatch(const string& id, bool isRandom, bool isPublic,
+	const string& whitePlayer = "", const string& blackPlayer = "")
+{
+	MatchInfo match;
+	match.id = id;
+	match.ruleSet = "default";
+	match.isRandom = isRandom;
+	match.isPublic = isPublic;
+	match.playerIDs[PlayersColor::WHITE] = whitePlayer;
+	match.playerIDs[PlayersColor::BLACK] = blackPlayer;
+
+	return match;
+}
+
+static string getIDs(const vector<MatchInfo>& matches)
+{
+	string ret;
+	for (auto&& match : matches)
+		ret += (ret.empty() ? "" : " ") + match.id;
+
+	return ret;
+}
+
+void MatchRegistryTest::testLoad()
+{
+	MemoryMatchRegistry registry;
+	registry.rows = {
+		makeMatch("DDDD", true,  false, "player01"),
+		makeMatch("BBBB", false, true,  "player02", "player03"),
+		makeMatch("CCCC", true,  false),
+		makeMatch("AAAA", true,  true,  "",         "player04"),
+		makeMatch("EEEE", true,  true,  "player05", "player06")
+	};
+
+	registry.load();
+	CPPUNIT_ASSERT_EQUAL(size_t(5), registry.size());
+
+	// in the order of the table, not sorted by ID
+	CPPUNIT_ASSERT_EQUAL(string("DDDD AAAA"), getIDs(registry.getOpenRandomMatches()));
+	CPPUNIT_ASSERT_EQUAL(string("BBBB EEEE"), getIDs(registry.getRunningPublicMatches()));
+
+	CPPUNIT_ASSERT(registry.getMatch("CCCC"));
+	auto match = registry.getMatch("AAAA");
+	CPPUNIT_ASSERT(match);
+	CPPUNIT_ASSERT_EQUAL(string("player04"), match->playerIDs[PlayersColor::BLACK]);
+	CPPUNIT_ASSERT(!registry.getMatch("FFFF"));
+
+	// new matches come after the loaded ones
+	registry.addMatch(makeMatch("0000", true, false, "player07"));
+	CPPUNIT_ASSERT_EQUAL(string("DDDD AAAA 0000"), getIDs(registry.getOpenRandomMatches()));
+
+	// load() replaces everything
+	registry.rows.erase(registry.rows.begin());
+	registry.load();
+	CPPUNIT_ASSERT_EQUAL(size_t(5), registry.size());
+	CPPUNIT_ASSERT(!registry.getMatch("DDDD"));
+	CPPUNIT_ASSERT_EQUAL(string("AAAA 0000"), getIDs(registry.getOpenRandomMatches()));
+}
+
+void MatchRegistryTest::testPlayerTransitions()
+{
+	MemoryMatchRegistry registry;
+	registry.addMatch(makeMatch("AAAA", true, true, "player01"));
+	registry.addMatch(makeMatch("BBBB", true, false, "player02"));
+
+	CPPUNIT_ASSERT_EQUAL(string("AAAA BBBB"), getIDs(registry.getOpenRandomMatches()));
+	CPPUNIT_ASSERT(registry.getRunningPublicMatches().empty());
+
+	// the second player starts the match
+	registry.addPlayer("AAAA", PlayersColor::BLACK, "player03");
+	CPPUNIT_ASSERT_EQUAL(string("BBBB"), getIDs(registry.getOpenRandomMatches()));
+	CPPUNIT_ASSERT_EQUAL(string("AAAA"), getIDs(registry.getRunningPublicMatches()));
+	CPPUNIT_ASSERT_EQUAL(string("player03"), registry.rows[0].playerIDs[PlayersColor::BLACK]);
+
+	// a private match never is a running public match
+	registry.addPlayer("BBBB", PlayersColor::BLACK, "player04");
+	CPPUNIT_ASSERT(registry.getOpenRandomMatches().empty());
+	CPPUNIT_ASSERT_EQUAL(string("AAAA"), getIDs(registry.getRunningPublicMatches()));
+
+	// back in the open list, at its old position
+	registry.removePlayer("BBBB", PlayersColor::WHITE);
+	registry.removePlayer("AAAA", PlayersColor::WHITE);
+	CPPUNIT_ASSERT_EQUAL(string("AAAA BBBB"), getIDs(registry.getOpenRandomMatches()));
+	CPPUNIT_ASSERT(registry.getRunningPublicMatches().empty());
+	CPPUNIT_ASSERT(registry.rows[0].playerIDs[PlayersColor::WHITE].empty());
+
+	// without players, a match is in neither list
+	registry.removePlayer("AAAA", PlayersColor::BLACK);
+	CPPUNIT_ASSERT_EQUAL(string("BBBB"), getIDs(registry.getOpenRandomMatches()));
+	CPPUNIT_ASSERT_EQUAL(0u, registry.getMatch("AAAA")->getPlayerCount());
+
+	CPPUNIT_ASSERT_THROW(registry.addPlayer("BBBB", PlayersColor::BLACK, "player05"), invalid_argument);
+	CPPUNIT_ASSERT_THROW(registry.removePlayer("AAAA", PlayersColor::WHITE), invalid_argument);
+	CPPUNIT_ASSERT_THROW(registry.addPlayer("CCCC", PlayersColor::WHITE, "player05"), invalid_argument);
+}
+
+void MatchRegistryTest::testRemove()
+{
+	MemoryMatchRegistry registry;
+	registry.addMatch(makeMatch("AAAA", true, false, "player01"));
+	registry.addMatch(makeMatch("BBBB", false, true, "player02", "player03"));
+	registry.addMatch(makeMatch("CCCC", true, false, "player04"));
+
+	CPPUNIT_ASSERT_THROW(registry.addMatch(makeMatch("AAAA", false, false)), invalid_argument);
+	CPPUNIT_ASSERT_EQUAL(size_t(3), registry.rows.size());
+
+	registry.removeMatch("AAAA");
+	registry.removeMatch("BBBB");
+	CPPUNIT_ASSERT_EQUAL(size_t(1), registry.size());
+	CPPUNIT_ASSERT(!registry.getMatch("AAAA"));
+	CPPUNIT_ASSERT_EQUAL(string("CCCC"), getIDs(registry.getOpenRandomMatches()));
+	CPPUNIT_ASSERT(registry.getRunningPublicMatches().empty());
+	CPPUNIT_ASSERT_EQUAL(size_t(1), registry.rows.size());
+
+	CPPUNIT_ASSERT_THROW(registry.removeMatch("AAAA"), invalid_argument);
+
+	// the ID can be used again
+	registry.addMatch(makeMatch("AAAA", true, false, "player05"));
+	CPPUNIT_ASSERT_EQUAL(string("CCCC AAAA"), getIDs(registry.getOpenRandomMatches()));
+}
+
+void MatchRegistryTest::testWriteFailure()
+{
+	MemoryMatchRegistry registry;
+	registry.addMatch(makeMatch("AAAA", true, true, "player01"));
+
+	// the registry is only updated after the database
+	registry.failWrites = true;
+	CPPUNIT_ASSERT_THROW(registry.addMatch(makeMatch("BBBB", true, false, "player02")), runtime_error);
+	CPPUNIT_ASSERT_THROW(registry.addPlayer("AAAA", PlayersColor::BLACK, "player03"), runtime_error);
+	CPPUNIT_ASSERT_THROW(registry.removeMatch("AAAA"), runtime_error);
+
+	CPPUNIT_ASSERT_EQUAL(size_t(1), registry.size());
+	CPPUNIT_ASSERT(!registry.getMatch("BBBB"));
+	CPPUNIT_ASSERT_EQUAL(string("AAAA"), getIDs(registry.getOpenRandomMatches()));
+	CPPUNIT_ASSERT(registry.getRunningPublicMatches().empty());
+
+	registry.failWrites = false;
+	registry.addPlayer("AAAA", PlayersColor::BLACK, "player03");
+	CPPUNIT_ASSERT_EQUAL(string("AAAA"), getIDs(registry.getRunningPublicMatches()));
+}
@@ -0,0 +1,288 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "match_test.hpp"
+
+#include <sstream>
+#include <cyvasse/evaluator.hpp>
+#include <cyvasse/exchange.hpp>
+#include <cyvasse/fortress.hpp>
+#include <cyvasse/move_generator.hpp>
+#include <cyvasse/player.hpp>
+#include <cyvws/game_status_cache.hpp>
+#include <cyvws/server_reply.hpp>
+#include <json/reader.h>
+
+using namespace std;
+
+// forwards all board changes to an Evaluator
+class EvalMatch : public Match
+{
+	public:
+		Evaluator evaluator;
+
+		EvalMatch()
+			: Match("TEST")
+			, evaluator(make_shared<EvalWeights>(EvalWeights::defaults()))
+		{ }
+
+		void addToBoard(PieceType type, PlayersColor color, HexCoordinate<6> coord) override
+		{
+			Match::addToBoard(type, color, coord);
+			evaluator.pieceAdded(type, color, coord);
+		}
+
+		void removeFromBoard(const Piece& piece) override
+		{
+			evaluator.pieceRemoved(piece.getType(), piece.getColor(), *piece.getCoord());
+			Match::removeFromBoard(piece);
+		}
+
+		void pieceMoved(const Piece& piece, optional<HexCoordinate<6>> oldCoord) override
+		{
+			if (oldCoord)
+				evaluator.pieceMoved(piece.getType(), piece.getColor(), *oldCoord, *piece.getCoord());
+			else
+				evaluator.pieceAdded(piece.getType(), piece.getColor(), *piece.getCoord());
+		}
+};
+
+void MatchTest::setUp()
+{
+	m_match.reset(new EvalMatch);
+
+	m_match->setPlayer(PlayersColor::WHITE, unique_ptr<Player>(new Player(*m_match, PlayersColor::WHITE,
+		unique_ptr<Fortress>(new Fortress(PlayersColor::WHITE, HexCoordinate<6>("F2"))))));
+	m_match->setPlayer(PlayersColor::BLACK, unique_ptr<Player>(new Player(*m_match, PlayersColor::BLACK,
+		unique_ptr<Fortress>(new Fortress(PlayersColor::BLACK, HexCoordinate<6>("F10"))))));
+
+	addPiece(PieceType::KING,        PlayersColor::WHITE, "F2");
+	addPiece(PieceType::RABBLE,      PlayersColor::WHITE, "D5");
+	addPiece(PieceType::CROSSBOWS,   PlayersColor::WHITE, "D3");
+	addPiece(PieceType::MOUNTAINS,   PlayersColor::WHITE, "G5");
+	addPiece(PieceType::KING,        PlayersColor::BLACK, "F10");
+	addPiece(PieceType::RABBLE,      PlayersColor::BLACK, "D6");
+	addPiece(PieceType::LIGHT_HORSE, PlayersColor::BLACK, "H8");
+
+	m_match->setupDone();
+	m_match->getBearingTable().init();
+}
+
+void MatchTest::tearDown()
+{
+	m_match.reset();
+}
+
+Piece& MatchTest::addPiece(PieceType type, PlayersColor color, const string& coord)
+{
+	auto piece = make_shared<Piece>(color, type, nullopt, *m_match);
+	m_match->getPlayer(color).getInactivePieces().emplace(type, piece);
+	m_match->addToBoard(type, color, HexCoordinate<6>(coord));
+
+	return *piece;
+}
+
+void MatchTest::testMoveCacheLookup()
+{
+	auto& moveCache = m_match->getMoveCache();
+
+	for (const auto& it : m_match->getActivePieces())
+	{
+		const Piece& piece = *it.second;
+
+		if (piece.getType() == PieceType::MOUNTAINS)
+			CPPUNIT_ASSERT(moveCache.getTargetMask(piece).none());
+		else
+			CPPUNIT_ASSERT(moveCache.getPossibleTargetTiles(piece) == piece.getPossibleTargetTiles());
+	}
+
+	CPPUNIT_ASSERT(moveCache.isValid());
+}
+
+void MatchTest::testMoveCacheInvalidation()
+{
+	auto& moveCache = m_match->getMoveCache();
+
+	Piece& rabble = m_match->getPieceAt(HexCoordinate<6>("D5"))->get();
+	Piece& crossbows = m_match->getPieceAt(HexCoordinate<6>("D3"))->get();
+
+	auto oldTargets = moveCache.getPossibleTargetTiles(crossbows);
+	CPPUNIT_ASSERT(oldTargets.count(HexCoordinate<6>("D4")));
+	CPPUNIT_ASSERT(!oldTargets.count(HexCoordinate<6>("D6")));
+
+	CPPUNIT_ASSERT(rabble.moveTo(HexCoordinate<6>("E5"), false));
+	CPPUNIT_ASSERT(!moveCache.isValid());
+
+	auto newTargets = moveCache.getPossibleTargetTiles(crossbows);
+	CPPUNIT_ASSERT(newTargets == crossbows.getPossibleTargetTiles());
+	CPPUNIT_ASSERT(newTargets.count(HexCoordinate<6>("D5")));
+}
+
+void MatchTest::testMoveGeneratorStages()
+{
+	MoveGenerator moveGen(*m_match, PlayersColor::WHITE);
+	CPPUNIT_ASSERT(moveGen.hasCapture());
+
+	auto move = moveGen.next();
+	CPPUNIT_ASSERT(move);
+	CPPUNIT_ASSERT(move->kind == MoveKind::CAPTURE);
+	CPPUNIT_ASSERT(move->pieceType == PieceType::RABBLE);
+	CPPUNIT_ASSERT(move->defType == PieceType::RABBLE);
+	CPPUNIT_ASSERT_EQUAL(HexCoordinate<6>("D6"), move->newPos);
+
+	size_t quietCount = 0;
+	for (; (move = moveGen.next()); quietCount++)
+	{
+		CPPUNIT_ASSERT(move->kind == MoveKind::QUIET);
+		CPPUNIT_ASSERT(!m_match->getPieceAt(move->newPos));
+	}
+
+	size_t targetCount = 0;
+	for (const auto& it : m_match->getActivePieces())
+		if (it.second->getColor() == PlayersColor::WHITE)
+			targetCount += m_match->getMoveCache().getTargetMask(*it.second).count();
+
+	CPPUNIT_ASSERT_EQUAL(targetCount, quietCount + 1);
+}
+
+void MatchTest::testStaticExchangeEval()
+{
+	// white rabble takes black rabble, black can't recapture
+	CPPUNIT_ASSERT_EQUAL(1, staticExchangeEval(*m_match, HexCoordinate<6>("D6")));
+	CPPUNIT_ASSERT(isHanging(*m_match, m_match->getPieceAt(HexCoordinate<6>("D6"))->get()));
+
+	// black rabble takes white rabble, white crossbows recapture
+	CPPUNIT_ASSERT_EQUAL(0, staticExchangeEval(*m_match, HexCoordinate<6>("D5")));
+	CPPUNIT_ASSERT(!isHanging(*m_match, m_match->getPieceAt(HexCoordinate<6>("D5"))->get()));
+
+	// empty tile and mountains
+	CPPUNIT_ASSERT_EQUAL(0, staticExchangeEval(*m_match, HexCoordinate<6>("E5")));
+	CPPUNIT_ASSERT_EQUAL(0, staticExchangeEval(*m_match, HexCoordinate<6>("G5")));
+}
+
+void MatchTest::testEvaluatorIncremental()
+{
+	auto& evaluator = static_cast<EvalMatch&>(*m_match).evaluator;
+	evaluator.init(*m_match);
+
+	auto check = [&] {
+		Evaluator fresh(make_shared<EvalWeights>(EvalWeights::defaults()));
+		fresh.init(*m_match);
+
+		CPPUNIT_ASSERT_EQUAL(fresh.getScore(PlayersColor::WHITE), evaluator.getScore(PlayersColor::WHITE));
+		CPPUNIT_ASSERT_EQUAL(-evaluator.getScore(PlayersColor::WHITE), evaluator.getScore(PlayersColor::BLACK));
+	};
+
+	check();
+	auto before = evaluator.getScore(PlayersColor::WHITE);
+
+	// white rabble takes black rabble
+	CPPUNIT_ASSERT(m_match->getPieceAt(HexCoordinate<6>("D5"))->get().moveTo(HexCoordinate<6>("D6"), false));
+	check();
+	CPPUNIT_ASSERT(evaluator.getScore(PlayersColor::WHITE) > before);
+
+	CPPUNIT_ASSERT(m_match->getPieceAt(HexCoordinate<6>("F10"))->get().moveTo(HexCoordinate<6>("F9"), false));
+	check();
+}
+
+void MatchTest::testEvalWeightsReadWrite()
+{
+	auto weights = EvalWeights::defaults();
+	weights.material[size_t(PieceType::LIGHT_HORSE)] = 222;
+	weights.pieceSquare[size_t(PieceType::KING)][7] = -3;
+	weights.kingDistance = -9;
+
+	stringstream ss;
+	weights.write(ss);
+
+	auto readWeights = EvalWeights::read(ss);
+	CPPUNIT_ASSERT(readWeights.material == weights.material);
+	CPPUNIT_ASSERT(readWeights.pieceSquare == weights.pieceSquare);
+	CPPUNIT_ASSERT_EQUAL(-9, readWeights.kingDistance);
+
+	stringstream partial("# comment\nmaterial light horse = 150 # trailing\n\nfortress = 10\n");
+	readWeights = EvalWeights::read(partial);
+	CPPUNIT_ASSERT_EQUAL(150, readWeights.material[size_t(PieceType::LIGHT_HORSE)]);
+	CPPUNIT_ASSERT_EQUAL(10, readWeights.fortress);
+	CPPUNIT_ASSERT_EQUAL(EvalWeights::defaults().homeTerrain, readWeights.homeTerrain);
+
+	stringstream invalid("material spaceship = 1\n");
+	CPPUNIT_ASSERT_THROW(EvalWeights::read(invalid), runtime_error);
+}
+
+void MatchTest::testGameStatusCache()
+{
+	cyvws::GameStatusCache cache(*m_match);
+
+	auto status = cache.get();
+	CPPUNIT_ASSERT(cache.get() == status);
+	CPPUNIT_ASSERT_EQUAL(uint64_t(1), cache.getRebuildCount());
+
+	Json::Value replyData;
+	replyData[cyvws::SUCCESS] = true;
+
+	Json::Value reply;
+	string errs;
+	istringstream replyStream(string(cache.joinGameReply(3, replyData).getPayload()));
+	CPPUNIT_ASSERT(Json::parseFromStream(Json::CharReaderBuilder(), replyStream, &reply, &errs));
+
+	auto& gameStatus = reply[cyvws::REPLY_DATA][cyvws::GAME_STATUS];
+	CPPUNIT_ASSERT(reply[cyvws::REPLY_DATA][cyvws::SUCCESS].asBool());
+	CPPUNIT_ASSERT(!gameStatus[cyvws::SETUP].asBool());
+	CPPUNIT_ASSERT_EQUAL(string("D5"), gameStatus[cyvws::PIECE_POSITIONS]["white"]["rabble"][0].asString());
+	CPPUNIT_ASSERT_EQUAL(string("H8"), gameStatus[cyvws::PIECE_POSITIONS]["black"]["light horse"][0].asString());
+
+	// a move changes the match version, the next joiner gets a new snapshot
+	auto version = m_match->getVersion();
+	CPPUNIT_ASSERT(m_match->getPieceAt(HexCoordinate<6>("D5"))->get().moveTo(HexCoordinate<6>("E5"), false));
+	CPPUNIT_ASSERT(m_match->getVersion() != version);
+
+	auto newStatus = cache.get();
+	CPPUNIT_ASSERT(newStatus != status);
+	CPPUNIT_ASSERT(newStatus->find("\"E5\"") != string::npos);
+	CPPUNIT_ASSERT_EQUAL(uint64_t(2), cache.getRebuildCount());
+}
+
+void MatchTest::testGameStatusInSetup()
+{
+	m_match.reset(new EvalMatch);
+	m_match->setPlayer(PlayersColor::WHITE, unique_ptr<Player>(new Player(*m_match, PlayersColor::WHITE,
+		unique_ptr<Fortress>(new Fortress(PlayersColor::WHITE, HexCoordinate<6>("F2"))))));
+	m_match->setPlayer(PlayersColor::BLACK, unique_ptr<Player>(new Player(*m_match, PlayersColor::BLACK,
+		unique_ptr<Fortress>(new Fortress(PlayersColor::BLACK, HexCoordinate<6>("F10"))))));
+
+	addPiece(PieceType::KING,   PlayersColor::WHITE, "F2");
+	addPiece(PieceType::RABBLE, PlayersColor::BLACK, "D6");
+
+	// nobody joining during the setup may see where the pieces were placed
+	cyvws::GameStatusCache cache(*m_match);
+	Json::Value replyData;
+	replyData[cyvws::SUCCESS] = true;
+
+	Json::Value reply;
+	string errs;
+	string payload(cache.joinGameReply(4, replyData).getPayload());
+	istringstream replyStream(payload);
+	CPPUNIT_ASSERT(Json::parseFromStream(Json::CharReaderBuilder(), replyStream, &reply, &errs));
+
+	auto& gameStatus = reply[cyvws::REPLY_DATA][cyvws::GAME_STATUS];
+	CPPUNIT_ASSERT(gameStatus[cyvws::SETUP].asBool());
+	CPPUNIT_ASSERT(!gameStatus.isMember(cyvws::PIECE_POSITIONS));
+	CPPUNIT_ASSERT(payload.find("\"D6\"") == string::npos);
+
+	m_match->setupDone();
+	CPPUNIT_ASSERT(cache.get()->find("\"D6\"") != string::npos);
+}
@@ -0,0 +1,60 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MATCH_TEST_HPP_
+#define _MATCH_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+
+#include <memory>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cyvasse/match.hpp>
+
+using namespace cyvasse;
+
+class MatchTest : public CppUnit::TestFixture
+{
+	private:
+		std::unique_ptr<Match> m_match;
+
+		Piece& addPiece(PieceType, PlayersColor, const std::string& coord);
+
+	public:
+		void setUp() override;
+		void tearDown() override;
+
+		void testMoveCacheLookup();
+		void testMoveCacheInvalidation();
+		void testMoveGeneratorStages();
+		void testStaticExchangeEval();
+		void testEvaluatorIncremental();
+		void testEvalWeightsReadWrite();
+		void testGameStatusCache();
+		void testGameStatusInSetup();
+
+	CPPUNIT_TEST_SUITE(MatchTest);
+		CPPUNIT_TEST(testMoveCacheLookup);
+		CPPUNIT_TEST(testMoveCacheInvalidation);
+		CPPUNIT_TEST(testMoveGeneratorStages);
+		CPPUNIT_TEST(testStaticExchangeEval);
+		CPPUNIT_TEST(testEvaluatorIncremental);
+		CPPUNIT_TEST(testEvalWeightsReadWrite);
+		CPPUNIT_TEST(testGameStatusCache);
+		CPPUNIT_TEST(testGameStatusInSetup);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+#endif // _MATCH_TEST_HPP_
@@ -0,0 +1,100 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "msg_compression_test.hpp"
+
+#include <string>
+#include <vector>
+#include <cyvws/game_msg_writer.hpp>
+#include <cyvws/msg_compression.hpp>
+
+using namespace std;
+using namespace cyvasse;
+using namespace cyvws;
+
+static vector<string> sampleMsgs()
+{
+	GameMsgWriter writer;
+
+	return {
+		writer.move(PieceType::LIGHT_HORSE, HexCoordinate<6>("C4"), HexCoordinate<6>("D6")),
+		writer.move(PieceType::KING, HexCoordinate<6>("H2"), HexCoordinate<6>("H3")),
+		writer.moveCapture(PieceType::DRAGON, HexCoordinate<6>("G4"), HexCoordinate<6>("E8"),
+			PieceType::SPEARS, HexCoordinate<6>("E8")),
+		writer.promote(PieceType::CROSSBOWS, PieceType::TREBUCHET),
+		R"({"msgType":"chatMsg","msgID":6,"msgData":{"content":"Hey! é"}})",
+		string(5000, 'x')
+	};
+}
+
+void MsgCompressionTest::testRoundTrip()
+{
+	for (bool contextTakeover : {true, false})
+	{
+		MsgDeflater deflater(defaultDictionary(), contextTakeover);
+		MsgInflater inflater(defaultDictionary(), contextTakeover);
+
+		for (unsigned round = 0; round < 2; round++)
+		{
+			for (auto&& msg : sampleMsgs())
+			{
+				string compressed(deflater.compress(msg));
+				CPPUNIT_ASSERT(compressed.size() < msg.size());
+
+				auto decompressed = inflater.decompress(compressed);
+				CPPUNIT_ASSERT(decompressed);
+				CPPUNIT_ASSERT(*decompressed == msg);
+			}
+		}
+	}
+}
+
+void MsgCompressionTest::testDictionary()
+{
+	CPPUNIT_ASSERT(defaultDictionary().size() <= 4096);
+	CPPUNIT_ASSERT(defaultDictionary().find("\"msgType\":\"gameMsg\"") != string::npos);
+	CPPUNIT_ASSERT(getDictionaryID(defaultDictionary()) != getDictionaryID(""));
+
+	auto msg = sampleMsgs().front();
+
+	MsgDeflater plain("", false);
+	MsgDeflater withDict(defaultDictionary(), false);
+
+	auto plainSize = plain.compress(msg).size();
+	auto dictSize  = withDict.compress(msg).size();
+	CPPUNIT_ASSERT(dictSize * 2 < plainSize);
+
+	// training picks up what repeats across messages
+	auto dict = trainDictionary({"{\"pieceType\":\"light horse\",\"x\":1}", "[\"light horse\",\"y\"]"});
+	CPPUNIT_ASSERT(dict.find("\"light horse\"") != string::npos);
+	CPPUNIT_ASSERT(dict.find("\"x\"") == string::npos);
+}
+
+void MsgCompressionTest::testInvalidData()
+{
+	MsgInflater inflater;
+	CPPUNIT_ASSERT(!inflater.decompress("\xff\xff\xff\xff garbage"));
+
+	// too large
+	MsgDeflater deflater(defaultDictionary(), false);
+	MsgInflater smallInflater(defaultDictionary(), false, 100);
+
+	string compressed(deflater.compress(string(101, 'x')));
+	CPPUNIT_ASSERT(!smallInflater.decompress(compressed));
+
+	compressed = string(deflater.compress(string(100, 'x')));
+	CPPUNIT_ASSERT(smallInflater.decompress(compressed));
+}
@@ -0,0 +1,122 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "msg_validator_test.hpp"
+
+#include <fstream>
+#include <stdexcept>
+#include <json/reader.h>
+#include <cyvws/common.hpp>
+#include <cyvws/game_msg.hpp>
+#include <cyvws/msg.hpp>
+#include <cyvws/msg_validator.hpp>
+#include <cyvws/server_request.hpp>
+
+using namespace std;
+using namespace cyvws;
+
+Json::Value MsgValidatorTest::readExample(const string& name)
+{
+	ifstream file(string(WS_MSG_EXAMPLES_DIR) + "/" + name + ".json");
+	if (!file)
+		throw runtime_error("couldn't open example " + name);
+
+	Json::Value val;
+	string errs;
+	if (!Json::parseFromStream(Json::CharReaderBuilder(), file, &val, &errs))
+		throw runtime_error("couldn't parse example " + name + ": " + errs);
+
+	return val;
+}
+
+void MsgValidatorTest::testExamples()
+{
+	const auto& validator = MsgValidator::inbound();
+
+	for (auto name : {
+		"chatMsg-toServer",
+		"gameMsg/endTurn", "gameMsg/move", "gameMsg/moveCapture", "gameMsg/promote",
+		"gameMsg/resign", "gameMsg/setIsReady", "gameMsg/setOpeningArray",
+		"serverRequest/createGame", "serverRequest/initComm", "serverRequest/joinGame",
+		"serverRequest/setUsername", "serverRequest/subscrGameListUpdates",
+		"serverRequest/unsubscrGameListUpdates"})
+	{
+		auto res = validator.validate(readExample(name));
+		CPPUNIT_ASSERT_MESSAGE(string(name) + ": " + res.toString(), bool(res));
+	}
+
+	// not sent by clients
+	CPPUNIT_ASSERT(!validator.validate(readExample("gameMsgAck")));
+}
+
+void MsgValidatorTest::testErrors()
+{
+	const auto& validator = MsgValidator::inbound();
+
+	auto expectError = [&](const Json::Value& msg, MsgValidationError error, const string& path) {
+		auto res = validator.validate(msg);
+		CPPUNIT_ASSERT_EQUAL(string(MsgValidationErrorToStr(error)), string(MsgValidationErrorToStr(res.error)));
+		CPPUNIT_ASSERT_EQUAL(path, res.path);
+	};
+
+	auto move = readExample("gameMsg/move");
+
+	auto msg = move;
+	msg[MSG_DATA][PARAM].removeMember(OLD_POS);
+	expectError(msg, MsgValidationError::MISSING_MEMBER, "msgData.param.oldPos");
+
+	msg = move;
+	msg[MSG_DATA][PARAM][NEW_POS] = "L1";
+	expectError(msg, MsgValidationError::INVALID_VALUE, "msgData.param.newPos");
+	CPPUNIT_ASSERT_EQUAL(string("msgData.param.newPos: invalid value"), validator.validate(msg).toString());
+
+	msg = move;
+	msg[MSG_DATA][PARAM][PIECE_TYPE] = 3;
+	expectError(msg, MsgValidationError::UNEXPECTED_TYPE, "msgData.param.pieceType");
+
+	msg = move;
+	msg[MSG_DATA][ACTION] = "fly";
+	expectError(msg, MsgValidationError::UNKNOWN_VARIANT, "msgData.action");
+
+	msg = move;
+	msg[MSG_ID] = -1;
+	expectError(msg, MsgValidationError::UNEXPECTED_TYPE, "msgID");
+
+	msg = move;
+	msg[MSG_TYPE] = "gameMessage";
+	expectError(msg, MsgValidationError::UNKNOWN_MSG_TYPE, "msgType");
+
+	expectError(Json::Value("move"), MsgValidationError::UNEXPECTED_TYPE, "");
+
+	msg = readExample("gameMsg/setOpeningArray");
+	msg[MSG_DATA][PARAM]["rabble"][2] = "F12";
+	expectError(msg, MsgValidationError::INVALID_VALUE, "msgData.param.rabble[2]");
+
+	msg[MSG_DATA][PARAM]["rabble"][2] = "F2";
+	msg[MSG_DATA][PARAM]["catapult"] = Json::Value(Json::arrayValue);
+	expectError(msg, MsgValidationError::INVALID_VALUE, "msgData.param.catapult");
+
+	msg = readExample("serverRequest/subscrGameListUpdates");
+	msg[REQUEST_DATA][PARAM]["lists"][1] = "allGames";
+	expectError(msg, MsgValidationError::INVALID_VALUE, "requestData.param.lists[1]");
+
+	// optional members are only checked if present
+	msg = readExample("serverRequest/createGame");
+	msg[REQUEST_DATA][PARAM].removeMember("extraRules");
+	CPPUNIT_ASSERT(validator.validate(msg));
+	msg[REQUEST_DATA][PARAM]["userInfo"].removeMember("sessionToken");
+	expectError(msg, MsgValidationError::MISSING_MEMBER, "requestData.param.userInfo.sessionToken");
+}
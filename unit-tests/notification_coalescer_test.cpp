@@ -0,0 +1,143 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "notification_coalescer_test.hpp"
+
+#include <chrono>
+#include <string>
+#include <cyvws/common.hpp>
+#include <cyvws/json_notification.hpp>
+#include <cyvws/notification.hpp>
+#include <cyvws/notification_coalescer.hpp>
+#include <cyvws/versioned_games_list.hpp>
+
+using namespace std;
+using namespace cyvasse;
+using namespace cyvws;
+
+void NotificationCoalescerTest::testPresence()
+{
+	NotificationBatch batch;
+	batch.add(json::userJoined("Guest 1", false, "player"));
+	batch.add(json::usernameUpdate("Guest 1", "jPlatte"));
+	batch.add(json::userLeft("jPlatte"));
+	CPPUNIT_ASSERT(batch.empty());
+	CPPUNIT_ASSERT(batch.toMsg().isNull());
+
+	batch.add(json::usernameUpdate("Guest 2", "foo"));
+	batch.add(json::usernameUpdate("foo", "bar"));
+	batch.add(json::userJoined("Guest 3", false, "player"));
+	CPPUNIT_ASSERT_EQUAL(size_t(2), batch.size());
+	CPPUNIT_ASSERT_EQUAL(size_t(6), batch.getReceived());
+
+	auto data = batch.toMsg()[NOTIFICATION_DATA];
+	CPPUNIT_ASSERT_EQUAL(string(NotificationType::BATCH), data[TYPE].asString());
+	CPPUNIT_ASSERT_EQUAL(2u, data[NOTIFICATIONS].size());
+	CPPUNIT_ASSERT_EQUAL(string("Guest 2"), data[NOTIFICATIONS][0][OLD_USERNAME].asString());
+	CPPUNIT_ASSERT_EQUAL(string("bar"), data[NOTIFICATIONS][0][NEW_USERNAME].asString());
+
+	// renamed and gone, the subscriber only knows the old name
+	NotificationBatch batch2;
+	batch2.add(json::usernameUpdate("Guest 4", "baz"));
+	batch2.add(json::userLeft("baz"));
+
+	data = batch2.toMsg()[NOTIFICATION_DATA];
+	CPPUNIT_ASSERT_EQUAL(string(NotificationType::USER_LEFT), data[TYPE].asString());
+	CPPUNIT_ASSERT_EQUAL(string("Guest 4"), data[USERNAME].asString());
+}
+
+void NotificationCoalescerTest::testLists()
+{
+	VersionedGamesList server(GamesList::OPEN_RANDOM_GAMES);
+	VersionedGamesList client(GamesList::OPEN_RANDOM_GAMES);
+	server.add("NHVy", {"Test user X", PlayersColor::BLACK});
+	CPPUNIT_ASSERT(client.apply(server.getSnapshot()[NOTIFICATION_DATA]));
+
+	NotificationBatch batch;
+	batch.add(server.add("vnUM", {"jPlatte", PlayersColor::WHITE}));
+	batch.add(server.modify("NHVy", {"Test user Y", PlayersColor::BLACK}));
+	batch.add(server.remove("vnUM"));
+	batch.add(server.add("pQ3x", {"Guest 42", PlayersColor::WHITE}));
+	batch.add(server.remove("NHVy"));
+	CPPUNIT_ASSERT_EQUAL(size_t(1), batch.size());
+
+	auto data = batch.toMsg()[NOTIFICATION_DATA];
+	CPPUNIT_ASSERT_EQUAL(1u, data[BASE_VERSION].asUInt());
+	CPPUNIT_ASSERT_EQUAL(6u, data[LIST_VERSION].asUInt());
+	CPPUNIT_ASSERT_EQUAL(1u, data[ADDED].size());
+	CPPUNIT_ASSERT_EQUAL(0u, data[MODIFIED].size());
+	CPPUNIT_ASSERT_EQUAL(1u, data[REMOVED].size());
+
+	CPPUNIT_ASSERT(client.apply(data));
+	CPPUNIT_ASSERT_EQUAL(size_t(1), client.getGames().size());
+	CPPUNIT_ASSERT(client.getGames().count("pQ3x"));
+
+	// deltas after a snapshot are applied to it, a new snapshot replaces everything
+	NotificationBatch batch2;
+	batch2.add(server.getSnapshot());
+	batch2.add(server.add("NHVy", {"Test user X", PlayersColor::BLACK}));
+	CPPUNIT_ASSERT_EQUAL(size_t(1), batch2.size());
+
+	data = batch2.toMsg()[NOTIFICATION_DATA];
+	CPPUNIT_ASSERT_EQUAL(string(NotificationType::LIST_UPDATE), data[TYPE].asString());
+	CPPUNIT_ASSERT_EQUAL(7u, data[LIST_VERSION].asUInt());
+	CPPUNIT_ASSERT_EQUAL(2u, data[LIST_CONTENT].size());
+
+	batch2.add(server.getSnapshot());
+	CPPUNIT_ASSERT_EQUAL(size_t(1), batch2.size());
+
+	// a delta can't be applied to an unversioned list, and checking must not add a version
+	NotificationBatch batch3;
+	batch3.add(json::listUpdate(GamesList::OPEN_RANDOM_GAMES, {}));
+	batch3.add(server.remove("NHVy"));
+	CPPUNIT_ASSERT_EQUAL(size_t(2), batch3.size());
+
+	data = batch3.toMsg()[NOTIFICATION_DATA];
+	CPPUNIT_ASSERT(!data[NOTIFICATIONS][0].isMember(LIST_VERSION));
+}
+
+void NotificationCoalescerTest::testWindow()
+{
+	typedef chrono::steady_clock::time_point TimePoint;
+	NotificationCoalescer<int> coalescer(chrono::milliseconds(50));
+
+	TimePoint start;
+	coalescer.push(1, json::userJoined("Guest 1", false, "player"), start);
+	coalescer.push(2, json::userJoined("Guest 1", false, "player"), start + chrono::milliseconds(20));
+	coalescer.push(1, json::userLeft("Guest 1"), start + chrono::milliseconds(30));
+	coalescer.push(1, json::userJoined("Guest 2", false, "player"), start + chrono::milliseconds(40));
+	CPPUNIT_ASSERT(*coalescer.getNextDeadline() == start + chrono::milliseconds(50));
+
+	size_t sent = 0;
+	auto send = [&](int subscriber, const Json::Value& msg) {
+		CPPUNIT_ASSERT_EQUAL(1, subscriber);
+		CPPUNIT_ASSERT_EQUAL(string("Guest 2"), msg[NOTIFICATION_DATA][USERNAME].asString());
+		sent++;
+	};
+
+	CPPUNIT_ASSERT_EQUAL(size_t(0), coalescer.flush(send, start + chrono::milliseconds(49)));
+	CPPUNIT_ASSERT_EQUAL(size_t(1), coalescer.flush(send, start + chrono::milliseconds(50)));
+	CPPUNIT_ASSERT_EQUAL(size_t(1), sent);
+	CPPUNIT_ASSERT_EQUAL(size_t(1), coalescer.getPendingCount());
+
+	CPPUNIT_ASSERT_EQUAL(uint64_t(3), coalescer.getStats().received);
+	CPPUNIT_ASSERT_EQUAL(uint64_t(2), coalescer.getStats().merged);
+	CPPUNIT_ASSERT_EQUAL(uint64_t(1), coalescer.getStats().frames);
+
+	coalescer.flushAll([](int, const Json::Value&) { });
+	CPPUNIT_ASSERT_EQUAL(size_t(0), coalescer.getPendingCount());
+	CPPUNIT_ASSERT(!coalescer.getNextDeadline());
+}
@@ -0,0 +1,116 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "transposition_table_test.hpp"
+
+#include <thread>
+#include <vector>
+#include <cyvasse/transposition_table.hpp>
+
+using namespace std;
+using namespace cyvasse;
+
+void TranspositionTableTest::testSize()
+{
+	TranspositionTable tt(1000 * 1000);
+	CPPUNIT_ASSERT(tt.getByteSize() <= 1000 * 1000);
+	CPPUNIT_ASSERT(tt.getByteSize() > 1000 * 1000 / 2);
+	CPPUNIT_ASSERT_EQUAL(tt.getByteSize() / 16, tt.getEntryCount());
+
+	// always at least one bucket
+	TranspositionTable tinyTT(1);
+	CPPUNIT_ASSERT_EQUAL(size_t(4), tinyTT.getEntryCount());
+}
+
+void TranspositionTableTest::testStoreProbe()
+{
+	TranspositionTable tt(64 * 1024);
+
+	CPPUNIT_ASSERT(!tt.probe(0x1234));
+
+	tt.store(0x1234, {-500, 7, TTBound::LOWER, 12, 34});
+
+	auto entry = tt.probe(0x1234);
+	CPPUNIT_ASSERT(entry);
+	CPPUNIT_ASSERT_EQUAL(int16_t(-500), entry->score);
+	CPPUNIT_ASSERT_EQUAL(int8_t(7), entry->depth);
+	CPPUNIT_ASSERT(entry->bound == TTBound::LOWER);
+	CPPUNIT_ASSERT_EQUAL(uint8_t(12), entry->moveFrom);
+	CPPUNIT_ASSERT_EQUAL(uint8_t(34), entry->moveTo);
+
+	// same bucket, different key
+	CPPUNIT_ASSERT(!tt.probe(0x1234 + (uint64_t(1) << 40)));
+
+	auto stats = tt.getStats();
+	CPPUNIT_ASSERT_EQUAL(uint64_t(3), stats.probes);
+	CPPUNIT_ASSERT_EQUAL(uint64_t(1), stats.hits);
+	CPPUNIT_ASSERT_EQUAL(uint64_t(1), stats.stores);
+
+	tt.clear();
+	CPPUNIT_ASSERT(!tt.probe(0x1234));
+}
+
+void TranspositionTableTest::testReplacement()
+{
+	TranspositionTable tt(1); // a single bucket of four entries
+
+	for (uint64_t key = 1; key <= 4; key++)
+		tt.store(key, {0, int8_t(key), TTBound::EXACT, 0, 0});
+
+	CPPUNIT_ASSERT_EQUAL(uint64_t(0), tt.getStats().collisions);
+
+	// replaces the shallowest entry
+	tt.store(5, {0, 3, TTBound::EXACT, 0, 0});
+	CPPUNIT_ASSERT_EQUAL(uint64_t(1), tt.getStats().collisions);
+	CPPUNIT_ASSERT(!tt.probe(1));
+	CPPUNIT_ASSERT(tt.probe(2));
+
+	// entries of older searches are replaced first
+	tt.newSearch();
+	tt.store(2, {0, 2, TTBound::EXACT, 0, 0});
+	tt.store(6, {0, 1, TTBound::EXACT, 0, 0});
+	CPPUNIT_ASSERT(tt.probe(2));
+	CPPUNIT_ASSERT(tt.probe(6));
+	CPPUNIT_ASSERT(!tt.probe(5));
+}
+
+void TranspositionTableTest::testConcurrentAccess()
+{
+	TranspositionTable tt(256 * 1024);
+
+	vector<thread> threads;
+	for (int t = 0; t < 4; t++)
+	{
+		threads.emplace_back([&tt, t] {
+			for (uint64_t i = 0; i < 20000; i++)
+			{
+				uint64_t key = (i * 0x9E3779B97F4A7C15) ^ t;
+				int16_t score = int16_t(key & 0x7FFF);
+
+				tt.store(key, {score, 1, TTBound::EXACT, 0, 0});
+
+				auto entry = tt.probe(key);
+				if (entry)
+					CPPUNIT_ASSERT_EQUAL(score, entry->score);
+			}
+		});
+	}
+
+	for (auto& thread : threads)
+		thread.join();
+
+	CPPUNIT_ASSERT(tt.getStats().hitRate() > 0);
+}
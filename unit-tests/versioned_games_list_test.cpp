@@ -0,0 +1,97 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "versioned_games_list_test.hpp"
+
+#include <stdexcept>
+#include <json/value.h>
+#include <cyvws/common.hpp>
+#include <cyvws/notification.hpp>
+#include <cyvws/versioned_games_list.hpp>
+
+using namespace std;
+using namespace cyvasse;
+using namespace cyvws;
+
+static bool sameGames(const GamesListMap& a, const GamesListMap& b)
+{
+	if (a.size() != b.size())
+		return false;
+
+	for (auto&& game : a)
+	{
+		auto it = b.find(game.first);
+		if (it == b.end() || it->second.title != game.second.title || it->second.playAs != game.second.playAs)
+			return false;
+	}
+
+	return true;
+}
+
+void VersionedGamesListTest::testDeltas()
+{
+	VersionedGamesList server(GamesList::OPEN_RANDOM_GAMES);
+	VersionedGamesList client(GamesList::OPEN_RANDOM_GAMES);
+
+	CPPUNIT_ASSERT(client.apply(server.getSnapshot()[NOTIFICATION_DATA]));
+
+	auto delta = server.add("NHVy", {"Test user X", PlayersColor::BLACK});
+	CPPUNIT_ASSERT_EQUAL(string(NotificationType::LIST_DELTA), delta[NOTIFICATION_DATA][TYPE].asString());
+	CPPUNIT_ASSERT_EQUAL(1u, delta[NOTIFICATION_DATA][ADDED].size());
+	CPPUNIT_ASSERT(client.apply(delta[NOTIFICATION_DATA]));
+
+	CPPUNIT_ASSERT(client.apply(server.add("vnUM", {"jPlatte", PlayersColor::WHITE})[NOTIFICATION_DATA]));
+	CPPUNIT_ASSERT(client.apply(server.modify("NHVy", {"Test user Y", PlayersColor::WHITE})[NOTIFICATION_DATA]));
+	CPPUNIT_ASSERT(client.apply(server.remove("vnUM")[NOTIFICATION_DATA]));
+
+	CPPUNIT_ASSERT_EQUAL(4u, server.getVersion());
+	CPPUNIT_ASSERT_EQUAL(4u, client.getVersion());
+	CPPUNIT_ASSERT(sameGames(server.getGames(), client.getGames()));
+
+	CPPUNIT_ASSERT_THROW(server.add("NHVy", {"", PlayersColor::WHITE}), invalid_argument);
+	CPPUNIT_ASSERT_THROW(server.remove("vnUM"), invalid_argument);
+	CPPUNIT_ASSERT_EQUAL(4u, server.getVersion());
+}
+
+void VersionedGamesListTest::testResync()
+{
+	VersionedGamesList server(GamesList::OPEN_RANDOM_GAMES, 3);
+	VersionedGamesList client(GamesList::OPEN_RANDOM_GAMES);
+
+	server.add("NHVy", {"Test user X", PlayersColor::BLACK});
+	CPPUNIT_ASSERT(client.apply(server.getSnapshot()[NOTIFICATION_DATA]));
+
+	// a lost delta is detected by the version gap
+	server.add("vnUM", {"jPlatte", PlayersColor::WHITE});
+	auto missed = server.modify("NHVy", {"Test user Y", PlayersColor::BLACK});
+	CPPUNIT_ASSERT(!client.apply(server.remove("vnUM")[NOTIFICATION_DATA]));
+	CPPUNIT_ASSERT_EQUAL(1u, client.getVersion());
+
+	// the changes since version 1 are still in the history, vnUM was added and removed again
+	auto update = server.getUpdate(client.getVersion())[NOTIFICATION_DATA];
+	CPPUNIT_ASSERT_EQUAL(string(NotificationType::LIST_DELTA), update[TYPE].asString());
+	CPPUNIT_ASSERT_EQUAL(0u, update[ADDED].size());
+	CPPUNIT_ASSERT_EQUAL(1u, update[MODIFIED].size());
+	CPPUNIT_ASSERT_EQUAL(0u, update[REMOVED].size());
+	CPPUNIT_ASSERT(client.apply(update));
+	CPPUNIT_ASSERT(sameGames(server.getGames(), client.getGames()));
+	CPPUNIT_ASSERT(server.getUpdate(client.getVersion()).isNull());
+
+	// too old for the history, a full snapshot is sent
+	server.add("vnUM", {"jPlatte", PlayersColor::WHITE});
+	CPPUNIT_ASSERT_EQUAL(string(NotificationType::LIST_UPDATE), server.getUpdate(0)[NOTIFICATION_DATA][TYPE].asString());
+	CPPUNIT_ASSERT(!client.apply(missed[NOTIFICATION_DATA]));
+}
@@ -0,0 +1,208 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "write_behind_queue_test.hpp"
+
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include <cyvdb/write_behind_queue.hpp>
+
+using namespace std;
+using namespace cyvdb;
+
+/* Stands in for the database: operations add their value to the pending
+   transaction, which is appended to the committed values if the
+   transaction succeeds and dropped if it is rolled back. The connection
+   passed to the operations is never opened.
+ */
+class FakeDatabase
+{
+	private:
+		mutable mutex m_mutex;
+		vector<int> m_pending;
+		vector<int> m_committed;
+		size_t m_commits = 0;
+		size_t m_rollbacks = 0;
+
+	public:
+		WriteBehindQueue::TransactionRunner getRunner()
+		{
+			return [this](tntdb::Connection&, const function<void()>& func) {
+				try
+				{
+					func();
+				}
+				catch (...)
+				{
+					lock_guard<mutex> lock(m_mutex);
+					m_pending.clear();
+					m_rollbacks++;
+					throw;
+				}
+
+				lock_guard<mutex> lock(m_mutex);
+				m_committed.insert(m_committed.end(), m_pending.begin(), m_pending.end());
+				m_pending.clear();
+				m_commits++;
+			};
+		}
+
+		WriteBehindQueue::Operation insert(int value)
+		{
+			return [this, value](tntdb::Connection&) {
+				lock_guard<mutex> lock(m_mutex);
+				m_pending.push_back(value);
+			};
+		}
+
+		vector<int> getCommitted() const
+		{
+			lock_guard<mutex> lock(m_mutex);
+			return m_committed;
+		}
+
+		size_t getCommits() const
+		{
+			lock_guard<mutex> lock(m_mutex);
+			return m_commits;
+		}
+
+		size_t getRollbacks() const
+		{
+			lock_guard<mutex> lock(m_mutex);
+			return m_rollbacks;
+		}
+};
+
+// long enough that a batch is only started by its size (or a flush)
+static const chrono::milliseconds noDelay(0), longDelay(60 * 1000);
+
+void WriteBehindQueueTest::testBatching()
+{
+	FakeDatabase db;
+
+	{
+		WriteBehindQueue queue(tntdb::Connection(), db.getRunner(), 100, 4, longDelay);
+		for (int i = 0; i < 8; i++)
+			queue.push(db.insert(i));
+
+		queue.flush();
+		CPPUNIT_ASSERT_EQUAL(size_t(2), queue.getTransactionCount());
+		CPPUNIT_ASSERT_EQUAL(size_t(8), queue.getWrittenCount());
+		CPPUNIT_ASSERT_EQUAL(size_t(0), queue.getPendingCount());
+
+		// an incomplete batch is written by the destructor
+		queue.push(db.insert(8));
+	}
+
+	CPPUNIT_ASSERT((db.getCommitted() == vector<int> {0, 1, 2, 3, 4, 5, 6, 7, 8}));
+	CPPUNIT_ASSERT_EQUAL(size_t(3), db.getCommits());
+}
+
+void WriteBehindQueueTest::testFlush()
+{
+	FakeDatabase db;
+	WriteBehindQueue queue(tntdb::Connection(), db.getRunner(), 100, 4, longDelay);
+
+	// nothing to wait for
+	queue.flush();
+
+	// doesn't wait for the batch to fill up or for maxBatchDelay
+	auto begin = chrono::steady_clock::now();
+	queue.push(db.insert(1));
+	queue.push(db.insert(2));
+	queue.flush();
+
+	CPPUNIT_ASSERT(chrono::steady_clock::now() - begin < longDelay / 2);
+	CPPUNIT_ASSERT((db.getCommitted() == vector<int> {1, 2}));
+	CPPUNIT_ASSERT_EQUAL(size_t(1), queue.getTransactionCount());
+
+	// flushes from several threads
+	vector<future<void>> flushes;
+	for (int i = 0; i < 4; i++)
+	{
+		queue.push(db.insert(3 + i));
+		flushes.push_back(async(launch::async, [&] { queue.flush(); }));
+	}
+
+	for (auto&& flush : flushes)
+		flush.get();
+
+	CPPUNIT_ASSERT((db.getCommitted() == vector<int> {1, 2, 3, 4, 5, 6}));
+}
+
+void WriteBehindQueueTest::testBackpressure()
+{
+	FakeDatabase db;
+	WriteBehindQueue queue(tntdb::Connection(), db.getRunner(), 2, 1, noDelay);
+
+	// keep the writer busy until the queue is full
+	promise<void> started, resume;
+	auto resumed = resume.get_future().share();
+
+	queue.push([&](tntdb::Connection&) {
+		started.set_value();
+		resumed.wait();
+	});
+	started.get_future().wait();
+
+	queue.push(db.insert(1));
+	CPPUNIT_ASSERT(queue.tryPush(db.insert(2)));
+	CPPUNIT_ASSERT(!queue.tryPush(db.insert(3)));
+	CPPUNIT_ASSERT_THROW(queue.push(db.insert(3)), WriteQueueFull);
+	CPPUNIT_ASSERT_EQUAL(size_t(3), queue.getPendingCount());
+
+	resume.set_value();
+	queue.flush();
+
+	CPPUNIT_ASSERT((db.getCommitted() == vector<int> {1, 2}));
+	CPPUNIT_ASSERT_EQUAL(size_t(0), queue.getPendingCount());
+	CPPUNIT_ASSERT(queue.tryPush(db.insert(3)));
+}
+
+void WriteBehindQueueTest::testRetry()
+{
+	FakeDatabase db;
+	WriteBehindQueue queue(tntdb::Connection(), db.getRunner(), 100, 3, longDelay);
+
+	vector<string> errors;
+	queue.setErrorHandler([&](const exception& e) { errors.push_back(e.what()); });
+
+	queue.push(db.insert(1));
+	queue.push([](tntdb::Connection&) { throw runtime_error("constraint violated"); });
+	queue.push(db.insert(3));
+	queue.flush();
+
+	// the batch is rolled back, then every operation is retried on its own
+	CPPUNIT_ASSERT((db.getCommitted() == vector<int> {1, 3}));
+	CPPUNIT_ASSERT_EQUAL(size_t(2), db.getRollbacks());
+	CPPUNIT_ASSERT_EQUAL(size_t(2), queue.getTransactionCount());
+	CPPUNIT_ASSERT_EQUAL(size_t(3), queue.getWrittenCount());
+	CPPUNIT_ASSERT_EQUAL(size_t(1), queue.getFailedCount());
+	CPPUNIT_ASSERT_EQUAL(size_t(1), errors.size());
+	CPPUNIT_ASSERT_EQUAL(string("constraint violated"), errors[0]);
+
+	// a batch of one isn't retried
+	queue.push([](tntdb::Connection&) { throw runtime_error("constraint violated"); });
+	queue.flush();
+
+	CPPUNIT_ASSERT_EQUAL(size_t(3), db.getRollbacks());
+	CPPUNIT_ASSERT_EQUAL(size_t(2), queue.getFailedCount());
+	CPPUNIT_ASSERT_EQUAL(size_t(2), errors.size());
+}